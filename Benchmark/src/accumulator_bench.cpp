@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "RatioAccumulator.hpp"
+#include "dataset.hpp"
+
+
+/// streaming sums : range(0) positive ratios with numerators and denominators in [1, 16] (lcm 720720),
+/// or prices in cents
+
+static std::vector<rto::Ratio<long>> smallRatios(std::size_t size) {
+	return bench::positiveRatios<long>(size, 16, 111);
+}
+
+static std::vector<rto::Ratio<long>> prices(std::size_t size) {
+	std::vector<rto::Ratio<long>> result;
+	for(const long cents : bench::integers<long>(size, 100000, 112)) {result.push_back(rto::Ratio<long>(cents, 100));}
+	return result;
+}
+
+/////////////////////////////////////////////////////
+// baseline : a chain of operator+ (normalized after every add)
+
+static void BM_SumOperatorPlus(benchmark::State& state, std::vector<rto::Ratio<long>> (*dataset)(std::size_t)) {
+	const std::vector<rto::Ratio<long>> values = dataset(state.range(0));
+	for (auto _ : state) {
+		rto::Ratio<long> sum;
+		for(const rto::Ratio<long> &value : values) {sum = sum + value;}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/////////////////////////////////////////////////////
+// accumulator : common denominator, reduced once
+
+static void BM_SumAccumulator(benchmark::State& state, std::vector<rto::Ratio<long>> (*dataset)(std::size_t)) {
+	const std::vector<rto::Ratio<long>> values = dataset(state.range(0));
+	for (auto _ : state) {
+		rto::RatioAccumulator<long> accumulator;
+		for(const rto::Ratio<long> &value : values) {accumulator.add(value);}
+		benchmark::DoNotOptimize(accumulator.result());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/// four partial sums merged, as four threads would
+static void BM_SumAccumulatorMerge(benchmark::State& state, std::vector<rto::Ratio<long>> (*dataset)(std::size_t)) {
+	const std::vector<rto::Ratio<long>> values = dataset(state.range(0));
+	for (auto _ : state) {
+		rto::RatioAccumulator<long> partials[4];
+		for(std::size_t i=0; i<values.size(); ++i) {partials[i & 3].add(values[i]);}
+		for(int t=1; t<4; ++t) {partials[0].merge(partials[t]);}
+		benchmark::DoNotOptimize(partials[0].result());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK_CAPTURE(BM_SumOperatorPlus, small, smallRatios)->Arg(1<<16);
+BENCHMARK_CAPTURE(BM_SumAccumulator, small, smallRatios)->Arg(1<<16);
+BENCHMARK_CAPTURE(BM_SumAccumulatorMerge, small, smallRatios)->Arg(1<<16);
+BENCHMARK_CAPTURE(BM_SumOperatorPlus, cents, prices)->Arg(1<<16);
+BENCHMARK_CAPTURE(BM_SumAccumulator, cents, prices)->Arg(1<<16);
+BENCHMARK_CAPTURE(BM_SumAccumulatorMerge, cents, prices)->Arg(1<<16);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "RatioBigInt.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// small values : inline BigInt against int64
+
+template <typename T>
+static void BM_SmallSum(benchmark::State& state) {
+	std::vector<rto::Ratio<T>> ratios;
+	for(const rto::Ratio<std::int64_t> &rat : bench::positiveRatios<std::int64_t>(1024, 1 << 10, 1)) {
+		ratios.push_back(rto::Ratio<T>(rat.numerator(), rat.denominator()));
+	}
+	for (auto _ : state) {
+		for(std::size_t i=0; i+1<ratios.size(); ++i) {
+			benchmark::DoNotOptimize(ratios[i] + ratios[i+1]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * (ratios.size() - 1));
+}
+
+/////////////////////////////////////////////////////
+// exact harmonic sum 1/1 + ... + 1/n (the denominator grows to about n bits)
+
+static void BM_HarmonicSum(benchmark::State& state) {
+	using R = rto::Ratio<rto::BigInt>;
+	const int n = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		R sum;
+		for(int i=1; i<=n; ++i) {
+			sum = sum + R(1, i);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+/////////////////////////////////////////////////////
+// products of n-limb integers (schoolbook below the Karatsuba threshold)
+
+static rto::BigInt randomBigInt(std::size_t limbs, std::mt19937_64 &generator) {
+	rto::BigInt value(1);
+	for(std::size_t i=0; i<limbs; ++i) {
+		value = (value << 64) + rto::BigInt(generator() >> 1);
+	}
+	return value;
+}
+
+static void BM_BigIntMultiply(benchmark::State& state) {
+	std::mt19937_64 generator(2);
+	const rto::BigInt a = randomBigInt(static_cast<std::size_t>(state.range(0)), generator);
+	const rto::BigInt b = randomBigInt(static_cast<std::size_t>(state.range(0)), generator);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+}
+
+static void BM_BigIntGcd(benchmark::State& state) {
+	std::mt19937_64 generator(3);
+	const rto::BigInt a = randomBigInt(static_cast<std::size_t>(state.range(0)), generator);
+	const rto::BigInt b = randomBigInt(static_cast<std::size_t>(state.range(0)), generator);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rto::gcd(a, b));
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_SmallSum, std::int64_t);
+BENCHMARK_TEMPLATE(BM_SmallSum, rto::BigInt);
+BENCHMARK(BM_HarmonicSum)->Arg(100)->Arg(1000);
+BENCHMARK(BM_BigIntMultiply)->Arg(4)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+BENCHMARK(BM_BigIntGcd)->Arg(2)->Arg(8)->Arg(32)->Arg(128);
+
+/////////////////////////////////////////////////////
+// harmonic sum with the limbs taken from a RatioArena (reset after each batch)
+
+static void BM_HarmonicSumArena(benchmark::State& state) {
+	using R = rto::Ratio<rto::BigInt>;
+	const int n = static_cast<int>(state.range(0));
+	rto::RatioArena &arena = rto::RatioArena::threadLocal();
+	for (auto _ : state) {
+		rto::RatioArena::Scope scope(arena);
+		R sum;
+		for(int i=1; i<=n; ++i) {
+			sum = sum + R(1, i);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+	state.counters["mallocs_per_batch"] = benchmark::Counter(static_cast<double>(arena.stats().systemAllocations), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_HarmonicSumArena)->Arg(100)->Arg(1000);
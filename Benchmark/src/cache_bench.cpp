@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "RatioCache.hpp"
+#include "dataset.hpp"
+
+
+/// ingest workload : range(0) prices (two decimals) drawn from range(1) distinct values
+
+static std::vector<double> repeatedReals(std::size_t size, std::size_t distinct, unsigned int offset) {
+	const std::vector<double> values = bench::reals(distinct, 0.0, 1000.0, offset);
+	std::mt19937 generator(bench::seed + offset);
+	std::vector<double> result(size);
+	for(double &real : result) {
+		real = std::round(values[bench::uniform<std::size_t>(generator, 0, distinct - 1)] * 100.0) / 100.0;
+	}
+	return result;
+}
+
+/////////////////////////////////////////////////////
+// double -> Ratio<long long>
+
+/// baseline : a continued fraction per value
+static void BM_FromReal(benchmark::State& state) {
+	const std::vector<double> reals = repeatedReals(state.range(0), state.range(1), 91);
+	for (auto _ : state) {
+		for(const double real : reals) {
+			benchmark::DoNotOptimize(rto::Ratio<long long>::fromReal(real));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+}
+
+/// the same conversions through the cache (the tiers are kept between iterations)
+static void BM_CachedFromReal(benchmark::State& state) {
+	const std::vector<double> reals = repeatedReals(state.range(0), state.range(1), 91);
+	rto::clearCache<long long>();
+	rto::resetCacheStatistics();
+	for (auto _ : state) {
+		for(const double real : reals) {
+			benchmark::DoNotOptimize(rto::cachedFromReal<long long>(real));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+	state.counters["hitRate"] = rto::threadCacheStatistics().hitRate();
+}
+
+/// 100 values fit in the local tier, 2000 in the shared tier, 100000 in neither
+BENCHMARK(BM_FromReal)->Args({1<<16, 100})->Args({1<<16, 2000})->Args({1<<16, 100000});
+BENCHMARK(BM_CachedFromReal)->Args({1<<16, 100})->Args({1<<16, 2000})->Args({1<<16, 100000});
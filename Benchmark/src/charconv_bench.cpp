@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "RatioCharConv.hpp"
+#include "dataset.hpp"
+
+
+/// 4096 ratios with numerators and denominators in [-100000, 100000] / [1, 100000]
+
+constexpr std::size_t textCount = 4096;
+
+/// the ratios written as "n/d"
+static std::vector<std::string> fractionTexts() {
+	std::vector<std::string> texts;
+	for(const rto::Ratio<int> &rat : bench::ratios<int>(textCount, 100000, 41)) {
+		texts.push_back(std::to_string(rat.numerator()) + "/" + std::to_string(rat.denominator()));
+	}
+	return texts;
+}
+
+/// decimals with up to 4 digits after the point
+static std::vector<std::string> decimalTexts() {
+	std::vector<std::string> texts;
+	char buffer[32];
+	for(const int value : bench::integers<int>(textCount, 10000000, 42)) {
+		std::snprintf(buffer, sizeof(buffer), "%d.%04d", value / 10000, std::abs(value % 10000));
+		texts.push_back(buffer);
+	}
+	return texts;
+}
+
+static std::size_t totalBytes(const std::vector<std::string> &texts) {
+	std::size_t bytes = 0;
+	for(const std::string &text : texts) {bytes += text.size();}
+	return bytes;
+}
+
+/////////////////////////////////////////////////////
+// formatting
+
+/// baseline : operator << in a string stream
+static void BM_FormatStream(benchmark::State& state) {
+	const std::vector<rto::Ratio<int>> ratios = bench::ratios<int>(textCount, 100000, 41);
+	std::ostringstream stream;
+	for (auto _ : state) {
+		stream.seekp(0);
+		for(const rto::Ratio<int> &rat : ratios) {
+			stream << rat;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ratios.size());
+}
+
+static void BM_FormatToChars(benchmark::State& state) {
+	const std::vector<rto::Ratio<int>> ratios = bench::ratios<int>(textCount, 100000, 41);
+	std::vector<char> buffer(ratios.size() * rto::maxChars<int>);
+	for (auto _ : state) {
+		char *out = buffer.data();
+		for(const rto::Ratio<int> &rat : ratios) {
+			out = rto::to_chars(out, buffer.data() + buffer.size(), rat, rto::CharsFormat::Parenthesized).ptr;
+		}
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetItemsProcessed(state.iterations() * ratios.size());
+}
+
+/////////////////////////////////////////////////////
+// parsing
+
+/// baseline : sscanf then the constructor
+static void BM_ParseSscanf(benchmark::State& state) {
+	const std::vector<std::string> texts = fractionTexts();
+	for (auto _ : state) {
+		for(const std::string &text : texts) {
+			int numerator = 0, denominator = 1;
+			std::sscanf(text.c_str(), "%d/%d", &numerator, &denominator);
+			benchmark::DoNotOptimize(rto::Ratio<int>(numerator, denominator));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * texts.size());
+	state.SetBytesProcessed(state.iterations() * totalBytes(texts));
+}
+
+static void BM_ParseFromChars(benchmark::State& state) {
+	const std::vector<std::string> texts = fractionTexts();
+	for (auto _ : state) {
+		for(const std::string &text : texts) {
+			rto::Ratio<int> rat;
+			rto::from_chars(text.data(), text.data() + text.size(), rat);
+			benchmark::DoNotOptimize(rat);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * texts.size());
+	state.SetBytesProcessed(state.iterations() * totalBytes(texts));
+}
+
+static void BM_ParseDecimal(benchmark::State& state) {
+	const std::vector<std::string> texts = decimalTexts();
+	for (auto _ : state) {
+		for(const std::string &text : texts) {
+			rto::Ratio<int> rat;
+			rto::from_chars(text.data(), text.data() + text.size(), rat);
+			benchmark::DoNotOptimize(rat);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * texts.size());
+	state.SetBytesProcessed(state.iterations() * totalBytes(texts));
+}
+
+/// second column of a 3 columns CSV : "id,n/d,decimal"
+static void BM_ParseColumn(benchmark::State& state) {
+	const std::vector<std::string> fractions = fractionTexts(), decimals = decimalTexts();
+	std::string csv;
+	for(std::size_t i=0; i<textCount; ++i) {
+		csv += std::to_string(i) + "," + fractions[i] + "," + decimals[i] + "\n";
+	}
+	rto::RatioArray<int> values;
+	for (auto _ : state) {
+		values.resize(0);
+		rto::from_chars_column(csv.data(), csv.data() + csv.size(), 1, values);
+		benchmark::DoNotOptimize(values.numerators());
+	}
+	state.SetItemsProcessed(state.iterations() * textCount);
+	state.SetBytesProcessed(state.iterations() * csv.size());
+}
+
+BENCHMARK(BM_FormatStream);
+BENCHMARK(BM_FormatToChars);
+BENCHMARK(BM_ParseSscanf);
+BENCHMARK(BM_ParseFromChars);
+BENCHMARK(BM_ParseDecimal);
+BENCHMARK(BM_ParseColumn);
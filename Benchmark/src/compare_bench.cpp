@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+template <typename T>
+static std::vector<rto::Ratio<T>> randomRatios(std::size_t size, unsigned int offset) {
+	std::mt19937 generator(bench::seed + offset);
+	std::vector<rto::Ratio<T>> ratios;
+	ratios.reserve(size);
+	for(std::size_t i=0; i<size; ++i) {
+		const T numerator = bench::uniform<T>(generator, 1, 1 << 20) - (1 << 19);
+		ratios.push_back(rto::Ratio<T>(numerator, bench::uniform<T>(generator, 1, 1 << 20)));
+	}
+	return ratios;
+}
+
+/// previous operator< : integer division of the numerator by the denominator (wrong order for equal integer parts)
+struct LegacyLess {
+	template <typename T>
+	bool operator()(const rto::Ratio<T> &left, const rto::Ratio<T> &right) const {
+		return (left.numerator() / left.denominator()) < (right.numerator() / right.denominator());
+	}
+};
+
+/////////////////////////////////////////////////////
+// std::sort of n ratios
+
+template <typename T, typename Less>
+static void BM_Sort(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> ratios = randomRatios<T>(static_cast<std::size_t>(state.range(0)), 1);
+	std::vector<rto::Ratio<T>> sorted;
+	for (auto _ : state) {
+		state.PauseTiming();
+		sorted = ratios;
+		state.ResumeTiming();
+		std::sort(sorted.begin(), sorted.end(), Less());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ratios.size());
+}
+
+/////////////////////////////////////////////////////
+// binary search in a sorted dataset
+
+template <typename T>
+static void BM_LowerBound(benchmark::State& state) {
+	std::vector<rto::Ratio<T>> ratios = randomRatios<T>(1 << 20, 2);
+	std::sort(ratios.begin(), ratios.end(), rto::RatioLess());
+	const std::vector<rto::Ratio<T>> keys = randomRatios<T>(1 << 12, 3);
+	for (auto _ : state) {
+		for(const rto::Ratio<T> &key : keys) {
+			benchmark::DoNotOptimize(std::lower_bound(ratios.begin(), ratios.end(), key, rto::RatioLess()));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK_TEMPLATE(BM_Sort, std::int32_t, LegacyLess)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sort, std::int32_t, rto::RatioLess)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sort, std::int64_t, LegacyLess)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sort, std::int64_t, rto::RatioLess)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LowerBound, std::int32_t);
+BENCHMARK_TEMPLATE(BM_LowerBound, std::int64_t);
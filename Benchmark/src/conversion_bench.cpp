@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+static std::vector<double> randomReals(std::size_t size, unsigned int offset) {
+	return bench::reals(size, -1000.0, 1000.0, offset);
+}
+
+/////////////////////////////////////////////////////
+// Ratio(double) : closest ratio that fits in T
+
+template <typename T>
+static void BM_ConvertReal(benchmark::State& state) {
+	const std::vector<double> reals = randomReals(1 << 12, 1);
+	for (auto _ : state) {
+		for(double real : reals) {
+			benchmark::DoNotOptimize(rto::Ratio<T>(real));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+}
+
+/// decimal prices (two digits) : the expansion stops early
+template <typename T>
+static void BM_ConvertDecimal(benchmark::State& state) {
+	std::vector<double> reals = randomReals(1 << 12, 2);
+	for(double &real : reals) {
+		real = std::round(real * 100.0) / 100.0;
+	}
+	for (auto _ : state) {
+		for(double real : reals) {
+			benchmark::DoNotOptimize(rto::Ratio<T>(real));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+}
+
+/// bounded denominator
+static void BM_ConvertMaxDenominator(benchmark::State& state) {
+	const std::vector<double> reals = randomReals(1 << 12, 3);
+	const int maxDenominator = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		for(double real : reals) {
+			benchmark::DoNotOptimize(rto::Ratio<int>::fromReal(real, maxDenominator));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+}
+
+BENCHMARK_TEMPLATE(BM_ConvertReal, std::int32_t);
+BENCHMARK_TEMPLATE(BM_ConvertReal, std::int64_t);
+BENCHMARK_TEMPLATE(BM_ConvertDecimal, std::int32_t);
+BENCHMARK_TEMPLATE(BM_ConvertDecimal, std::int64_t);
+BENCHMARK(BM_ConvertMaxDenominator)->Arg(100)->Arg(1 << 16);
+
+/////////////////////////////////////////////////////
+// fromExact : IEEE-754 bits, dyadic reals
+
+static void BM_ConvertExact(benchmark::State& state) {
+	std::vector<double> reals = randomReals(1 << 12, 4);
+	for(double &real : reals) {
+		real = std::round(real * 1024.0) / 1024.0;
+	}
+	for (auto _ : state) {
+		for(double real : reals) {
+			benchmark::DoNotOptimize(rto::Ratio<std::int64_t>::fromExact(real));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+}
+
+static void BM_ConvertExactBatch(benchmark::State& state) {
+	std::vector<double> reals = randomReals(1 << 12, 4);
+	for(double &real : reals) {
+		real = std::round(real * 1024.0) / 1024.0;
+	}
+	std::vector<rto::Ratio<std::int64_t>> result(reals.size());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rto::Ratio<std::int64_t>::fromExact(reals.data(), reals.size(), result.data()));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * reals.size());
+}
+
+BENCHMARK(BM_ConvertExact);
+BENCHMARK(BM_ConvertExactBatch);
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset : irreducible ratios sharing small factors
+
+static std::vector<rto::Ratio<int>> randomRatios(std::size_t size, int max, unsigned int offset) {
+	std::mt19937 generator(bench::seed + offset);
+	std::vector<rto::Ratio<int>> ratios;
+	ratios.reserve(size);
+	for(std::size_t i=0; i<size; ++i) {
+		const int numerator = bench::uniform<int>(generator, 1, max) * 12;
+		ratios.push_back(rto::Ratio<int>(numerator, bench::uniform<int>(generator, 1, max) * 30));
+	}
+	return ratios;
+}
+
+/////////////////////////////////////////////////////
+// previous kernels : full products, then gcd
+
+static rto::Ratio<int> naiveMultiply(const rto::Ratio<int> &a, const rto::Ratio<int> &b) {
+	return rto::Ratio<int>(a.numerator() * b.numerator(), a.denominator() * b.denominator());
+}
+
+static rto::Ratio<int> naiveAdd(const rto::Ratio<int> &a, const rto::Ratio<int> &b) {
+	return rto::Ratio<int>(a.numerator() * b.denominator() + a.denominator() * b.numerator(), a.denominator() * b.denominator());
+}
+
+/////////////////////////////////////////////////////
+// throughput
+
+static void BM_NaiveMultiply(benchmark::State& state) {
+	const auto a = randomRatios(1 << 12, 100, 1);
+	const auto b = randomRatios(1 << 12, 100, 2);
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {benchmark::DoNotOptimize(naiveMultiply(a[i], b[i]));}
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+static void BM_CrossCancelMultiply(benchmark::State& state) {
+	const auto a = randomRatios(1 << 12, 100, 1);
+	const auto b = randomRatios(1 << 12, 100, 2);
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {benchmark::DoNotOptimize(a[i] * b[i]);}
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+static void BM_NaiveAdd(benchmark::State& state) {
+	const auto a = randomRatios(1 << 12, 100, 1);
+	const auto b = randomRatios(1 << 12, 100, 2);
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {benchmark::DoNotOptimize(naiveAdd(a[i], b[i]));}
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+static void BM_CrossCancelAdd(benchmark::State& state) {
+	const auto a = randomRatios(1 << 12, 100, 1);
+	const auto b = randomRatios(1 << 12, 100, 2);
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {benchmark::DoNotOptimize(a[i] + b[i]);}
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_NaiveMultiply);
+BENCHMARK(BM_CrossCancelMultiply);
+BENCHMARK(BM_NaiveAdd);
+BENCHMARK(BM_CrossCancelAdd);
+
+/////////////////////////////////////////////////////
+// overflow rate of the int intermediates, irreducible operands up to max
+// uniform : numerators and denominators uniform in [1,max]
+// smooth : denominators are products of 2, 3 and 5 (scales, units, money)
+
+static std::vector<rto::Ratio<int>> workloadRatios(std::size_t size, int max, bool smooth, unsigned int offset) {
+	std::mt19937 generator(bench::seed + offset);
+	const int primes[3] = {2, 3, 5};
+	std::vector<rto::Ratio<int>> ratios;
+	ratios.reserve(size);
+	for(std::size_t i=0; i<size; ++i) {
+		int den = bench::uniform<int>(generator, 1, max);
+		if(smooth) {
+			den = 1;
+			for(int p = primes[bench::uniform<int>(generator, 0, 2)]; den <= max / p; p = primes[bench::uniform<int>(generator, 0, 2)]) {den *= p;}
+		}
+		ratios.push_back(rto::Ratio<int>(bench::uniform<int>(generator, 1, max), den));
+	}
+	return ratios;
+}
+
+static bool mulOverflows(long long x, long long y) {
+	const long long product = x * y;
+	return product > std::numeric_limits<int>::max() || product < std::numeric_limits<int>::min();
+}
+
+static void BM_OverflowRate(benchmark::State& state) {
+	const bool smooth = state.range(1) != 0;
+	const auto a = workloadRatios(1 << 14, static_cast<int>(state.range(0)), smooth, 3);
+	const auto b = workloadRatios(1 << 14, static_cast<int>(state.range(0)), smooth, 4);
+	std::size_t naive = 0, crossCancel = 0;
+	for (auto _ : state) {
+		naive = crossCancel = 0;
+		for(std::size_t i=0; i<a.size(); ++i) {
+			const long long an = a[i].numerator(), ad = a[i].denominator();
+			const long long bn = b[i].numerator(), bd = b[i].denominator();
+			// product : n1*n2 and d1*d2, versus (n1/g1)*(n2/g2) and (d1/g2)*(d2/g1)
+			naive += mulOverflows(an, bn) || mulOverflows(ad, bd);
+			const long long g1 = std::gcd(an, bd), g2 = std::gcd(bn, ad);
+			crossCancel += mulOverflows(an / g1, bn / g2) || mulOverflows(ad / g2, bd / g1);
+			// sum : n1*d2 + n2*d1 and d1*d2, versus n1*(d2/g) + n2*(d1/g) and (d1/g)*d2
+			const long long g = std::gcd(ad, bd);
+			naive += mulOverflows(an, bd) || mulOverflows(bn, ad) || mulOverflows(ad, bd)
+			         || mulOverflows(1, an * bd + bn * ad);
+			crossCancel += mulOverflows(an, bd / g) || mulOverflows(bn, ad / g) || mulOverflows(ad / g, bd)
+			               || mulOverflows(1, an * (bd / g) + bn * (ad / g));
+		}
+		benchmark::DoNotOptimize(naive);
+	}
+	state.counters["naive_overflow_%"] = 100.0 * naive / (2.0 * a.size());
+	state.counters["crosscancel_overflow_%"] = 100.0 * crossCancel / (2.0 * a.size());
+}
+
+BENCHMARK(BM_OverflowRate)->ArgsProduct({{1 << 16, 1 << 18}, {0, 1}})->Iterations(1);
@@ -0,0 +1,88 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \file dataset.hpp
+/// \brief reproducible datasets for the benchmarks: std::mt19937 is fully specified by the standard,
+/// and its output is mapped to ranges without std::uniform_*_distribution (whose results differ
+/// between standard libraries), so every platform benchmarks the same values.
+
+namespace bench {
+
+	/// \brief seed of every dataset, change it to benchmark another sample
+	constexpr unsigned int seed = 5489u;
+
+	/// \brief 64 random bits (two draws, in a fixed order)
+	inline std::uint64_t bits(std::mt19937 &generator) {
+		const std::uint64_t high = generator();
+		const std::uint64_t low = generator();
+		return (high << 32) | low;
+	}
+
+	/// \brief reproducible integer in [min, max]
+	template <typename T>
+	T uniform(std::mt19937 &generator, T min, T max) {
+		const std::uint64_t range = static_cast<std::uint64_t>(max - min) + 1;
+		const std::uint64_t value = bits(generator);
+		return static_cast<T>(min + static_cast<T>(value % range));
+	}
+
+	/// \brief reproducible double in [min, max)
+	inline double uniformReal(std::mt19937 &generator, double min, double max) {
+		const std::uint64_t value = bits(generator) >> 11;
+		return min + (max - min) * static_cast<double>(value) * 0x1p-53;
+	}
+
+	/// \brief ratios with a numerator in [-max, max] and a denominator in [1, max]
+	template <typename T>
+	std::vector<rto::Ratio<T>> ratios(std::size_t size, T max, unsigned int offset = 0) {
+		std::mt19937 generator(seed + offset);
+		std::vector<rto::Ratio<T>> result;
+		result.reserve(size);
+		for(std::size_t i=0; i<size; ++i) {
+			const T numerator = uniform<T>(generator, -max, max);
+			result.push_back(rto::Ratio<T>(numerator, uniform<T>(generator, 1, max)));
+		}
+		return result;
+	}
+
+	/// \brief positive ratios in [1/max, max] (for sqrt, log...)
+	template <typename T>
+	std::vector<rto::Ratio<T>> positiveRatios(std::size_t size, T max, unsigned int offset = 0) {
+		std::mt19937 generator(seed + offset);
+		std::vector<rto::Ratio<T>> result;
+		result.reserve(size);
+		for(std::size_t i=0; i<size; ++i) {
+			const T numerator = uniform<T>(generator, 1, max);
+			result.push_back(rto::Ratio<T>(numerator, uniform<T>(generator, 1, max)));
+		}
+		return result;
+	}
+
+	/// \brief integers in [-max, max]
+	template <typename T>
+	std::vector<T> integers(std::size_t size, T max, unsigned int offset = 0) {
+		std::mt19937 generator(seed + offset);
+		std::vector<T> result(size);
+		for(T &value : result) {
+			value = uniform<T>(generator, -max, max);
+		}
+		return result;
+	}
+
+	/// \brief reals in [min, max)
+	inline std::vector<double> reals(std::size_t size, double min, double max, unsigned int offset = 0) {
+		std::mt19937 generator(seed + offset);
+		std::vector<double> result(size);
+		for(double &value : result) {
+			value = uniformReal(generator, min, max);
+		}
+		return result;
+	}
+}
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+template <typename R>
+static std::vector<R> randomRatios(std::size_t size, unsigned int offset) {
+	using T = typename R::value_type;
+	std::vector<R> ratios;
+	ratios.reserve(size);
+	for(const rto::Ratio<T> &rat : bench::positiveRatios<T>(size, 30, offset)) {
+		ratios.push_back(R(rat.numerator(), rat.denominator()));
+	}
+	return ratios;
+}
+
+/////////////////////////////////////////////////////
+// a*b + c*d - e, one gcd per operator (Eager) or a single one (Fused)
+
+template <typename R>
+static void BM_Expression(benchmark::State& state) {
+	const std::vector<R> values = randomRatios<R>(1 << 12, 1);
+	for (auto _ : state) {
+		for(std::size_t i=0; i+5<=values.size(); i+=5) {
+			R res = values[i]*values[i+1] + values[i+2]*values[i+3] - values[i+4];
+			benchmark::DoNotOptimize(res);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * (values.size() / 5));
+}
+
+BENCHMARK_TEMPLATE(BM_Expression, rto::Ratio<long, rto::Eager>);
+BENCHMARK_TEMPLATE(BM_Expression, rto::Ratio<long, rto::Deferred>);
+BENCHMARK_TEMPLATE(BM_Expression, rto::Ratio<long, rto::Fused>);
+
+/////////////////////////////////////////////////////
+// accumulation loop
+
+template <typename R>
+static void BM_Accumulate(benchmark::State& state) {
+	const std::vector<R> values = randomRatios<R>(1 << 12, 2);
+	for (auto _ : state) {
+		R sum;
+		for(const R &value : values) {sum = sum + value * value;}
+		sum.irreducible();
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK_TEMPLATE(BM_Accumulate, rto::Ratio<long, rto::Eager>);
+BENCHMARK_TEMPLATE(BM_Accumulate, rto::Ratio<long, rto::Deferred>);
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "RatioFixed.hpp"
+#include "dataset.hpp"
+
+
+/// prices in cents and readings in 1/1024, numerators in [-100000, 100000]
+
+template <typename F>
+static std::vector<F> fixedValues(std::size_t size, unsigned int offset) {
+	std::vector<F> values;
+	values.reserve(size);
+	for(const int numerator : bench::integers<int>(size, 100000, offset)) {
+		values.push_back(F::fromNumerator(numerator));
+	}
+	return values;
+}
+
+/// the same values as Ratio<int>
+template <typename F>
+static std::vector<rto::Ratio<int>> ratioValues(std::size_t size, unsigned int offset) {
+	std::vector<rto::Ratio<int>> values;
+	values.reserve(size);
+	for(const F &value : fixedValues<F>(size, offset)) {
+		values.push_back(value.toRatio());
+	}
+	return values;
+}
+
+using Cents = rto::FixedRatio<int, 100>;
+using Q10 = rto::FixedRatio<int, 1024>;
+
+/////////////////////////////////////////////////////
+// baseline : Ratio<int>, a gcd per operation
+
+template <typename F>
+static void BM_RatioAdd(benchmark::State& state) {
+	const auto a = ratioValues<F>(state.range(0), 71);
+	const auto b = ratioValues<F>(state.range(0), 72);
+	std::vector<rto::Ratio<int>> result(a.size());
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] + b[i];}
+		benchmark::DoNotOptimize(result.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename F>
+static void BM_RatioMul(benchmark::State& state) {
+	const auto a = ratioValues<F>(state.range(0), 71);
+	const auto b = ratioValues<F>(state.range(0), 72);
+	std::vector<rto::Ratio<int>> result(a.size());
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] * b[i];}
+		benchmark::DoNotOptimize(result.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/////////////////////////////////////////////////////
+// FixedRatio batch kernels
+
+template <typename F>
+static void BM_FixedAdd(benchmark::State& state) {
+	const auto a = fixedValues<F>(state.range(0), 71);
+	const auto b = fixedValues<F>(state.range(0), 72);
+	std::vector<F> result(a.size());
+	for (auto _ : state) {
+		rto::add(a, b, result);
+		benchmark::DoNotOptimize(result.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename F>
+static void BM_FixedMul(benchmark::State& state) {
+	const auto a = fixedValues<F>(state.range(0), 71);
+	const auto b = fixedValues<F>(state.range(0), 72);
+	std::vector<F> result(a.size());
+	for (auto _ : state) {
+		rto::mul(a, b, result);
+		benchmark::DoNotOptimize(result.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename F>
+static void BM_FixedSum(benchmark::State& state) {
+	const auto a = fixedValues<F>(state.range(0), 71);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rto::sum(a));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_RatioAdd, Cents)->Arg(1<<12);
+BENCHMARK_TEMPLATE(BM_FixedAdd, Cents)->Arg(1<<12);
+BENCHMARK_TEMPLATE(BM_RatioMul, Cents)->Arg(1<<12);
+BENCHMARK_TEMPLATE(BM_FixedMul, Cents)->Arg(1<<12);
+BENCHMARK_TEMPLATE(BM_RatioMul, Q10)->Arg(1<<12);
+BENCHMARK_TEMPLATE(BM_FixedMul, Q10)->Arg(1<<12);
+BENCHMARK_TEMPLATE(BM_FixedSum, Cents)->Arg(1<<12);
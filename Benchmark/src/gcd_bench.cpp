@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// operand distributions
+// 0 : uniform over the whole type
+// 1 : small operands (< 2^16)
+// 2 : large operands sharing a common factor
+// 3 : consecutive Fibonacci-like numbers (many Euclid steps)
+
+template <typename T>
+static std::vector<T> operands(std::size_t size, int distribution, unsigned int seed) {
+	using U = typename rto::kernel::unsignedOf<T>::type;
+	std::mt19937_64 generator(seed);
+	std::vector<T> values;
+	values.reserve(2 * size);
+	for(std::size_t i=0; i<size; ++i) {
+		U a = U(generator()), b = U(generator());
+		if constexpr (sizeof(U) > 8) {
+			a = a << 64 | U(generator());
+			b = b << 64 | U(generator());
+		}
+		a >>= 2;
+		b >>= 2;
+		if(distribution == 1) {
+			a = a % 65536 + 1;
+			b = b % 65536 + 1;
+		} else if(distribution == 2) {
+			const U g = U(generator() % 1000 + 1);
+			a = a / 1000 * g;
+			b = b / 1000 * g;
+		} else if(distribution == 3) {
+			// a ~ b * golden ratio
+			b = a / 2 + 1;
+			a = b + b * 5 / 8 + U(generator() % 1024);
+		}
+		values.push_back(T(a));
+		values.push_back(T(b));
+	}
+	return values;
+}
+
+template <typename Backend, typename T>
+static void BM_Gcd(benchmark::State& state) {
+	const std::vector<T> values = operands<T>(1 << 12, static_cast<int>(state.range(0)), 1);
+	for (auto _ : state) {
+		for(std::size_t i=0; i<values.size(); i+=2) {
+			benchmark::DoNotOptimize(Backend::compute(values[i], values[i+1]));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size() / 2);
+}
+
+#define RTO_GCD_BENCHMARKS(T) \
+	BENCHMARK_TEMPLATE(BM_Gcd, rto::EuclidGcd, T)->DenseRange(0, 3); \
+	BENCHMARK_TEMPLATE(BM_Gcd, rto::BinaryGcd, T)->DenseRange(0, 3); \
+	BENCHMARK_TEMPLATE(BM_Gcd, rto::LehmerGcd, T)->DenseRange(0, 3);
+
+RTO_GCD_BENCHMARKS(std::int32_t)
+RTO_GCD_BENCHMARKS(std::int64_t)
+#if defined(__SIZEOF_INT128__)
+RTO_GCD_BENCHMARKS(rto::overflow::int128)
+#endif
+
+/////////////////////////////////////////////////////
+// batched gcd (8 lanes with AVX2 for 32-bit types)
+
+template <typename T>
+static void BM_GcdBatch(benchmark::State& state) {
+	const std::vector<T> values = operands<T>(1 << 12, static_cast<int>(state.range(0)), 1);
+	std::vector<T> a, b;
+	for(std::size_t i=0; i<values.size(); i+=2) {
+		a.push_back(values[i]);
+		b.push_back(values[i+1]);
+	}
+	std::vector<T> result(a.size());
+	for (auto _ : state) {
+		rto::gcd(a.data(), b.data(), result.data(), a.size());
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK_TEMPLATE(BM_GcdBatch, std::int32_t)->DenseRange(0, 3);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "RatioIntern.hpp"
+#include "dataset.hpp"
+
+
+/// group-by workload : range(0) ratios drawn from about 600 distinct values (numerators and denominators in [1, 32])
+
+static std::vector<rto::Ratio<long>> repeatedRatios(std::size_t size, unsigned int offset) {
+	return bench::positiveRatios<long>(size, 32, offset);
+}
+
+/////////////////////////////////////////////////////
+// group by value : count of each distinct ratio
+
+/// baseline : std::unordered_map keyed by the ratios (std::hash)
+static void BM_GroupByUnorderedMap(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> values = repeatedRatios(state.range(0), 81);
+	for (auto _ : state) {
+		std::unordered_map<rto::Ratio<long>, std::size_t> counts;
+		for(const rto::Ratio<long> &rat : values) {++counts[rat];}
+		benchmark::DoNotOptimize(counts.size());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/// interning then counting by id
+static void BM_GroupByIntern(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> values = repeatedRatios(state.range(0), 81);
+	for (auto _ : state) {
+		rto::RatioInternTable<long> table;
+		const std::vector<std::uint32_t> ids = table.intern(values);
+		std::vector<std::size_t> counts(table.size(), 0);
+		for(const std::uint32_t id : ids) {++counts[id];}
+		benchmark::DoNotOptimize(counts.data());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/// counting on data already interned
+static void BM_GroupByIds(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> values = repeatedRatios(state.range(0), 81);
+	rto::RatioInternTable<long> table;
+	const std::vector<std::uint32_t> ids = table.intern(values);
+	for (auto _ : state) {
+		std::vector<std::size_t> counts(table.size(), 0);
+		for(const std::uint32_t id : ids) {++counts[id];}
+		benchmark::DoNotOptimize(counts.data());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+	state.counters["bytesPerValue"] = static_cast<double>(ids.size() * sizeof(std::uint32_t) + table.memoryBytes()) / static_cast<double>(ids.size());
+	state.counters["bytesPerRatio"] = static_cast<double>(sizeof(rto::Ratio<long>));
+}
+
+/////////////////////////////////////////////////////
+// equality of two columns
+
+static void BM_EqualRatios(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> a = repeatedRatios(state.range(0), 81), b = repeatedRatios(state.range(0), 82);
+	for (auto _ : state) {
+		std::size_t equal = 0;
+		for(std::size_t i=0; i<a.size(); ++i) {equal += a[i] == b[i];}
+		benchmark::DoNotOptimize(equal);
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+static void BM_EqualIds(benchmark::State& state) {
+	rto::RatioInternTable<long> table;
+	const std::vector<std::uint32_t> a = table.intern(repeatedRatios(state.range(0), 81));
+	const std::vector<std::uint32_t> b = table.intern(repeatedRatios(state.range(0), 82));
+	for (auto _ : state) {
+		std::size_t equal = 0;
+		for(std::size_t i=0; i<a.size(); ++i) {equal += a[i] == b[i];}
+		benchmark::DoNotOptimize(equal);
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_GroupByUnorderedMap)->Arg(1<<16);
+BENCHMARK(BM_GroupByIntern)->Arg(1<<16);
+BENCHMARK(BM_GroupByIds)->Arg(1<<16);
+BENCHMARK(BM_EqualRatios)->Arg(1<<16);
+BENCHMARK(BM_EqualIds)->Arg(1<<16);
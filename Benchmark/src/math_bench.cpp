@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "RatioMath.hpp"
+#include "dataset.hpp"
+
+
+/// 1024 ratios with numerators and denominators in [-1000, 1000] / [1, 1000]
+
+constexpr std::size_t mathCount = 1024;
+
+static std::vector<rto::Ratio<long long>> mathArguments() {
+	return bench::ratios<long long>(mathCount, 1000, 51);
+}
+
+/////////////////////////////////////////////////////
+// sine
+
+/// baseline : the one argument version, through double and its continued fraction
+static void BM_SinDouble(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = mathArguments();
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(sin(x));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/// fixed-point evaluation, tolerance 10^-range(0)
+static void BM_SinTolerance(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = mathArguments();
+	double tolerance = 1;
+	for(int i=0; i<state.range(0); ++i) {tolerance /= 10;}
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(rto::sin(x, tolerance));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/// fixed-point evaluation, denominators up to range(0)
+static void BM_SinMaxDenominator(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = mathArguments();
+	const long long maxDenominator = state.range(0);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(rto::sin(x, 0.0, maxDenominator));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/////////////////////////////////////////////////////
+// exp and log
+
+static void BM_ExpDouble(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = bench::ratios<long long>(mathCount, 20, 52);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(exp(x));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_ExpTolerance(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = bench::ratios<long long>(mathCount, 20, 52);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(rto::exp(x, 1e-9));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_LogDouble(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = bench::positiveRatios<long long>(mathCount, 1000, 53);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(log(x));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_LogTolerance(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = bench::positiveRatios<long long>(mathCount, 1000, 53);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &x : values) {
+			benchmark::DoNotOptimize(rto::log(x, 1e-9));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_SinDouble);
+BENCHMARK(BM_SinTolerance)->Arg(3)->Arg(9)->Arg(15);
+BENCHMARK(BM_SinMaxDenominator)->Arg(100)->Arg(1000000);
+BENCHMARK(BM_ExpDouble);
+BENCHMARK(BM_ExpTolerance);
+BENCHMARK(BM_LogDouble);
+BENCHMARK(BM_LogTolerance);
@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+
+#include "RatioMatrix.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+using R = rto::Ratio<long>;
+
+/// dense matrix, numerators in [-9, 9], denominators in [1, 6]
+static rto::Matrix<R> denseMatrix(std::size_t size, unsigned int offset) {
+	std::mt19937 generator(bench::seed + offset);
+	rto::Matrix<R> mat(size, size);
+	for(std::size_t i=0; i<size; ++i) {
+		for(std::size_t j=0; j<size; ++j) {
+			const long numerator = bench::uniform<long>(generator, -9, 9);
+			mat(i, j) = R(numerator, bench::uniform<long>(generator, 1, 6));
+		}
+	}
+	return mat;
+}
+
+/// system whose minors fit in long at any size : L*U with unit bidiagonal factors of +-1
+/// (a tridiagonal matrix of determinant 1), rows divided by integers in [1, 3].
+/// Bareiss does not look for zeros, so the elimination costs as much as on a dense matrix.
+static rto::Matrix<R> unimodularMatrix(std::size_t size, unsigned int offset) {
+	std::mt19937 generator(bench::seed + offset);
+	rto::Matrix<R> mat(size, size);
+	long previousU = 0;
+	for(std::size_t i=0; i<size; ++i) {
+		const long l = bench::uniform<long>(generator, 0, 1) ? 1 : -1;
+		const long u = bench::uniform<long>(generator, 0, 1) ? 1 : -1;
+		const long scale = bench::uniform<long>(generator, 1, 3);
+		mat(i, i) = R(1 + l * previousU, scale);
+		if(i > 0) {mat(i, i-1) = R(l, scale);}
+		if(i+1 < size) {mat(i, i+1) = R(u, scale);}
+		previousU = u;
+	}
+	return mat;
+}
+
+/////////////////////////////////////////////////////
+// product of two n x n matrices
+
+/// loops over the ratio operators (gcds on every term)
+static void BM_MatrixMultiplyNaive(benchmark::State& state) {
+	const std::size_t size = static_cast<std::size_t>(state.range(0));
+	const rto::Matrix<R> a = denseMatrix(size, 1), b = denseMatrix(size, 2);
+	for (auto _ : state) {
+		rto::Matrix<R> c(size, size);
+		for(std::size_t i=0; i<size; ++i) {
+			for(std::size_t j=0; j<size; ++j) {
+				R sum;
+				for(std::size_t k=0; k<size; ++k) {
+					sum = sum + a(i, k) * b(k, j);
+				}
+				c(i, j) = sum;
+			}
+		}
+		benchmark::DoNotOptimize(c.data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size * size);
+}
+
+/// blocked integer dot products, range(1) threads (0 for all the cores)
+static void BM_MatrixMultiply(benchmark::State& state) {
+	const std::size_t size = static_cast<std::size_t>(state.range(0));
+	const rto::Matrix<R> a = denseMatrix(size, 1), b = denseMatrix(size, 2);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.multiply(b, static_cast<unsigned int>(state.range(1))).data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size * size);
+}
+
+/////////////////////////////////////////////////////
+// n x n systems
+
+/// Bareiss solve of A x = b, range(1) threads (0 for all the cores)
+static void BM_MatrixSolve(benchmark::State& state) {
+	const std::size_t size = static_cast<std::size_t>(state.range(0));
+	const rto::Matrix<R> a = unimodularMatrix(size, 3);
+	rto::Matrix<R> b(size, 1);
+	for(std::size_t i=0; i<size; ++i) {
+		b(i, 0) = R(static_cast<long>(i % 7) - 3, 2);
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.solve(b, static_cast<unsigned int>(state.range(1))).data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size * size / 3);
+}
+
+/// Bareiss determinant
+static void BM_MatrixDeterminant(benchmark::State& state) {
+	const std::size_t size = static_cast<std::size_t>(state.range(0));
+	const rto::Matrix<R> a = unimodularMatrix(size, 4);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.determinant(static_cast<unsigned int>(state.range(1))));
+	}
+	state.SetItemsProcessed(state.iterations() * size * size * size / 3);
+}
+
+BENCHMARK(BM_MatrixMultiplyNaive)->Arg(100)->Arg(200)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MatrixMultiply)->ArgsProduct({{100, 200, 500, 1000}, {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_MatrixSolve)->ArgsProduct({{100, 200, 500, 1000}, {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_MatrixDeterminant)->ArgsProduct({{100, 1000}, {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
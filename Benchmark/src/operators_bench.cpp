@@ -0,0 +1,212 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/// every public operator of Ratio, for int, long and long long.
+/// The datasets come from dataset.hpp, so two runs (or two machines) time the same values;
+/// run the RatioBenchJson target to get the results in RatioBench.json.
+
+/// size of the operand arrays : small enough to stay in L1, so the operator is timed and not the memory
+constexpr std::size_t operandCount = 1 << 12;
+
+/// numerators and denominators of the operands are below this bound (no overflow for int)
+constexpr int operandMax = 1 << 10;
+
+/// size of the bulk workloads
+constexpr std::size_t bulkSize = 1 << 20;
+
+/////////////////////////////////////////////////////
+// construction
+
+/// from a numerator and a denominator (normalized by the constructor)
+template <typename T>
+static void BM_ConstructPair(benchmark::State& state) {
+	const std::vector<T> numerators = bench::integers<T>(operandCount, operandMax, 1);
+	std::vector<T> denominators = bench::integers<T>(operandCount, operandMax, 2);
+	for(T &denominator : denominators) {
+		denominator = denominator == T(0) ? T(1) : denominator;
+	}
+	for (auto _ : state) {
+		for(std::size_t i=0; i<operandCount; ++i) {
+			benchmark::DoNotOptimize(rto::Ratio<T>(numerators[i], denominators[i]));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * operandCount);
+}
+
+/// from a double (continued fraction)
+template <typename T>
+static void BM_ConstructReal(benchmark::State& state) {
+	const std::vector<double> reals = bench::reals(operandCount, -operandMax, operandMax, 3);
+	for (auto _ : state) {
+		for(double real : reals) {
+			benchmark::DoNotOptimize(rto::Ratio<T>(real));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * operandCount);
+}
+
+/////////////////////////////////////////////////////
+// binary operators : left[i] op right[i]
+
+struct Add {template <typename R> auto operator()(const R &a, const R &b) const {return a + b;}};
+struct Subtract {template <typename R> auto operator()(const R &a, const R &b) const {return a - b;}};
+struct Multiply {template <typename R> auto operator()(const R &a, const R &b) const {return a * b;}};
+struct Divide {template <typename R> auto operator()(const R &a, const R &b) const {return a / b;}};
+struct Less {template <typename R> bool operator()(const R &a, const R &b) const {return a < b;}};
+struct LessEqual {template <typename R> bool operator()(const R &a, const R &b) const {return a <= b;}};
+struct Greater {template <typename R> bool operator()(const R &a, const R &b) const {return a > b;}};
+struct GreaterEqual {template <typename R> bool operator()(const R &a, const R &b) const {return a >= b;}};
+struct Equal {template <typename R> bool operator()(const R &a, const R &b) const {return a == b;}};
+struct NotEqual {template <typename R> bool operator()(const R &a, const R &b) const {return a != b;}};
+struct Compare {template <typename R> int operator()(const R &a, const R &b) const {return a.compare(b);}};
+
+template <typename T, typename Operator>
+static void BM_Binary(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> left = bench::ratios<T>(operandCount, operandMax, 4);
+	std::vector<rto::Ratio<T>> right = bench::ratios<T>(operandCount, operandMax, 5);
+	for(rto::Ratio<T> &ratio : right) {
+		ratio = ratio.numerator() == T(0) ? rto::Ratio<T>(1) : ratio;
+	}
+	for (auto _ : state) {
+		for(std::size_t i=0; i<operandCount; ++i) {
+			benchmark::DoNotOptimize(Operator()(left[i], right[i]));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * operandCount);
+}
+
+/////////////////////////////////////////////////////
+// operators with a number : ratio[i] op value[i]
+
+struct AddScalar {template <typename R, typename T> auto operator()(const R &a, const T &b) const {return a + b;}};
+struct SubtractScalar {template <typename R, typename T> auto operator()(const R &a, const T &b) const {return a - b;}};
+struct MultiplyScalar {template <typename R, typename T> auto operator()(const R &a, const T &b) const {return a * b;}};
+struct DivideScalar {template <typename R, typename T> auto operator()(const R &a, const T &b) const {return a / b;}};
+
+template <typename T, typename Operator>
+static void BM_Scalar(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> ratios = bench::ratios<T>(operandCount, operandMax, 6);
+	std::vector<T> values = bench::integers<T>(operandCount, operandMax, 7);
+	for(T &value : values) {
+		value = value == T(0) ? T(1) : value;
+	}
+	for (auto _ : state) {
+		for(std::size_t i=0; i<operandCount; ++i) {
+			benchmark::DoNotOptimize(Operator()(ratios[i], values[i]));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * operandCount);
+}
+
+/////////////////////////////////////////////////////
+// unary operators and mathematical functions
+
+struct Negate {template <typename R> R operator()(const R &a) const {return -a;}};
+struct Abs {template <typename R> R operator()(const R &a) const {return abs(a);}};
+struct Floor {template <typename R> R operator()(const R &a) const {return floor(a);}};
+struct Sqrt {template <typename R> R operator()(const R &a) const {return sqrt(a);}};
+struct Cube {template <typename R> R operator()(const R &a) const {return pow(a, 3);}};
+struct Sin {template <typename R> R operator()(const R &a) const {return sin(a);}};
+struct Cos {template <typename R> R operator()(const R &a) const {return cos(a);}};
+struct Tan {template <typename R> R operator()(const R &a) const {return tan(a);}};
+struct Exp {template <typename R> R operator()(const R &a) const {return exp(a);}};
+struct Log {template <typename R> R operator()(const R &a) const {return log(a);}};
+
+/// operands in [-16, 16] (in [1/16, 16] if Positive), so that exp and pow stay in the range of int
+template <typename T, typename Function, bool Positive = false>
+static void BM_Unary(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> ratios = Positive ? bench::positiveRatios<T>(operandCount, 16, 8)
+	                                                   : bench::ratios<T>(operandCount, 16, 8);
+	for (auto _ : state) {
+		for(const rto::Ratio<T> &ratio : ratios) {
+			benchmark::DoNotOptimize(Function()(ratio));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * operandCount);
+}
+
+/////////////////////////////////////////////////////
+// bulk workloads
+
+/// sum of 2^20 ratios with denominators in [1, 16] : the denominator of the sum divides lcm(1..16),
+/// the numerator still wraps around for int (the timing is the one of a real accumulation)
+template <typename T>
+static void BM_Sum(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> ratios = bench::ratios<T>(bulkSize, 16, 9);
+	for (auto _ : state) {
+		rto::Ratio<T> sum;
+		for(const rto::Ratio<T> &ratio : ratios) {
+			sum = sum + ratio;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * bulkSize);
+}
+
+/// std::sort of 2^20 ratios
+template <typename T>
+static void BM_SortBulk(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> ratios = bench::ratios<T>(bulkSize, operandMax, 10);
+	std::vector<rto::Ratio<T>> sorted;
+	for (auto _ : state) {
+		state.PauseTiming();
+		sorted = ratios;
+		state.ResumeTiming();
+		std::sort(sorted.begin(), sorted.end());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * bulkSize);
+}
+
+/////////////////////////////////////////////////////
+// registration : every benchmark for int, long and long long
+
+#define RATIO_BENCHMARK_TYPES(bench, ...) \
+	BENCHMARK_TEMPLATE(bench, int, ##__VA_ARGS__); \
+	BENCHMARK_TEMPLATE(bench, long, ##__VA_ARGS__); \
+	BENCHMARK_TEMPLATE(bench, long long, ##__VA_ARGS__)
+
+RATIO_BENCHMARK_TYPES(BM_ConstructPair);
+RATIO_BENCHMARK_TYPES(BM_ConstructReal);
+
+RATIO_BENCHMARK_TYPES(BM_Binary, Add);
+RATIO_BENCHMARK_TYPES(BM_Binary, Subtract);
+RATIO_BENCHMARK_TYPES(BM_Binary, Multiply);
+RATIO_BENCHMARK_TYPES(BM_Binary, Divide);
+RATIO_BENCHMARK_TYPES(BM_Binary, Less);
+RATIO_BENCHMARK_TYPES(BM_Binary, LessEqual);
+RATIO_BENCHMARK_TYPES(BM_Binary, Greater);
+RATIO_BENCHMARK_TYPES(BM_Binary, GreaterEqual);
+RATIO_BENCHMARK_TYPES(BM_Binary, Equal);
+RATIO_BENCHMARK_TYPES(BM_Binary, NotEqual);
+RATIO_BENCHMARK_TYPES(BM_Binary, Compare);
+
+RATIO_BENCHMARK_TYPES(BM_Scalar, AddScalar);
+RATIO_BENCHMARK_TYPES(BM_Scalar, SubtractScalar);
+RATIO_BENCHMARK_TYPES(BM_Scalar, MultiplyScalar);
+RATIO_BENCHMARK_TYPES(BM_Scalar, DivideScalar);
+
+RATIO_BENCHMARK_TYPES(BM_Unary, Negate);
+RATIO_BENCHMARK_TYPES(BM_Unary, Abs);
+RATIO_BENCHMARK_TYPES(BM_Unary, Floor);
+RATIO_BENCHMARK_TYPES(BM_Unary, Sqrt, true);
+RATIO_BENCHMARK_TYPES(BM_Unary, Cube);
+RATIO_BENCHMARK_TYPES(BM_Unary, Sin);
+RATIO_BENCHMARK_TYPES(BM_Unary, Cos);
+RATIO_BENCHMARK_TYPES(BM_Unary, Tan);
+RATIO_BENCHMARK_TYPES(BM_Unary, Exp);
+RATIO_BENCHMARK_TYPES(BM_Unary, Log, true);
+
+BENCHMARK_TEMPLATE(BM_Sum, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sum, long)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sum, long long)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortBulk, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortBulk, long)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortBulk, long long)->Unit(benchmark::kMillisecond);
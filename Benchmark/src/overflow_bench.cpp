@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+template <typename R>
+static std::vector<R> randomRatios(std::size_t size, unsigned int offset) {
+	using T = typename R::value_type;
+	std::vector<R> ratios;
+	ratios.reserve(size);
+	for(const rto::Ratio<T> &rat : bench::positiveRatios<T>(size, 1 << 12, offset)) {
+		ratios.push_back(R(rat.numerator(), rat.denominator()));
+	}
+	return ratios;
+}
+
+/////////////////////////////////////////////////////
+// a[i]*b[i] + b[i] for each overflow policy
+
+template <typename R>
+static void BM_OverflowPolicy(benchmark::State& state) {
+	const std::vector<R> a = randomRatios<R>(1 << 12, 1);
+	const std::vector<R> b = randomRatios<R>(1 << 12, 2);
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {
+			benchmark::DoNotOptimize(a[i] * b[i] + b[i]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+	state.counters["bytes_per_ratio"] = sizeof(R);
+}
+
+BENCHMARK_TEMPLATE(BM_OverflowPolicy, rto::Ratio<std::int64_t, rto::Eager, rto::Wrap>);
+BENCHMARK_TEMPLATE(BM_OverflowPolicy, rto::Ratio<std::int32_t, rto::Eager, rto::Wrap>);
+BENCHMARK_TEMPLATE(BM_OverflowPolicy, rto::Ratio<std::int32_t, rto::Eager, rto::Checked>);
+BENCHMARK_TEMPLATE(BM_OverflowPolicy, rto::Ratio<std::int32_t, rto::Eager, rto::Widen>);
+BENCHMARK_TEMPLATE(BM_OverflowPolicy, rto::Ratio<std::int32_t, rto::Eager, rto::Saturate>);
+BENCHMARK_TEMPLATE(BM_OverflowPolicy, rto::Ratio<std::int64_t, rto::Eager, rto::Widen>);
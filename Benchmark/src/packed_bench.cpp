@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "RatioPacked.hpp"
+#include "dataset.hpp"
+
+
+/// dataset of small fractions : numerators in [-1000, 1000], denominators in [1, 1000] (11 + 10 bits)
+
+static std::vector<rto::Ratio<int>> smallFractions(std::size_t size) {
+	return bench::ratios<int>(size, 1000, 101);
+}
+
+/////////////////////////////////////////////////////
+// copies : std::vector<Ratio> is copied with memcpy since Ratio is trivially copyable
+
+static void BM_CopyRatioVector(benchmark::State& state) {
+	const std::vector<rto::Ratio<int>> values = smallFractions(state.range(0));
+	for (auto _ : state) {
+		std::vector<rto::Ratio<int>> copy = values;
+		benchmark::DoNotOptimize(copy.data());
+	}
+	state.SetBytesProcessed(state.iterations() * values.size() * sizeof(rto::Ratio<int>));
+}
+
+/////////////////////////////////////////////////////
+// packing and unpacking
+
+static void BM_Pack(benchmark::State& state) {
+	const std::vector<rto::Ratio<int>> values = smallFractions(state.range(0));
+	for (auto _ : state) {
+		rto::PackedRatioVector<int> packed(values);
+		benchmark::DoNotOptimize(packed.memoryBytes());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+	state.counters["bytesPerRatio"] = static_cast<double>(rto::PackedRatioVector<int>(values).memoryBytes()) / static_cast<double>(values.size());
+}
+
+static void BM_Unpack(benchmark::State& state) {
+	const rto::PackedRatioVector<int> packed(smallFractions(state.range(0)));
+	std::vector<rto::Ratio<int>> result(packed.size());
+	for (auto _ : state) {
+		packed.unpack(result.data());
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations() * packed.size());
+}
+
+/////////////////////////////////////////////////////
+// scan : count of the ratios below 1/2
+
+static void BM_ScanRatioVector(benchmark::State& state) {
+	const std::vector<rto::Ratio<int>> values = smallFractions(state.range(0));
+	const rto::Ratio<int> half(1, 2);
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for(const rto::Ratio<int> &rat : values) {count += rat < half;}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+	state.counters["bytesPerRatio"] = static_cast<double>(sizeof(rto::Ratio<int>));
+}
+
+static void BM_ScanPacked(benchmark::State& state) {
+	const rto::PackedRatioVector<int> packed(smallFractions(state.range(0)));
+	const rto::Ratio<int> half(1, 2);
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for(const rto::Ratio<int> rat : packed) {count += rat < half;}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * packed.size());
+	state.counters["bytesPerRatio"] = static_cast<double>(packed.memoryBytes()) / static_cast<double>(packed.size());
+}
+
+BENCHMARK(BM_CopyRatioVector)->Arg(1<<20);
+BENCHMARK(BM_Pack)->Arg(1<<20);
+BENCHMARK(BM_Unpack)->Arg(1<<20);
+BENCHMARK(BM_ScanRatioVector)->Arg(1<<20);
+BENCHMARK(BM_ScanPacked)->Arg(1<<20);
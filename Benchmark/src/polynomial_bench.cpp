@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "RatioPolynomial.hpp"
+#include "dataset.hpp"
+
+
+/// polynomials of degree range(0) with coefficients in [-9, 9] / [1, 9], at 4096 points whose numerators
+/// and denominators are bounded by pointMax<T> : the exact values fit in T (no wrap around for any of the loops)
+
+constexpr std::size_t pointCount = 4096;
+
+template <typename T> constexpr T pointMax = T(16);
+template <> constexpr int pointMax<int> = 4;
+
+/////////////////////////////////////////////////////
+// Polynomial
+
+/// Horner scheme with the ratio operators (two gcds per step)
+template <typename T>
+static void BM_PolynomialHorner(benchmark::State& state) {
+	const rto::Polynomial<T> poly(bench::ratios<T>(static_cast<std::size_t>(state.range(0)) + 1, 9, 21));
+	const std::vector<rto::Ratio<T>> points = bench::ratios<T>(pointCount, pointMax<T>, 22);
+	std::vector<rto::Ratio<T>> values(points.size());
+	for (auto _ : state) {
+		for(std::size_t i=0; i<points.size(); ++i) {
+			values[i] = poly.horner(points[i]);
+		}
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/// batch evaluation, integer homogeneous Horner on the whole batch and one normalization per point
+template <typename T>
+static void BM_PolynomialBatch(benchmark::State& state) {
+	const rto::Polynomial<T> poly(bench::ratios<T>(static_cast<std::size_t>(state.range(0)) + 1, 9, 21));
+	const rto::RatioArray<T> points(bench::ratios<T>(pointCount, pointMax<T>, 22));
+	rto::RatioArray<T> values;
+	for (auto _ : state) {
+		poly.evaluate(points, values);
+		benchmark::DoNotOptimize(values.numerators());
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/////////////////////////////////////////////////////
+// RationalFunction
+
+/// P(x) / Q(x) with the ratio operators
+template <typename T>
+static void BM_RationalFunctionHorner(benchmark::State& state) {
+	const rto::RationalFunction<T> f(rto::Polynomial<T>(bench::ratios<T>(static_cast<std::size_t>(state.range(0)) + 1, 9, 23)),
+	                                 rto::Polynomial<T>(bench::positiveRatios<T>(static_cast<std::size_t>(state.range(0)) / 2 + 1, 9, 24)));
+	const std::vector<rto::Ratio<T>> points = bench::positiveRatios<T>(pointCount, pointMax<T>, 25);
+	std::vector<rto::Ratio<T>> values(points.size());
+	for (auto _ : state) {
+		for(std::size_t i=0; i<points.size(); ++i) {
+			values[i] = f.numerator().horner(points[i]) / f.denominator().horner(points[i]);
+		}
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/// batch evaluation of P/Q, one normalization per point
+template <typename T>
+static void BM_RationalFunctionBatch(benchmark::State& state) {
+	const rto::RationalFunction<T> f(rto::Polynomial<T>(bench::ratios<T>(static_cast<std::size_t>(state.range(0)) + 1, 9, 23)),
+	                                 rto::Polynomial<T>(bench::positiveRatios<T>(static_cast<std::size_t>(state.range(0)) / 2 + 1, 9, 24)));
+	const rto::RatioArray<T> points(bench::positiveRatios<T>(pointCount, pointMax<T>, 25));
+	rto::RatioArray<T> values;
+	for (auto _ : state) {
+		f.evaluate(points, values);
+		benchmark::DoNotOptimize(values.numerators());
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+// the results of degree 8 (12 for long) still fit in T
+BENCHMARK_TEMPLATE(BM_PolynomialHorner, int)->Arg(4)->Arg(8);
+BENCHMARK_TEMPLATE(BM_PolynomialBatch, int)->Arg(4)->Arg(8);
+BENCHMARK_TEMPLATE(BM_PolynomialHorner, long)->Arg(4)->Arg(8)->Arg(12);
+BENCHMARK_TEMPLATE(BM_PolynomialBatch, long)->Arg(4)->Arg(8)->Arg(12);
+BENCHMARK_TEMPLATE(BM_RationalFunctionHorner, int)->Arg(4)->Arg(8);
+BENCHMARK_TEMPLATE(BM_RationalFunctionBatch, int)->Arg(4)->Arg(8);
+BENCHMARK_TEMPLATE(BM_RationalFunctionHorner, long)->Arg(4)->Arg(12);
+BENCHMARK_TEMPLATE(BM_RationalFunctionBatch, long)->Arg(4)->Arg(12);
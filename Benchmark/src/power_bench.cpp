@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "dataset.hpp"
+
+
+/// 1024 ratios with numerators and denominators in [1, 40], raised to the power 11 (fits in 64 bits)
+
+constexpr std::size_t powerCount = 1024;
+constexpr int exponent = 11;
+
+/////////////////////////////////////////////////////
+// baselines : the previous versions, through floating point
+
+template <typename R>
+static R powDouble(const R &rat, int n) {
+	return R(static_cast<typename R::value_type>(std::pow(rat.numerator(), n)), static_cast<typename R::value_type>(std::pow(rat.denominator(), n)));
+}
+
+template <typename R>
+static R sqrtDouble(const R &rat) {
+	return R(std::sqrt(static_cast<double>(rat.numerator()) / static_cast<double>(rat.denominator())));
+}
+
+/////////////////////////////////////////////////////
+// pow
+
+static void BM_PowDouble(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = bench::positiveRatios<long long>(powerCount, 40, 61);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &rat : values) {
+			benchmark::DoNotOptimize(powDouble(rat, exponent));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_PowExact(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = bench::positiveRatios<long long>(powerCount, 40, 61);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &rat : values) {
+			benchmark::DoNotOptimize(pow(rat, exponent));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_PowChecked(benchmark::State& state) {
+	using C = rto::Ratio<long long, rto::Eager, rto::Checked>;
+	std::vector<C> values;
+	for(const rto::Ratio<long long> &rat : bench::positiveRatios<long long>(powerCount, 40, 61)) {
+		values.push_back(C(rat.numerator(), rat.denominator()));
+	}
+	for (auto _ : state) {
+		for(const C &rat : values) {
+			benchmark::DoNotOptimize(pow(rat, exponent));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/////////////////////////////////////////////////////
+// sqrt
+
+/// squares of ratios (exact roots) if range(0), any ratios otherwise
+static std::vector<rto::Ratio<long long>> sqrtArguments(bool squares) {
+	std::vector<rto::Ratio<long long>> values = bench::positiveRatios<long long>(powerCount, squares ? 1000000 : 1000000000000LL, 62);
+	if(squares) {
+		for(rto::Ratio<long long> &rat : values) {rat = rat * rat;}
+	}
+	return values;
+}
+
+static void BM_SqrtDouble(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = sqrtArguments(state.range(0));
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &rat : values) {
+			benchmark::DoNotOptimize(sqrtDouble(rat));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void BM_SqrtExact(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = sqrtArguments(state.range(0));
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &rat : values) {
+			benchmark::DoNotOptimize(sqrt(rat));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+/// approximations with denominators up to 10^6
+static void BM_SqrtBounded(benchmark::State& state) {
+	const std::vector<rto::Ratio<long long>> values = sqrtArguments(false);
+	for (auto _ : state) {
+		for(const rto::Ratio<long long> &rat : values) {
+			benchmark::DoNotOptimize(sqrt(rat, 1000000LL));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_PowDouble);
+BENCHMARK(BM_PowExact);
+BENCHMARK(BM_PowChecked);
+BENCHMARK(BM_SqrtDouble)->Arg(1)->Arg(0);
+BENCHMARK(BM_SqrtExact)->Arg(1)->Arg(0);
+BENCHMARK(BM_SqrtBounded);
@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "RatioArray.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+template <typename T>
+static std::vector<rto::Ratio<T>> randomRatios(std::size_t size, unsigned int offset) {
+	return bench::positiveRatios<T>(size, 1000, offset);
+}
+
+/////////////////////////////////////////////////////
+// array of structures : std::vector<Ratio> loop
+
+template <typename T>
+static void BM_VectorAdd(benchmark::State& state) {
+	const auto a = randomRatios<T>(state.range(0), 1);
+	const auto b = randomRatios<T>(state.range(0), 2);
+	std::vector<rto::Ratio<T>> result(a.size());
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] + b[i];}
+		benchmark::DoNotOptimize(result.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_VectorMul(benchmark::State& state) {
+	const auto a = randomRatios<T>(state.range(0), 1);
+	const auto b = randomRatios<T>(state.range(0), 2);
+	std::vector<rto::Ratio<T>> result(a.size());
+	for (auto _ : state) {
+		for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] * b[i];}
+		benchmark::DoNotOptimize(result.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/////////////////////////////////////////////////////
+// structure of arrays : RatioArray kernels
+
+template <typename T>
+static void BM_ArrayAdd(benchmark::State& state) {
+	const rto::RatioArray<T> a(randomRatios<T>(state.range(0), 1));
+	const rto::RatioArray<T> b(randomRatios<T>(state.range(0), 2));
+	rto::RatioArray<T> result(a.size());
+	for (auto _ : state) {
+		rto::add(a, b, result);
+		benchmark::DoNotOptimize(result.numerators());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_ArrayMul(benchmark::State& state) {
+	const rto::RatioArray<T> a(randomRatios<T>(state.range(0), 1));
+	const rto::RatioArray<T> b(randomRatios<T>(state.range(0), 2));
+	rto::RatioArray<T> result(a.size());
+	for (auto _ : state) {
+		rto::mul(a, b, result);
+		benchmark::DoNotOptimize(result.numerators());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_ArrayMulScalar(benchmark::State& state) {
+	const rto::RatioArray<T> a(randomRatios<T>(state.range(0), 1));
+	const rto::Ratio<T> scalar(3, 7);
+	rto::RatioArray<T> result(a.size());
+	for (auto _ : state) {
+		rto::mul(a, scalar, result);
+		benchmark::DoNotOptimize(result.numerators());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_ArrayIrreducible(benchmark::State& state) {
+	const rto::RatioArray<T> a(randomRatios<T>(state.range(0), 1));
+	const rto::RatioArray<T> b(randomRatios<T>(state.range(0), 2));
+	rto::RatioArray<T> raw(a.size());
+	for(std::size_t i=0; i<a.size(); ++i) {
+		raw.numerators()[i] = a.numerators()[i] * b.numerators()[i];
+		raw.denominators()[i] = a.denominators()[i] * b.denominators()[i];
+	}
+	rto::RatioArray<T> work(a.size());
+	for (auto _ : state) {
+		state.PauseTiming();
+		work = raw;
+		state.ResumeTiming();
+		work.irreducible();
+		benchmark::DoNotOptimize(work.numerators());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_VectorAdd, int)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayAdd, int)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_VectorMul, int)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayMul, int)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayMulScalar, int)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayIrreducible, int)->Arg(1 << 20);
+
+BENCHMARK_TEMPLATE(BM_VectorAdd, long)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayAdd, long)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_VectorMul, long)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayMul, long)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ArrayIrreducible, long)->Arg(1 << 20);
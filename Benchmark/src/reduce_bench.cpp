@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "RatioReduce.hpp"
+#include "dataset.hpp"
+
+
+/// ratios with denominators in [1, 16] : the sum keeps a small common denominator (prices, probabilities...)
+
+/////////////////////////////////////////////////////
+// sum of n ratios
+
+/// serial operator + (two gcds per term)
+static void BM_SumOperator(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> ratios = bench::ratios<long>(static_cast<std::size_t>(state.range(0)), 16, 11);
+	for (auto _ : state) {
+		rto::Ratio<long> sum;
+		for(const rto::Ratio<long> &ratio : ratios) {
+			sum = sum + ratio;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * ratios.size());
+}
+
+/// reduceSum, running common denominator, range(1) threads (0 for all the cores)
+static void BM_ReduceSum(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> ratios = bench::ratios<long>(static_cast<std::size_t>(state.range(0)), 16, 11);
+	const unsigned int threads = static_cast<unsigned int>(state.range(1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rto::reduceSum(ratios.begin(), ratios.end(), threads));
+	}
+	state.SetItemsProcessed(state.iterations() * ratios.size());
+}
+
+/// reduceProduct of ratios close to 1
+static void BM_ReduceProduct(benchmark::State& state) {
+	std::vector<rto::Ratio<long>> ratios;
+	for(long i=1; i<=state.range(0); ++i) {
+		ratios.push_back(rto::Ratio<long>(i + 1, i));
+	}
+	const unsigned int threads = static_cast<unsigned int>(state.range(1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rto::reduceProduct(ratios.begin(), ratios.end(), threads));
+	}
+	state.SetItemsProcessed(state.iterations() * ratios.size());
+}
+
+/// dot product
+static void BM_Dot(benchmark::State& state) {
+	const std::vector<rto::Ratio<long>> a = bench::ratios<long>(static_cast<std::size_t>(state.range(0)), 16, 12);
+	const std::vector<rto::Ratio<long>> b = bench::ratios<long>(static_cast<std::size_t>(state.range(0)), 16, 13);
+	const unsigned int threads = static_cast<unsigned int>(state.range(1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rto::dot(a.begin(), a.end(), b.begin(), threads));
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_SumOperator)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReduceSum)->Args({1 << 20, 1})->Args({1 << 20, 0})->Args({1 << 24, 1})->Args({1 << 24, 0})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ReduceProduct)->Args({1 << 20, 1})->Args({1 << 20, 0})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Dot)->Args({1 << 20, 1})->Args({1 << 20, 0})->Unit(benchmark::kMillisecond)->UseRealTime();
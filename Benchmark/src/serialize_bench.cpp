@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "RatioSerialize.hpp"
+#include "dataset.hpp"
+
+
+/// 2^20 ratios with numerators and denominators in [-max, max] / [1, max], max = range(0)
+/// (small values are the good case of the varint encoding); the throughputs count 2*sizeof(T) bytes per ratio
+
+constexpr std::size_t ratioCount = std::size_t(1) << 20;
+
+template <typename T>
+static rto::RatioArray<T> dataset(benchmark::State& state) {
+	return rto::RatioArray<T>(bench::ratios<T>(ratioCount, static_cast<T>(state.range(0)), 31));
+}
+
+/////////////////////////////////////////////////////
+// write (to memory, the buffer of the stream is reused from one iteration to the next)
+
+/// baseline : operator << through iostreams
+template <typename T>
+static void BM_WriteText(benchmark::State& state) {
+	const std::vector<rto::Ratio<T>> ratios = dataset<T>(state).toVector();
+	std::ostringstream sink;
+	for (auto _ : state) {
+		sink.seekp(0);
+		for(const rto::Ratio<T> &rat : ratios) {
+			sink << rat;
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * ratios.size() * 2 * sizeof(T));
+}
+
+template <typename T, rto::io::Encoding E>
+static void BM_Write(benchmark::State& state) {
+	const rto::RatioArray<T> array = dataset<T>(state);
+	std::ostringstream sink(std::ios::binary);
+	for (auto _ : state) {
+		sink.seekp(0);
+		rto::io::write(sink, array, E);
+	}
+	state.SetBytesProcessed(state.iterations() * array.size() * 2 * sizeof(T));
+}
+
+/////////////////////////////////////////////////////
+// read
+
+template <typename T, rto::io::Encoding E>
+static void BM_Read(benchmark::State& state) {
+	std::ostringstream out(std::ios::binary);
+	rto::io::write(out, dataset<T>(state), E);
+	std::istringstream in(out.str(), std::ios::binary);
+	for (auto _ : state) {
+		in.seekg(0);
+		benchmark::DoNotOptimize(rto::io::read<T>(in).numerators());
+	}
+	state.SetBytesProcessed(state.iterations() * ratioCount * 2 * sizeof(T));
+	state.counters["fileBytes"] = static_cast<double>(out.str().size());
+}
+
+/// map the file and sum every numerator and denominator (the pages are in the page cache)
+template <typename T>
+static void BM_Mapped(benchmark::State& state) {
+	const std::string path = "/tmp/ratio_serialize_bench.bin";
+	{
+		std::ofstream file(path, std::ios::binary);
+		rto::io::write(file, dataset<T>(state));
+	}
+	for (auto _ : state) {
+		const rto::MappedRatioArray<T> view(path);
+		T sum = 0;
+		for(std::size_t i=0; i<view.size(); ++i) {
+			sum += view.numerators()[i] + view.denominators()[i];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * ratioCount * 2 * sizeof(T));
+	std::remove(path.c_str());
+}
+
+BENCHMARK_TEMPLATE(BM_WriteText, int)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Write, int, rto::io::Encoding::Fixed)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Write, int, rto::io::Encoding::Varint)->Arg(100)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Write, long, rto::io::Encoding::Fixed)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Write, long, rto::io::Encoding::Varint)->Arg(100)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Read, int, rto::io::Encoding::Fixed)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Read, int, rto::io::Encoding::Varint)->Arg(100)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Read, long, rto::io::Encoding::Fixed)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Read, long, rto::io::Encoding::Varint)->Arg(100)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Mapped, int)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Mapped, long)->Arg(1000)->Unit(benchmark::kMillisecond);
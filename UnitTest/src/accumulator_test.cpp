@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "RatioAccumulator.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// helpers
+
+/// ratios with numerators in [-100, 100] and denominators in [1, 16] (their lcm is 720720)
+static std::vector<rto::Ratio<long long>> smallRatios(std::size_t size, unsigned int seed) {
+	return dataset::ratios<long long>(size, {-100, 100}, {1, 16}, seed);
+}
+
+/////////////////////////////////////////////////////
+// sums
+
+TEST (RatioAccumulator, matchesOperatorPlus) {
+	const std::vector<rto::Ratio<long long>> values = smallRatios(10000, 1);
+	rto::RatioAccumulator<long long> accumulator;
+	rto::Ratio<long long> sum;
+	for(const rto::Ratio<long long> &value : values) {
+		accumulator += value;
+		sum = sum + value;
+	}
+	ASSERT_EQ(accumulator.result(), sum);
+	ASSERT_EQ(accumulator.count(), values.size());
+	/// the common denominator is the lcm of the denominators, never more
+	ASSERT_EQ(720720 % accumulator.denominator(), 0);
+}
+
+TEST (RatioAccumulator, cents) {
+	/// prices in cents : a single common denominator, the sum is exact
+	rto::RatioAccumulator<int> accumulator;
+	long long cents = 0;
+	for(int i=0; i<200000; ++i) {
+		const int price = (i * 7919) % 100000;
+		accumulator.add(rto::Ratio<int>(price, 100));
+		cents += price;
+	}
+	ASSERT_EQ(accumulator.denominator(), 100);
+	ASSERT_EQ(accumulator.numerator(), cents);
+	const rto::Ratio<int> mean = accumulator.mean();
+	ASSERT_EQ(static_cast<long long>(mean.numerator()) * 200000 * 100, cents * mean.denominator());
+
+	/// a sum too large for an int, even reduced, is exact in the wider type
+	rto::RatioAccumulator<int> large;
+	for(int i=0; i<3; ++i) {large.add(rto::Ratio<int>(2000000001, 100));}
+	ASSERT_EQ(large.numerator(), 6000000003LL);
+	ASSERT_THROW(large.result(), std::overflow_error);
+	ASSERT_EQ(large.mean(), rto::Ratio<int>(2000000001, 100));
+}
+
+TEST (RatioAccumulator, signs) {
+	/// negative denominators and Deferred values
+	rto::RatioAccumulator<int> accumulator;
+	accumulator.add(rto::Ratio<int>(1, -2));
+	using D = rto::Ratio<int, rto::Deferred>;
+	accumulator.add(D(1, 4) + D(1, 4));
+	accumulator.add(rto::Ratio<int>(-1, -3));
+	const rto::Ratio<int> result = accumulator.result();
+	ASSERT_EQ(result.numerator(), 1);
+	ASSERT_EQ(result.denominator(), 3);
+
+	accumulator.clear();
+	ASSERT_EQ(accumulator.result(), rto::Ratio<int>(0));
+	ASSERT_EQ(accumulator.count(), 0u);
+}
+
+TEST (RatioAccumulator, nearOverflow) {
+	/// the common denominator 2147483647 * 2147483629 leaves no room for a factor 3 : the sum (0) is
+	/// reduced first, then 1/3 is added
+	rto::RatioAccumulator<int> accumulator;
+	accumulator.add(rto::Ratio<int>(1, 2147483647));
+	accumulator.add(rto::Ratio<int>(1, 2147483629));
+	accumulator.add(rto::Ratio<int>(-1, 2147483647));
+	accumulator.add(rto::Ratio<int>(-1, 2147483629));
+	accumulator.add(rto::Ratio<int>(1, 3));
+	ASSERT_EQ(accumulator.result(), rto::Ratio<int>(1, 3));
+
+	/// an lcm beyond the wider type
+	rto::RatioAccumulator<int> overflowing;
+	overflowing.add(rto::Ratio<int>(1, 2147483647));
+	overflowing.add(rto::Ratio<int>(1, 2147483629));
+	ASSERT_THROW(overflowing.add(rto::Ratio<int>(1, 3)), std::overflow_error);
+}
+
+/////////////////////////////////////////////////////
+// merge
+
+TEST (RatioAccumulator, mergeThreads) {
+	const std::vector<rto::Ratio<long long>> values = smallRatios(40000, 2);
+	rto::RatioAccumulator<long long> single;
+	for(const rto::Ratio<long long> &value : values) {single.add(value);}
+
+	/// one accumulator per thread, merged at the end
+	std::vector<rto::RatioAccumulator<long long>> partials(4);
+	std::vector<std::thread> threads;
+	for(std::size_t t=0; t<partials.size(); ++t) {
+		threads.emplace_back([&values, &partials, t]() {
+			for(std::size_t i=t; i<values.size(); i+=4) {partials[t].add(values[i]);}
+		});
+	}
+	for(std::thread &thread : threads) {thread.join();}
+	rto::RatioAccumulator<long long> merged;
+	for(const rto::RatioAccumulator<long long> &partial : partials) {merged.merge(partial);}
+
+	ASSERT_EQ(merged.result(), single.result());
+	ASSERT_EQ(merged.count(), values.size());
+	ASSERT_EQ(merged.mean(), single.mean());
+}
+
+/////////////////////////////////////////////////////
+// means
+
+TEST (RatioAccumulator, means) {
+	using R = rto::Ratio<int>;
+	ASSERT_EQ(rto::mean(std::vector<R>{R(1, 2), R(1, 3)}), R(5, 12));
+	ASSERT_EQ(rto::mean(std::vector<R>{R(-1, 2), R(1, 2), R(3)}), R(1));
+	/// (1/2 * 1 + 1/3 * 2) / 3 = 7/18
+	ASSERT_EQ(rto::weightedMean(std::vector<R>{R(1, 2), R(1, 3)}, std::vector<R>{R(1), R(2)}), R(7, 18));
+	/// weights as ratios, negative values
+	ASSERT_EQ(rto::weightedMean(std::vector<R>{R(-2), R(4)}, std::vector<R>{R(1, 4), R(3, 4)}), R(5, 2));
+
+	/// mean of large values : the count is cancelled before the products
+	std::vector<rto::Ratio<long long>> large(1000, rto::Ratio<long long>(std::numeric_limits<long long>::max() - 1, 3));
+	ASSERT_EQ(rto::mean(large), large[0]);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "RatioBigInt.hpp"
+
+
+/////////////////////////////////////////////////////
+// RatioArena
+
+/// freed blocks are reused by the next allocation of the same size class
+
+TEST (RatioArena, freeLists) { 
+	rto::RatioArena arena(1024);
+	void *a = arena.allocate(24);
+	void *b = arena.allocate(100);
+	ASSERT_NE(a, b);
+	arena.deallocate(a, 24);
+	ASSERT_EQ(arena.allocate(32), a);
+	ASSERT_EQ(arena.stats().allocations, 3u);
+	ASSERT_EQ(arena.stats().reused, 1u);
+	ASSERT_EQ(arena.stats().systemAllocations, 1u);
+}
+
+/// reset releases everything, the chunks are merged and kept
+
+TEST (RatioArena, reset) { 
+	rto::RatioArena arena(256);
+	for(int i=0; i<20; ++i) {
+		arena.allocate(64);
+	}
+	ASSERT_GT(arena.stats().systemAllocations, 1u);
+	arena.reset();
+	arena.resetStats();
+	for(int i=0; i<20; ++i) {
+		arena.allocate(64);
+	}
+	ASSERT_EQ(arena.stats().systemAllocations, 1u);
+	arena.reset();
+	arena.resetStats();
+	for(int i=0; i<20; ++i) {
+		arena.allocate(64);
+	}
+	ASSERT_EQ(arena.stats().systemAllocations, 0u);
+	ASSERT_EQ(arena.stats().bytesInUse, 20u * 64u);
+}
+
+/// the limbs of BigInt come from the arena of the current scope
+
+TEST (RatioArena, scope) { 
+	rto::RatioArena arena;
+	ASSERT_EQ(rto::RatioArena::current(), nullptr);
+	rto::Ratio<rto::BigInt> kept;
+	{
+		rto::RatioArena::Scope scope(arena);
+		ASSERT_EQ(rto::RatioArena::current(), &arena);
+		rto::Ratio<rto::BigInt> sum;
+		for(int i=1; i<=60; ++i) {
+			sum = sum + rto::Ratio<rto::BigInt>(1, i);
+		}
+		ASSERT_GT(arena.stats().allocations, 0u);
+		kept = sum;
+	}
+	ASSERT_EQ(rto::RatioArena::current(), nullptr);
+	ASSERT_EQ(arena.stats().bytesInUse, 0u);
+	ASSERT_EQ(kept.denominator().toString(), "3230237388259077233637600");
+}
+
+/// a move assignment out of the scope does not keep the limbs in the arena
+
+TEST (RatioArena, moveOutOfScope) { 
+	rto::RatioArena arena;
+	rto::BigInt factorial(1);
+	{
+		rto::RatioArena::Scope scope(arena);
+		rto::BigInt product(1);
+		for(int i=1; i<=40; ++i) {
+			product = product * rto::BigInt(i);
+		}
+		factorial = product * rto::BigInt(41);
+	}
+	rto::Ratio<rto::BigInt> kept;
+	{
+		rto::RatioArena::Scope scope(arena);
+		rto::Ratio<rto::BigInt> sum;
+		for(int i=1; i<=61; ++i) {
+			sum = sum + rto::Ratio<rto::BigInt>(1, i);
+		}
+		kept = std::move(sum);
+	}
+	{
+		rto::RatioArena::Scope scope(arena);
+		rto::BigInt noise(1);
+		for(int i=1; i<=100; ++i) {
+			noise = noise * rto::BigInt(7919);
+		}
+	}
+	ASSERT_EQ(factorial.toString(), "33452526613163807108170062053440751665152000000000");
+	ASSERT_EQ(kept.denominator().toString(), "197044480683803711251893600");
+}
+
+/// steady state : a batch that already ran once does not call malloc
+
+TEST (RatioArena, steadyState) { 
+	rto::RatioArena arena(1 << 10);
+	auto batch = [&arena]() {
+		rto::RatioArena::Scope scope(arena);
+		rto::BigInt product(1);
+		for(int i=1; i<=200; ++i) {
+			product = product * rto::BigInt(i);
+		}
+		return product.size();
+	};
+	batch();
+	batch();
+	arena.resetStats();
+	const std::size_t heap = rto::RatioArena::heapAllocations();
+	ASSERT_GT(batch(), 1u);
+	ASSERT_GT(arena.stats().allocations, 0u);
+	ASSERT_EQ(arena.stats().systemAllocations, 0u);
+	ASSERT_EQ(rto::RatioArena::heapAllocations(), heap);
+}
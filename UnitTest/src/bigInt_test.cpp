@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include "RatioBigInt.hpp"
+
+
+/////////////////////////////////////////////////////
+// BigInt
+
+/// values that fit in an int64 are stored inline
+
+TEST (BigInt, inlineStorage) { 
+	rto::BigInt a(std::numeric_limits<std::int64_t>::max());
+	ASSERT_TRUE(a.isSmall());
+	ASSERT_TRUE((-a).isSmall());
+
+	rto::BigInt b = a + rto::BigInt(1);
+	ASSERT_FALSE(b.isSmall());
+	ASSERT_EQ(b.size(), 1u);
+	ASSERT_TRUE((b - rto::BigInt(1)).isSmall());
+	ASSERT_TRUE(rto::BigInt(std::numeric_limits<std::int64_t>::min()) == -b);
+	ASSERT_TRUE(rto::BigInt(std::numeric_limits<std::uint64_t>::max()) == b + b - rto::BigInt(1));
+}
+
+/// decimal output
+
+TEST (BigInt, toString) { 
+	ASSERT_EQ(rto::BigInt(-1234567).toString(), "-1234567");
+	ASSERT_EQ((rto::BigInt(1) << 128).toString(), "340282366920938463463374607431768211456");
+	ASSERT_EQ((-(rto::BigInt(10000000000000000000ull) * rto::BigInt(10000000000000000000ull))).toString(), "-100000000000000000000000000000000000000");
+
+	std::stringstream stream;
+	stream << (rto::BigInt(1) << 64);
+	ASSERT_EQ(stream.str(), "18446744073709551616");
+}
+
+/// arithmetic against __int128
+
+#if defined(__SIZEOF_INT128__)
+TEST (BigInt, arithmetic) { 
+	using I = rto::overflow::int128;
+	std::mt19937_64 generator(3);
+	for(int i=0; i<10000; ++i) {
+		const I a = I(static_cast<std::int64_t>(generator())) * (I(1) << 40) + I(generator() >> (generator() % 64));
+		const I b = I(static_cast<std::int64_t>(generator() >> (generator() % 64))) | 1;
+		const rto::BigInt x(a), y(b);
+		ASSERT_TRUE(x + y == rto::BigInt(a + b));
+		ASSERT_TRUE(x - y == rto::BigInt(a - b));
+		ASSERT_TRUE(x / y == rto::BigInt(a / b));
+		ASSERT_TRUE(x % y == rto::BigInt(a % b));
+		ASSERT_TRUE(rto::BigInt(a >> 64) * y == rto::BigInt((a >> 64) * b));
+		ASSERT_EQ(x < y, a < b);
+		ASSERT_EQ(static_cast<std::int64_t>(x), static_cast<std::int64_t>(a));
+	}
+}
+#endif
+
+/// products above the Karatsuba threshold, checked by division
+
+TEST (BigInt, karatsuba) { 
+	std::mt19937_64 generator(5);
+	rto::BigInt x(1), y(3);
+	for(int i=0; i<200; ++i) {
+		x = x * rto::BigInt(generator() >> 1) + rto::BigInt(7);
+		y = y * rto::BigInt(generator() >> 1) + rto::BigInt(11);
+	}
+	ASSERT_GT(y.size(), 2 * rto::BigInt::karatsubaThreshold);
+	const rto::BigInt product = x * y;
+	ASSERT_TRUE(product / y == x);
+	ASSERT_TRUE(product / x == y);
+	ASSERT_TRUE((product + rto::BigInt(5)) % x == rto::BigInt(5));
+}
+
+/// Lehmer gcd
+
+TEST (BigInt, gcd) { 
+	ASSERT_TRUE(rto::gcd(rto::BigInt(-12), rto::BigInt(18)) == rto::BigInt(6));
+	ASSERT_TRUE(rto::gcd(rto::BigInt(0), rto::BigInt(0)) == rto::BigInt(0));
+
+	const rto::BigInt common = (rto::BigInt(1) << 150) + rto::BigInt(3);
+	const rto::BigInt a = common * ((rto::BigInt(1) << 90) + rto::BigInt(1));
+	const rto::BigInt b = common * ((rto::BigInt(1) << 70) + rto::BigInt(5));
+	ASSERT_TRUE(rto::gcd(a, b) == common);
+	ASSERT_TRUE(rto::gcd(-a, common * rto::BigInt(12)) == common);
+}
+
+/////////////////////////////////////////////////////
+// Ratio<BigInt>
+
+/// exact harmonic sum, far beyond 64 bits
+
+TEST (RatioBigInt, harmonicSum) { 
+	rto::Ratio<rto::BigInt> sum;
+	for(int i=1; i<=60; ++i) {
+		sum = sum + rto::Ratio<rto::BigInt>(1, i);
+	}
+	ASSERT_EQ(sum.numerator().toString(), "15117092380124150817026911");
+	ASSERT_EQ(sum.denominator().toString(), "3230237388259077233637600");
+}
+
+TEST (RatioBigInt, operators) { 
+	using R = rto::Ratio<rto::BigInt>;
+	const R res = R(2, 4) * R(3, 5) / R(7, 9) - R(1, 7);
+	ASSERT_TRUE(res == R(17, 70));
+	ASSERT_TRUE(R(1, 3) < R(1, 2));
+	ASSERT_TRUE(abs(R(-1, 3)) == R(1, 3));
+	ASSERT_TRUE(R(1, 2) + 1 == R(3, 2));
+}
+
+/// conversions from reals: approximation when it is precise, exact value otherwise
+
+TEST (RatioBigInt, fromReal) { 
+	using R = rto::Ratio<rto::BigInt>;
+	ASSERT_TRUE(R(0.1) == R(1, 10));
+	ASSERT_TRUE(R(-2.5) == R(-5, 2));
+	ASSERT_TRUE(R::fromExact(0.1) == R(3602879701896397, rto::BigInt(1) << 55));
+	ASSERT_TRUE(R(1e30) == R::fromExact(1e30));
+	ASSERT_EQ(R(1e30).numerator().toString(), "1000000000000000019884624838656");
+}
+
+/// every normalization policy works with BigInt
+
+TEST (RatioBigInt, policies) { 
+	using D = rto::Ratio<rto::BigInt, rto::Deferred>;
+	D deferred;
+	for(int i=1; i<=20; ++i) {
+		deferred = deferred + D(1, i);
+	}
+	ASSERT_TRUE(deferred == D(55835135, 15519504));
+
+	using F = rto::Ratio<rto::BigInt, rto::Fused>;
+	const F fused = F(1, 2) * F(2, 3) + F(1, 6);
+	ASSERT_TRUE(fused == F(1, 2));
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "RatioCache.hpp"
+
+
+/////////////////////////////////////////////////////
+// same results as fromReal
+
+TEST (RatioCache, matchesFromReal) {
+	std::mt19937 generator(12);
+	std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+	std::vector<double> reals(500);
+	for(double &real : reals) {real = distribution(generator);}
+	reals.push_back(0.0);
+	reals.push_back(-0.0);
+	reals.push_back(0.1);
+	reals.push_back(1e300);
+	reals.push_back(-1e-300);
+
+	/// twice : the second pass is served by the cache
+	for(int pass=0; pass<2; ++pass) {
+		for(const double real : reals) {
+			ASSERT_EQ(rto::cachedFromReal<int>(real), rto::Ratio<int>::fromReal(real)) << real;
+			ASSERT_EQ(rto::cachedFromReal<long long>(real, 1000LL), rto::Ratio<long long>::fromReal(real, 1000LL)) << real;
+			ASSERT_EQ(rto::cachedFromReal<int>(real, 1 << 20, 1e-3), rto::Ratio<int>::fromReal(real, 1 << 20, 1e-3)) << real;
+		}
+	}
+}
+
+TEST (RatioCache, parameters) {
+	/// the bound and the tolerance are part of the key
+	const double pi = 3.14159265358979323846;
+	ASSERT_EQ(rto::cachedFromReal<int>(pi, 7), rto::Ratio<int>(22, 7));
+	ASSERT_EQ(rto::cachedFromReal<int>(pi, 113), rto::Ratio<int>(355, 113));
+	ASSERT_EQ(rto::cachedFromReal<int>(pi, 7), rto::Ratio<int>(22, 7));
+	ASSERT_EQ(rto::cachedFromReal<int>(pi, 1000, 1e-2), rto::Ratio<int>(22, 7));
+	ASSERT_EQ(rto::cachedFromReal<int>(pi, 1000, 1e-6), rto::Ratio<int>(355, 113));
+	/// and every integer type has its own tiers
+	ASSERT_EQ(rto::cachedFromReal<short>(pi, short(7)), rto::Ratio<short>(22, 7));
+}
+
+TEST (RatioCache, batch) {
+	const std::vector<double> reals = {0.5, 0.25, 0.5, 0.75, 0.25, 0.5};
+	std::vector<rto::Ratio<int>> result(reals.size());
+	rto::cachedFromReal(reals.data(), reals.size(), result.data());
+	for(std::size_t i=0; i<reals.size(); ++i) {
+		ASSERT_EQ(result[i], rto::Ratio<int>::fromReal(reals[i]));
+	}
+}
+
+/////////////////////////////////////////////////////
+// statistics
+
+TEST (RatioCache, statistics) {
+	rto::clearCache<long>();
+	rto::resetCacheStatistics();
+	ASSERT_EQ(rto::cacheStatistics().lookups(), 0u);
+	ASSERT_EQ(rto::cacheStatistics().hitRate(), 0.0);
+
+	for(int i=0; i<10; ++i) {rto::cachedFromReal<long>(0.1);}
+	rto::cachedFromReal<long>(0.2);
+	const rto::CacheStatistics statistics = rto::threadCacheStatistics();
+	ASSERT_EQ(statistics.misses, 2u);
+	ASSERT_EQ(statistics.hits, 9u);
+	ASSERT_EQ(statistics.sharedHits, 0u);
+	ASSERT_DOUBLE_EQ(statistics.hitRate(), 9.0 / 11.0);
+	ASSERT_EQ(rto::cacheStatistics().lookups(), 11u);
+
+	/// after a clear, the values are converted again
+	rto::clearCache<long>();
+	rto::cachedFromReal<long>(0.1);
+	ASSERT_EQ(rto::threadCacheStatistics().misses, 3u);
+}
+
+TEST (RatioCache, sharedTier) {
+	rto::clearCache<long>();
+	rto::resetCacheStatistics();
+	/// a value converted by a thread is found by the others in the shared tier
+	std::thread converter([]() {rto::cachedFromReal<long>(2.718281828459045);});
+	converter.join();
+	ASSERT_EQ(rto::cachedFromReal<long>(2.718281828459045), rto::Ratio<long>::fromReal(2.718281828459045));
+	ASSERT_EQ(rto::threadCacheStatistics().sharedHits, 1u);
+	ASSERT_EQ(rto::threadCacheStatistics().misses, 0u);
+	/// the counters of the exited thread are kept
+	ASSERT_EQ(rto::cacheStatistics().misses, 1u);
+	ASSERT_EQ(rto::cacheStatistics().lookups(), 2u);
+}
+
+TEST (RatioCache, threads) {
+	/// many threads converting the same values at once
+	std::vector<double> reals;
+	for(int i=1; i<=200; ++i) {reals.push_back(1.0 / i);}
+	std::vector<std::thread> threads;
+	std::vector<int> errors(4, 0);
+	for(int t=0; t<4; ++t) {
+		threads.emplace_back([&reals, &errors, t]() {
+			for(int pass=0; pass<50; ++pass) {
+				for(const double real : reals) {
+					if(rto::cachedFromReal<int>(real, 100000) != rto::Ratio<int>::fromReal(real, 100000)) {++errors[t];}
+				}
+			}
+		});
+	}
+	for(std::thread &thread : threads) {thread.join();}
+	for(const int error : errors) {ASSERT_EQ(error, 0);}
+}
+
+TEST (RatioCache, memory) {
+	/// bounded : the shared tier and one local tier per thread
+	ASSERT_EQ(rto::cacheMemoryBytes<int>(2) - rto::cacheMemoryBytes<int>(1), rto::cache::localSize * sizeof(rto::cache::LocalTier<int>::Entry));
+	ASSERT_LE(rto::cacheMemoryBytes<long long>(1), std::size_t(1) << 20);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#include "RatioCharConv.hpp"
+
+
+/////////////////////////////////////////////////////
+// helpers
+
+template <typename R>
+static std::string format(const R &rat, rto::CharsFormat format = rto::CharsFormat::Fraction) {
+	char buffer[rto::maxChars<typename R::value_type>];
+	const std::to_chars_result result = rto::to_chars(buffer, buffer + sizeof(buffer), rat, format);
+	EXPECT_EQ(result.ec, std::errc());
+	return std::string(buffer, result.ptr);
+}
+
+/// parse the whole string
+template <typename T>
+static rto::Ratio<T> parse(const std::string &text) {
+	rto::Ratio<T> rat;
+	const std::from_chars_result result = rto::from_chars(text.data(), text.data() + text.size(), rat);
+	EXPECT_EQ(result.ec, std::errc()) << text;
+	EXPECT_EQ(result.ptr, text.data() + text.size()) << text;
+	return rat;
+}
+
+template <typename T>
+static std::errc parseError(const std::string &text) {
+	rto::Ratio<T> rat(7, 3);
+	const std::from_chars_result result = rto::from_chars(text.data(), text.data() + text.size(), rat);
+	EXPECT_EQ(rat, rto::Ratio<T>(7, 3)) << text;
+	return result.ec;
+}
+
+/////////////////////////////////////////////////////
+// to_chars
+
+TEST (RatioCharConv, toChars) {
+	ASSERT_EQ(format(rto::Ratio<int>(-3, 4)), "-3/4");
+	ASSERT_EQ(format(rto::Ratio<int>(5)), "5/1");
+	ASSERT_EQ(format(rto::Ratio<int>(5), rto::CharsFormat::Compact), "5");
+	ASSERT_EQ(format(rto::Ratio<int>(1, 3), rto::CharsFormat::Parenthesized), "(1/3)");
+	ASSERT_EQ(format(rto::Ratio<long long>(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()), rto::CharsFormat::Parenthesized),
+	          "(-9223372036854775808/9223372036854775807)");
+
+	// Deferred ratios are written reduced
+	using D = rto::Ratio<int, rto::Deferred>;
+	ASSERT_EQ(format(D(1, 4) + D(1, 4)), "1/2");
+
+	char small[4];
+	ASSERT_EQ(rto::to_chars(small, small + sizeof(small), rto::Ratio<int>(10, 3)).ec, std::errc());
+	ASSERT_EQ(rto::to_chars(small, small + sizeof(small), rto::Ratio<int>(100, 3)).ec, std::errc::value_too_large);
+}
+
+/////////////////////////////////////////////////////
+// from_chars
+
+TEST (RatioCharConv, fromChars) {
+	ASSERT_EQ(parse<int>("42"), rto::Ratio<int>(42));
+	ASSERT_EQ(parse<int>("-6/8"), rto::Ratio<int>(-3, 4));
+	ASSERT_EQ(parse<int>("6/-8"), rto::Ratio<int>(-3, 4));
+	ASSERT_EQ(parse<int>("(1/3)"), rto::Ratio<int>(1, 3));
+	ASSERT_EQ(parse<int>("(-2)"), rto::Ratio<int>(-2));
+	ASSERT_EQ(parse<std::int8_t>("-128/1"), rto::Ratio<std::int8_t>(-128, 1));
+	ASSERT_EQ(parse<unsigned int>("4294967295/3"), rto::Ratio<unsigned int>(1431655765, 1));
+
+	// stops on the first character that is not part of the ratio
+	const std::string text = "3/4,5";
+	rto::Ratio<int> rat;
+	ASSERT_EQ(rto::from_chars(text.data(), text.data() + text.size(), rat).ptr, text.data() + 3);
+}
+
+TEST (RatioCharConv, decimals) {
+	ASSERT_EQ(parse<int>("1.25"), rto::Ratio<int>(5, 4));
+	ASSERT_EQ(parse<int>("-0.1"), rto::Ratio<int>(-1, 10));
+	ASSERT_EQ(parse<int>("3."), rto::Ratio<int>(3));
+	ASSERT_EQ(parse<int>("2.50000000000000000000000"), rto::Ratio<int>(5, 2));
+	ASSERT_EQ(parse<int>("2.5e-3"), rto::Ratio<int>(1, 400));
+	ASSERT_EQ(parse<int>("1.5E+3"), rto::Ratio<int>(1500));
+	ASSERT_EQ(parse<int>("7e2"), rto::Ratio<int>(700));
+	ASSERT_EQ(parse<long>("0.333333333333333333"), rto::Ratio<long>(333333333333333333L, 1000000000000000000L));
+	ASSERT_EQ(parse<int>("0e99999999999"), rto::Ratio<int>(0));
+}
+
+TEST (RatioCharConv, errors) {
+	ASSERT_EQ(parseError<int>(""), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>("x"), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>("1/0"), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>("1/x"), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>("(1/2"), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>("(1.5)"), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>(" 1"), std::errc::invalid_argument);
+	ASSERT_EQ(parseError<int>("2147483648"), std::errc::result_out_of_range);
+	ASSERT_EQ(parseError<int>("1/2147483648"), std::errc::result_out_of_range);
+	ASSERT_EQ(parseError<int>("0.0000000001"), std::errc::result_out_of_range);
+	ASSERT_EQ(parseError<int>("1e10"), std::errc::result_out_of_range);
+	ASSERT_EQ(parseError<unsigned int>("-1"), std::errc::result_out_of_range);
+}
+
+/// every ratio written by to_chars is read back by from_chars
+
+TEST (RatioCharConv, roundTrip) {
+	for(int n=-50; n<=50; n+=7) {
+		for(int d=1; d<=40; d+=3) {
+			for(rto::CharsFormat format : {rto::CharsFormat::Fraction, rto::CharsFormat::Compact, rto::CharsFormat::Parenthesized}) {
+				ASSERT_EQ(parse<int>(::format(rto::Ratio<int>(n, d), format)), rto::Ratio<int>(n, d));
+			}
+		}
+	}
+}
+
+/////////////////////////////////////////////////////
+// from_chars_column
+
+TEST (RatioCharConv, column) {
+	const std::string csv = "a, 1/2 ,x\r\nb,-0.75,y\n\nc,(3/9)\nd,4";
+	rto::RatioArray<int> values;
+	const std::from_chars_result result = rto::from_chars_column(csv.data(), csv.data() + csv.size(), 1, values);
+	ASSERT_EQ(result.ec, std::errc());
+	ASSERT_EQ(values.size(), 4u);
+	ASSERT_EQ(values[0], rto::Ratio<int>(1, 2));
+	ASSERT_EQ(values[1], rto::Ratio<int>(-3, 4));
+	ASSERT_EQ(values[2], rto::Ratio<int>(1, 3));
+	ASSERT_EQ(values[3], rto::Ratio<int>(4));
+
+	const std::string bad = "1;2\n3;4x\n";
+	rto::RatioArray<int> column;
+	const std::from_chars_result error = rto::from_chars_column(bad.data(), bad.data() + bad.size(), 1, column, ';');
+	ASSERT_EQ(error.ec, std::errc::invalid_argument);
+	ASSERT_EQ(error.ptr, bad.data() + 6);
+	ASSERT_EQ(column.size(), 1u);
+	ASSERT_EQ(rto::from_chars_column(bad.data(), bad.data() + bad.size(), 2, column, ';').ec, std::errc::invalid_argument);
+}
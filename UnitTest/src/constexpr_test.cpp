@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "Ratio.hpp"
+#include "RatioCharConv.hpp"
+
+
+/////////////////////////////////////////////////////
+// everything below is checked by the compiler
+
+using R = rto::Ratio<int>;
+using L = rto::Ratio<long long>;
+
+/// construction
+static_assert(R().numerator() == 0 && R().denominator() == 1);
+static_assert(R(6, 8).numerator() == 3 && R(6, 8).denominator() == 4);
+static_assert(R(R(2, 4)) == R(1, 2));
+
+/// real to ratio
+static_assert(R(0.75) == R(3, 4));
+static_assert(R(0.1) == R(1, 10));
+static_assert(L(-2.5) == L(-5, 2));
+static_assert(R(7) == R(7, 1));
+static_assert(R::fromReal(3.14159265358979323846, 113) == R(355, 113));
+static_assert(R::fromReal(3.14159265358979323846, 1000, 1e-2) == R(22, 7));
+static_assert(R(1e20) == R(2147483647, 1));
+
+/// arithmetic
+static_assert(R(1, 2) + R(1, 3) == R(5, 6));
+static_assert(R(1, 2) - R(1, 3) == R(1, 6));
+static_assert(R(2, 3) * R(9, 4) == R(3, 2));
+static_assert(R(2, 3) / R(4, 9) == R(3, 2));
+static_assert(-R(1, 2) == R(-1, 2));
+static_assert(R(1, 2) * 3 == R(3, 2));
+static_assert(L(1, 3) + 1 == L(4, 3));
+
+/// policies
+using D = rto::Ratio<int, rto::Deferred>;
+using C = rto::Ratio<int, rto::Eager, rto::Checked>;
+using W = rto::Ratio<int, rto::Eager, rto::Widen>;
+static_assert(D(1, 2) + D(1, 2) == D(1));
+static_assert(C(1, 2) * C(2, 3) == C(1, 3));
+static_assert(W(1, 6) + W(1, 3) == W(1, 2));
+
+/// comparisons
+static_assert(R(1, 3) < R(1, 2));
+static_assert(R(-1, 2) <= R(1, -3));
+static_assert(L(1000000007, 3) > L(1000000006, 3));
+static_assert(R(2, 4) != R(1, 3));
+
+/// math on integers
+static_assert(abs(R(-1, 2)) == R(1, 2));
+static_assert(floor(R(7, 2)) == R(3));
+static_assert(pow(R(2, 3), 3) == R(8, 27));
+static_assert(pow(R(2, 3), -2) == R(9, 4));
+static_assert(sqrt(L(9, 4)) == L(3, 2));
+static_assert(sqrt(R(2), 100) == R(140, 99));
+
+/// formatting
+constexpr std::array<char, rto::maxChars<int>> format(const R &rat, rto::CharsFormat charsFormat) {
+	std::array<char, rto::maxChars<int>> text{};
+	rto::to_chars(text.data(), text.data() + text.size() - 1, rat, charsFormat);
+	return text;
+}
+
+constexpr bool equal(const std::array<char, rto::maxChars<int>> &text, const char *expected) {
+	std::size_t i = 0;
+	for(; expected[i] != '\0'; ++i) {
+		if(text[i] != expected[i]) {return false;}
+	}
+	return text[i] == '\0';
+}
+
+static_assert(equal(format(R(-3, 4), rto::CharsFormat::Fraction), "-3/4"));
+static_assert(equal(format(R(5), rto::CharsFormat::Compact), "5"));
+static_assert(equal(format(R(-2147483647, 2147483646), rto::CharsFormat::Parenthesized), "(-2147483647/2147483646)"));
+static_assert(rto::to_chars(nullptr, nullptr, R(1, 2)).ec == std::errc::value_too_large);
+
+/// tables
+constexpr auto inverses = rto::make_table<16>([](std::size_t i) {return R(1, static_cast<int>(i) + 1);});
+static_assert(inverses.size() == 16 && inverses[3] == R(1, 4) && inverses[15] == R(1, 16));
+
+/// Taylor coefficients of exp : 1/i!
+constexpr auto expCoefficients = rto::make_table<13>([](std::size_t i) {
+	R coefficient(1);
+	for(std::size_t j=2; j<=i; ++j) {coefficient = coefficient / R(static_cast<int>(j));}
+	return coefficient;
+});
+static_assert(expCoefficients[0] == R(1) && expCoefficients[5] == R(1, 120) && expCoefficients[12] == R(1, 479001600));
+
+/// a table of converted reals
+constexpr auto tenths = rto::make_table<10>([](std::size_t i) {return R(static_cast<double>(i) / 10.0);});
+static_assert(tenths[3] == R(3, 10) && tenths[5] == R(1, 2));
+
+/////////////////////////////////////////////////////
+// same results at run time
+
+TEST (RatioConstexpr, tables) {
+	for(std::size_t i=0; i<tenths.size(); ++i) {
+		const double real = static_cast<double>(i) / 10.0;
+		ASSERT_EQ(tenths[i], R(real));
+	}
+	R coefficient(1);
+	for(std::size_t i=0; i<expCoefficients.size(); ++i) {
+		if(i > 1) {coefficient = coefficient / R(static_cast<int>(i));}
+		ASSERT_EQ(expCoefficients[i], coefficient);
+	}
+}
+
+TEST (RatioConstexpr, format) {
+	/// the digits written one by one at compile time, by std::to_chars at run time
+	char buffer[rto::maxChars<int>] = {};
+	const std::to_chars_result result = rto::to_chars(buffer, buffer + sizeof(buffer), R(-2147483647, 2147483646), rto::CharsFormat::Parenthesized);
+	ASSERT_EQ(std::string(buffer, result.ptr), std::string(format(R(-2147483647, 2147483646), rto::CharsFormat::Parenthesized).data()));
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// real -> ratio conversion
+
+/// exact reals
+
+TEST (RatioConversion, exactReals) { 
+	rto::Ratio<int> half(0.5);
+	ASSERT_EQ(half.numerator(), 1);
+	ASSERT_EQ(half.denominator(), 2);
+
+	rto::Ratio<int> neg(-3.5);
+	ASSERT_EQ(neg.numerator(), -7);
+	ASSERT_EQ(neg.denominator(), 2);
+
+	rto::Ratio<int> zero(0.0);
+	ASSERT_EQ(zero.numerator(), 0);
+	ASSERT_EQ(zero.denominator(), 1);
+
+	rto::Ratio<int> integer(42);
+	ASSERT_EQ(integer.numerator(), 42);
+	ASSERT_EQ(integer.denominator(), 1);
+}
+
+/// decimal reals are recovered up to the precision of the floating-point type
+
+TEST (RatioConversion, decimalReals) { 
+	rto::Ratio<int> tenth(0.1);
+	ASSERT_EQ(tenth.numerator(), 1);
+	ASSERT_EQ(tenth.denominator(), 10);
+
+	rto::Ratio<int> third(1.0f / 3.0f);
+	ASSERT_EQ(third.numerator(), 1);
+	ASSERT_EQ(third.denominator(), 3);
+
+	rto::Ratio<std::int64_t> price(-12.34);
+	ASSERT_EQ(price.numerator(), -617);
+	ASSERT_EQ(price.denominator(), 50);
+}
+
+/// the denominator bound gives the best approximation (convergent or semiconvergent)
+
+TEST (RatioConversion, maxDenominator) { 
+	rto::Ratio<int> pi = rto::Ratio<int>::fromReal(M_PI, 1000);
+	ASSERT_EQ(pi.numerator(), 355);
+	ASSERT_EQ(pi.denominator(), 113);
+
+	pi = rto::Ratio<int>::fromReal(M_PI, 100);
+	ASSERT_EQ(pi.numerator(), 311);
+	ASSERT_EQ(pi.denominator(), 99);
+
+	pi = rto::Ratio<int>::fromReal(M_PI, 10);
+	ASSERT_EQ(pi.numerator(), 22);
+	ASSERT_EQ(pi.denominator(), 7);
+}
+
+/// the tolerance stops at the first close enough convergent
+
+TEST (RatioConversion, tolerance) { 
+	rto::Ratio<int> pi = rto::Ratio<int>::fromReal(M_PI, std::numeric_limits<int>::max(), 1e-2);
+	ASSERT_EQ(pi.numerator(), 22);
+	ASSERT_EQ(pi.denominator(), 7);
+
+	pi = rto::Ratio<int>::fromReal(M_PI, std::numeric_limits<int>::max(), 1e-6);
+	ASSERT_EQ(pi.numerator(), 355);
+	ASSERT_EQ(pi.denominator(), 113);
+}
+
+/// irrational reals : the closest ratio that fits in T
+
+TEST (RatioConversion, fitsInType) { 
+	rto::Ratio<int> sqrt2(std::sqrt(2.0));
+	ASSERT_NEAR((double)sqrt2.numerator() / sqrt2.denominator(), std::sqrt(2.0), 1e-15);
+
+	rto::Ratio<std::int16_t> small(M_PI);
+	ASSERT_EQ(small.numerator(), 355);
+	ASSERT_EQ(small.denominator(), 113);
+
+	rto::Ratio<std::int64_t> large(M_PI);
+	ASSERT_DOUBLE_EQ((double)large.numerator() / large.denominator(), M_PI);
+}
+
+/// reals out of range are clamped, NaN gives 0
+
+TEST (RatioConversion, outOfRange) { 
+	rto::Ratio<int> big(1e12);
+	ASSERT_EQ(big.numerator(), std::numeric_limits<int>::max());
+	ASSERT_EQ(big.denominator(), 1);
+
+	rto::Ratio<int> tiny(1e-12);
+	ASSERT_EQ(tiny.numerator(), 0);
+	ASSERT_EQ(tiny.denominator(), 1);
+
+	rto::Ratio<int> infinity(-std::numeric_limits<double>::infinity());
+	ASSERT_EQ(infinity.numerator(), -std::numeric_limits<int>::max());
+	ASSERT_EQ(infinity.denominator(), 1);
+
+	rto::Ratio<int> nan(std::nan(""));
+	ASSERT_EQ(nan.numerator(), 0);
+	ASSERT_EQ(nan.denominator(), 1);
+}
+
+/////////////////////////////////////////////////////
+// exact conversion of floats and doubles
+
+TEST (RatioConversion, fromExact) { 
+	rto::Ratio<int> rat = rto::Ratio<int>::fromExact(-3.5);
+	ASSERT_EQ(rat.numerator(), -7);
+	ASSERT_EQ(rat.denominator(), 2);
+
+	rat = rto::Ratio<int>::fromExact(0.375f);
+	ASSERT_EQ(rat.numerator(), 3);
+	ASSERT_EQ(rat.denominator(), 8);
+
+	rat = rto::Ratio<int>::fromExact(1048576.0);
+	ASSERT_EQ(rat.numerator(), 1048576);
+	ASSERT_EQ(rat.denominator(), 1);
+
+	rat = rto::Ratio<int>::fromExact(-0.0);
+	ASSERT_EQ(rat.numerator(), 0);
+	ASSERT_EQ(rat.denominator(), 1);
+}
+
+/// 0.1 is not 1/10 : its exact value has a power of 2 as denominator
+
+TEST (RatioConversion, fromExactDecimal) { 
+	rto::Ratio<std::int64_t> tenth = rto::Ratio<std::int64_t>::fromExact(0.1f);
+	ASSERT_EQ(tenth.numerator(), 13421773);
+	ASSERT_EQ(tenth.denominator(), std::int64_t(1) << 27);
+	ASSERT_EQ((float)tenth.numerator() / tenth.denominator(), 0.1f);
+
+	tenth = rto::Ratio<std::int64_t>::fromExact(0.1);
+	ASSERT_EQ(tenth.numerator(), 3602879701896397);
+	ASSERT_EQ(tenth.denominator(), std::int64_t(1) << 55);
+
+	ASSERT_THROW(rto::Ratio<int>::fromExact(0.1), std::overflow_error);
+	ASSERT_THROW(rto::Ratio<int>::fromExact(1e-10f), std::overflow_error);
+}
+
+TEST (RatioConversion, fromExactLimits) { 
+	rto::Ratio<int> rat = rto::Ratio<int>::fromExact(1073741824.0);
+	ASSERT_EQ(rat.numerator(), 1073741824);
+	rat = rto::Ratio<int>::fromExact(1.0 / 1073741824.0);
+	ASSERT_EQ(rat.denominator(), 1073741824);
+
+	ASSERT_THROW(rto::Ratio<int>::fromExact(2147483648.0), std::overflow_error);
+	ASSERT_THROW(rto::Ratio<int>::fromExact(1.0 / 2147483648.0), std::overflow_error);
+	ASSERT_THROW(rto::Ratio<int>::fromExact(std::numeric_limits<double>::infinity()), std::overflow_error);
+	ASSERT_THROW(rto::Ratio<int>::fromExact(std::nan("")), std::domain_error);
+	ASSERT_THROW(rto::Ratio<unsigned int>::fromExact(-1.0), std::overflow_error);
+}
+
+/// batch : the reals that do not fit are approximated and counted
+
+TEST (RatioConversion, fromExactBatch) { 
+	const double reals[] = {0.5, -2.25, 0.1, 3.0, 1e20};
+	rto::Ratio<int> result[5];
+	ASSERT_EQ(rto::Ratio<int>::fromExact(reals, 5, result), 2u);
+	ASSERT_EQ(result[0].numerator(), 1);
+	ASSERT_EQ(result[0].denominator(), 2);
+	ASSERT_EQ(result[1].numerator(), -9);
+	ASSERT_EQ(result[1].denominator(), 4);
+	ASSERT_EQ(result[2].numerator(), 1);
+	ASSERT_EQ(result[2].denominator(), 10);
+	ASSERT_EQ(result[3].numerator(), 3);
+	ASSERT_EQ(result[3].denominator(), 1);
+	ASSERT_EQ(result[4].numerator(), std::numeric_limits<int>::max());
+}
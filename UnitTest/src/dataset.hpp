@@ -0,0 +1,54 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \file dataset.hpp
+/// \brief random ratios shared by the tests: std::mt19937 is fully specified by the standard, and
+/// its output is mapped to ranges without std::uniform_int_distribution (whose results differ
+/// between standard libraries), so every platform tests the same values.
+
+namespace dataset {
+
+	/// \brief closed range of integers
+	struct Range {
+		long long min;
+		long long max;
+	};
+
+	/// \brief reproducible integer in [range.min, range.max]
+	inline long long uniform(std::mt19937 &generator, const Range &range) {
+		const std::uint64_t high = generator();
+		const std::uint64_t low = generator();
+		const std::uint64_t span = static_cast<std::uint64_t>(range.max - range.min) + 1;
+		return range.min + static_cast<long long>(((high << 32) | low) % span);
+	}
+
+	/// \brief ratios with a numerator in numerators and a denominator in denominators (0 becomes 1)
+	/// \param normalize : build them irreducible, or store them as drawn
+	template <typename T>
+	std::vector<rto::Ratio<T>> ratios(std::size_t size, const Range &numerators, const Range &denominators, unsigned int seed, bool normalize = true) {
+		std::mt19937 generator(seed);
+		std::vector<rto::Ratio<T>> result;
+		result.reserve(size);
+		for(std::size_t i=0; i<size; ++i) {
+			const T numerator = static_cast<T>(uniform(generator, numerators));
+			T denominator = static_cast<T>(uniform(generator, denominators));
+			if(denominator == T(0)) {denominator = T(1);}
+			if(normalize) {
+				result.push_back(rto::Ratio<T>(numerator, denominator));
+			} else {
+				rto::Ratio<T> rat;
+				rat.numerator() = numerator;
+				rat.denominator() = denominator;
+				result.push_back(rat);
+			}
+		}
+		return result;
+	}
+}
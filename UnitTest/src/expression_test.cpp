@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// Fused : expression templates
+
+TEST (RatioFused, operatorsBuildNodes) { 
+	rto::Ratio<int, rto::Fused> a(1, 2);
+	rto::Ratio<int, rto::Fused> b(2, 3);
+	auto expression = a * b + a;
+	ASSERT_FALSE((std::is_same_v<decltype(expression), rto::Ratio<int, rto::Fused>>));
+
+	rto::Ratio<int, rto::Fused> res = expression;
+	ASSERT_EQ(res.numerator(), 5);
+	ASSERT_EQ(res.denominator(), 6);
+
+	// direct initialization from an expression
+	rto::Ratio<int, rto::Fused> direct(a * b + a);
+	rto::Ratio<int, rto::Fused> braces{a * b + 1};
+	ASSERT_EQ(direct, res);
+	ASSERT_EQ(braces.numerator(), 4);
+	ASSERT_EQ(braces.denominator(), 3);
+}
+
+TEST (RatioFused, sameResultAsEager) { 
+	rto::Ratio<int> a(5, 2), b(7, 3), c(-1, 6), d(4, 9), e(3, 4);
+	rto::Ratio<int> eager = a*b + c*d - e;
+
+	rto::Ratio<int, rto::Fused> fa(5, 2), fb(7, 3), fc(-1, 6), fd(4, 9), fe(3, 4);
+	rto::Ratio<int, rto::Fused> fused = fa*fb + fc*fd - fe;
+	ASSERT_EQ(fused.numerator(), eager.numerator());
+	ASSERT_EQ(fused.denominator(), eager.denominator());
+
+	rto::Ratio<int, rto::Fused> quotient = (fa - fb) / (fc + fe);
+	rto::Ratio<int> eagerQuotient = (a - b) / (c + e);
+	ASSERT_EQ(quotient.numerator(), eagerQuotient.numerator());
+	ASSERT_EQ(quotient.denominator(), eagerQuotient.denominator());
+}
+
+TEST (RatioFused, numbersAndUnaryMinus) { 
+	rto::Ratio<int, rto::Fused> a(1, 2);
+	rto::Ratio<int, rto::Fused> res = -(a * a + 1) * 2;
+	ASSERT_EQ(res.numerator(), -5);
+	ASSERT_EQ(res.denominator(), 2);
+}
+
+/// the sums are computed on the least common denominator
+
+TEST (RatioFused, commonDenominator) { 
+	rto::Ratio<int> x(1, 360), y(1, 720), z(1, 1080), w(1, 1440);
+	rto::Ratio<int> eager = x + y + z + w - x;
+
+	rto::Ratio<int, rto::Fused> fx(1, 360), fy(1, 720), fz(1, 1080), fw(1, 1440);
+	rto::Ratio<int, rto::Fused> fused = fx + fy + fz + fw - fx;
+	ASSERT_EQ(eager.numerator(), 13);
+	ASSERT_EQ(eager.denominator(), 4320);
+	ASSERT_EQ(fused.numerator(), eager.numerator());
+	ASSERT_EQ(fused.denominator(), eager.denominator());
+}
+
+/// the nodes follow the overflow policy
+
+TEST (RatioFused, overflowPolicy) { 
+	using C = rto::Ratio<int, rto::Fused, rto::Checked>;
+	ASSERT_THROW(C checked = C(1, 50000) * C(1, 50001), std::overflow_error);
+
+	using W = rto::Ratio<int, rto::Fused, rto::Widen>;
+	const W product = W(50000, 50001) * W(50001, 50003);
+	ASSERT_EQ(product.numerator(), 50000);
+	ASSERT_EQ(product.denominator(), 50003);
+	ASSERT_THROW(W widened = W(1, 50000) * W(1, 50001), std::overflow_error);
+
+	// nested nodes : 4e18 * 4e18 overflows the wide type itself
+	const W x(2000000000), y(2000000000);
+	ASSERT_THROW(W nested = (x * y) * (x * y), std::overflow_error);
+
+	using S = rto::Ratio<int, rto::Fused, rto::Saturate>;
+	const S sx(2000000000), sy(2000000000);
+	const S saturated = (sx * sy) * (sx * sy);
+	ASSERT_EQ(saturated.numerator(), std::numeric_limits<int>::max());
+	ASSERT_EQ(saturated.denominator(), 1);
+	const S negative = (sx * sy) * (-sx * sy);
+	ASSERT_EQ(negative.numerator(), -std::numeric_limits<int>::max());
+	ASSERT_EQ(negative.denominator(), 1);
+}
+
+/////////////////////////////////////////////////////
+// Deferred : normalization skipped in the operators
+
+TEST (RatioDeferred, accumulation) { 
+	rto::Ratio<long, rto::Deferred> sum;
+	rto::Ratio<long> eagerSum;
+	for(long i=1; i<=40; ++i) {
+		sum = sum + rto::Ratio<long, rto::Deferred>(1, i % 7 + 1);
+		eagerSum = eagerSum + rto::Ratio<long>(1, i % 7 + 1);
+	}
+	sum.irreducible();
+	ASSERT_EQ(sum.numerator(), eagerSum.numerator());
+	ASSERT_EQ(sum.denominator(), eagerSum.denominator());
+}
+
+TEST (RatioDeferred, equality) { 
+	rto::Ratio<int, rto::Deferred> a(1, 2);
+	rto::Ratio<int, rto::Deferred> b = a + a;
+	ASSERT_EQ(b.denominator(), 4);
+	ASSERT_TRUE((b == rto::Ratio<int, rto::Deferred>(1, 1)));
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "RatioFixed.hpp"
+
+
+using Cents = rto::FixedRatio<int, 100>;
+using Q10 = rto::FixedRatio<int, 1024>;
+
+/////////////////////////////////////////////////////
+// conversions
+
+TEST (FixedRatio, conversions) {
+	ASSERT_EQ(Cents(3).numerator(), 300);
+	ASSERT_EQ(Cents::denominator(), 100);
+	ASSERT_EQ(Cents(rto::Ratio<int>(1, 4)).numerator(), 25);
+	ASSERT_EQ(Cents(rto::Ratio<int>(-7, 4)).numerator(), -175);
+	/// rounded to the nearest, ties upward
+	ASSERT_EQ(Cents(rto::Ratio<int>(1, 3)).numerator(), 33);
+	ASSERT_EQ(Cents(rto::Ratio<int>(2, 3)).numerator(), 67);
+	ASSERT_EQ(Cents(rto::Ratio<int>(-2, 3)).numerator(), -67);
+	ASSERT_EQ(Cents(rto::Ratio<int>(1, 200)).numerator(), 1);
+	ASSERT_EQ(Cents(rto::Ratio<int>(-1, 200)).numerator(), 0);
+
+	/// back to an irreducible Ratio
+	ASSERT_EQ(Cents::fromNumerator(250).toRatio(), rto::Ratio<int>(5, 2));
+	ASSERT_EQ(Q10::fromNumerator(-512).toRatio(), rto::Ratio<int>(-1, 2));
+	ASSERT_DOUBLE_EQ(Q10::fromNumerator(256).toReal(), 0.25);
+}
+
+/////////////////////////////////////////////////////
+// arithmetic
+
+TEST (FixedRatio, addSub) {
+	const Cents a = Cents::fromNumerator(1999), b = Cents::fromNumerator(-250);
+	ASSERT_EQ((a + b).numerator(), 1749);
+	ASSERT_EQ((a - b).numerator(), 2249);
+	ASSERT_EQ((-a).numerator(), -1999);
+	Cents total;
+	for(int i=0; i<10; ++i) {total += Cents(rto::Ratio<int>(1, 10));}
+	ASSERT_EQ(total, Cents(1));
+}
+
+TEST (FixedRatio, mulDiv) {
+	/// 1.5 * 2.25 = 3.375 -> 3.38 (rounded up), 1.5 / 4 = 0.375 -> 0.38
+	ASSERT_EQ((Cents::fromNumerator(150) * Cents::fromNumerator(225)).numerator(), 338);
+	ASSERT_EQ((Cents::fromNumerator(-150) * Cents::fromNumerator(225)).numerator(), -337);
+	ASSERT_EQ((Cents::fromNumerator(150) / Cents(4)).numerator(), 38);
+	ASSERT_EQ((Cents::fromNumerator(150) / Cents(-4)).numerator(), -37);
+	ASSERT_EQ((Cents(1) / Cents(3)).numerator(), 33);
+	ASSERT_EQ((Cents::fromNumerator(125) * 3).numerator(), 375);
+
+	/// power of two : a shift
+	ASSERT_EQ((Q10::fromNumerator(1536) * Q10::fromNumerator(-512)).numerator(), -768);
+	ASSERT_EQ((Q10::fromNumerator(1) * Q10::fromNumerator(512)).numerator(), 1);
+	ASSERT_EQ((Q10::fromNumerator(-1) * Q10::fromNumerator(512)).numerator(), 0);
+	ASSERT_EQ((Q10::fromNumerator(-3) * Q10::fromNumerator(512)).numerator(), -1);
+
+	/// the product does not overflow before the rescale
+	const Cents large = Cents(1000000);
+	ASSERT_EQ((large * Cents::fromNumerator(50)).numerator(), 50000000);
+	using Micro = rto::FixedRatio<std::int64_t, 1000000>;
+	ASSERT_EQ((Micro(1000000000) * Micro(3)).numerator(), 3000000000000000LL);
+}
+
+TEST (FixedRatio, matchesRatio) {
+	/// every product is the exact one, rounded
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<int> distrib(-100000, 100000);
+	for(int i=0; i<1000; ++i) {
+		const Q10 a = Q10::fromNumerator(distrib(generator)), b = Q10::fromNumerator(distrib(generator));
+		const rto::Ratio<long long> exact = rto::Ratio<long long>(a.numerator(), 1024) * rto::Ratio<long long>(b.numerator(), 1024);
+		ASSERT_EQ((a * b).numerator(), (rto::FixedRatio<long long, 1024>(exact).numerator())) << a << " " << b;
+		ASSERT_EQ(a < b, a.toRatio() < b.toRatio());
+	}
+}
+
+/////////////////////////////////////////////////////
+// batch kernels
+
+TEST (FixedRatio, batch) {
+	std::vector<Cents> a, b, result;
+	for(int i=0; i<100; ++i) {
+		a.push_back(Cents::fromNumerator(i * 7 - 300));
+		b.push_back(Cents::fromNumerator(i * 13 + 1));
+	}
+	rto::add(a, b, result);
+	for(std::size_t i=0; i<a.size(); ++i) {ASSERT_EQ(result[i], a[i] + b[i]);}
+	rto::sub(a, b, result);
+	for(std::size_t i=0; i<a.size(); ++i) {ASSERT_EQ(result[i], a[i] - b[i]);}
+	rto::mul(a, b, result);
+	for(std::size_t i=0; i<a.size(); ++i) {ASSERT_EQ(result[i], a[i] * b[i]);}
+	rto::mul(a, Cents(2), result);
+	for(std::size_t i=0; i<a.size(); ++i) {ASSERT_EQ(result[i], a[i] * 2);}
+
+	Cents total;
+	for(const Cents &value : a) {total += value;}
+	ASSERT_EQ(rto::sum(a), total);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// backends (compared with std::gcd)
+
+template <typename Backend, typename T>
+void checkBackend(unsigned int seed) {
+	std::mt19937_64 generator(seed);
+	std::uniform_int_distribution<T> distrib(std::numeric_limits<T>::min() / 2, std::numeric_limits<T>::max() / 2);
+	std::uniform_int_distribution<T> factor(1, 1000);
+	for(int i=0; i<2000; ++i) {
+		const T g = factor(generator);
+		const T a = distrib(generator) / g * g;
+		const T b = distrib(generator) / g * g;
+		ASSERT_EQ(Backend::compute(a, b), std::gcd(a, b));
+	}
+	ASSERT_EQ(Backend::compute(T(0), T(0)), T(0));
+	ASSERT_EQ(Backend::compute(T(0), T(-12)), T(12));
+	ASSERT_EQ(Backend::compute(T(18), T(0)), T(18));
+}
+
+TEST (gcd, euclid) { 
+	checkBackend<rto::EuclidGcd, std::int32_t>(1);
+	checkBackend<rto::EuclidGcd, std::int64_t>(2);
+}
+
+TEST (gcd, binary) { 
+	checkBackend<rto::BinaryGcd, std::int32_t>(1);
+	checkBackend<rto::BinaryGcd, std::int64_t>(2);
+}
+
+TEST (gcd, lehmer) { 
+	checkBackend<rto::LehmerGcd, std::int32_t>(1);
+	checkBackend<rto::LehmerGcd, std::int64_t>(2);
+
+	// consecutive Fibonacci numbers : worst case of Euclid
+	std::uint64_t a = 1, b = 1;
+	for(int i=0; i<80; ++i) {
+		const std::uint64_t c = a + b;
+		a = b;
+		b = c;
+	}
+	ASSERT_EQ(rto::LehmerGcd::compute(b, a), 1u);
+	ASSERT_EQ(rto::LehmerGcd::compute(b * 6, a * 6), 6u);
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST (gcd, int128) { 
+	using rto::overflow::int128;
+	std::mt19937_64 generator(3);
+	for(int i=0; i<500; ++i) {
+		const int128 g = generator() % 100000 + 1;
+		const int128 a = (int128(generator() >> 20) << 60 | generator() >> 4) * g;
+		const int128 b = (int128(generator() >> 20) << 60 | generator() >> 4) * g;
+		const int128 expected = rto::EuclidGcd::compute(a, b);
+		ASSERT_TRUE(rto::BinaryGcd::compute(a, b) == expected);
+		ASSERT_TRUE(rto::LehmerGcd::compute(a, -b) == expected);
+	}
+}
+#endif
+
+/////////////////////////////////////////////////////
+// batched
+
+TEST (gcd, batch) { 
+	std::vector<int> a, b;
+	for(int i=-50; i<50; ++i) {
+		a.push_back(i * 12);
+		b.push_back(i * i * 18 + 6);
+	}
+	std::vector<int> result(a.size());
+	rto::gcd(a.data(), b.data(), result.data(), a.size());
+	for(std::size_t i=0; i<a.size(); ++i) {
+		ASSERT_EQ(result[i], std::gcd(a[i], b[i]));
+	}
+}
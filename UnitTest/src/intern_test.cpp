@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "RatioIntern.hpp"
+
+
+/////////////////////////////////////////////////////
+// std::hash
+
+TEST (RatioHash, consistentWithEquality) {
+	const std::hash<rto::Ratio<int>> hash;
+	ASSERT_EQ(hash(rto::Ratio<int>(1, 2)), hash(rto::Ratio<int>(2, 4)));
+	ASSERT_EQ(hash(rto::Ratio<int>(1, -2)), hash(rto::Ratio<int>(-1, 2)));
+	ASSERT_NE(hash(rto::Ratio<int>(1, 2)), hash(rto::Ratio<int>(2, 1)));
+	ASSERT_NE(hash(rto::Ratio<int>(1, 2)), hash(rto::Ratio<int>(-1, 2)));
+
+	/// Deferred ratios are hashed reduced
+	using D = rto::Ratio<int, rto::Deferred>;
+	ASSERT_EQ(std::hash<D>()(D(1, 4) + D(1, 4)), std::hash<D>()(D(1, 2)));
+
+	const std::hash<rto::Ratio<long long>> hash64;
+	ASSERT_EQ(hash64(rto::Ratio<long long>(3, 9)), hash64(rto::Ratio<long long>(1, 3)));
+}
+
+TEST (RatioHash, unorderedContainers) {
+	std::unordered_map<rto::Ratio<long>, int> counts;
+	for(int i=1; i<=100; ++i) {
+		++counts[rto::Ratio<long>(i % 7, 7)];
+	}
+	ASSERT_EQ(counts.size(), 7u);
+	ASSERT_EQ(counts[rto::Ratio<long>(0)], 14);
+	ASSERT_EQ(counts[rto::Ratio<long>(2, 7)], 15);
+
+	/// no collision on 32-bit ratios (the mix is a bijection on 64 bits)
+	std::unordered_set<std::size_t> hashes;
+	for(int n=-100; n<=100; ++n) {
+		for(int d=1; d<=100; ++d) {
+			hashes.insert(std::hash<rto::Ratio<int>>()(rto::Ratio<int>(n, d) * rto::Ratio<int>(1000)));
+		}
+	}
+	std::unordered_set<rto::Ratio<int>> values;
+	for(int n=-100; n<=100; ++n) {
+		for(int d=1; d<=100; ++d) {
+			values.insert(rto::Ratio<int>(n, d) * rto::Ratio<int>(1000));
+		}
+	}
+	ASSERT_EQ(hashes.size(), values.size());
+}
+
+/////////////////////////////////////////////////////
+// RatioInternTable
+
+TEST (RatioInternTable, denseIds) {
+	rto::RatioInternTable<long> table;
+	ASSERT_EQ(table.intern(rto::Ratio<long>(1, 2)), 0u);
+	ASSERT_EQ(table.intern(rto::Ratio<long>(3, 4)), 1u);
+	ASSERT_EQ(table.intern(rto::Ratio<long>(2, 4)), 0u);
+	ASSERT_EQ(table.intern(rto::Ratio<long>(-1, -2)), 0u);
+	ASSERT_EQ(table.intern(rto::Ratio<long>(1, -2)), 2u);
+	ASSERT_EQ(table.intern(rto::Ratio<long>(-1, 2)), 2u);
+	ASSERT_EQ(table.size(), 3u);
+
+	/// values in canonical form
+	ASSERT_EQ(table[2].numerator(), -1);
+	ASSERT_EQ(table[2].denominator(), 2);
+	ASSERT_EQ(table[1], rto::Ratio<long>(3, 4));
+
+	ASSERT_EQ(table.find(rto::Ratio<long>(6, 8)), 1u);
+	ASSERT_EQ(table.find(rto::Ratio<long>(5, 8)), rto::RatioInternTable<long>::invalid);
+	ASSERT_EQ(table.size(), 3u);
+}
+
+TEST (RatioInternTable, growth) {
+	/// ids survive the rehashes
+	rto::RatioInternTable<int> table;
+	std::vector<rto::Ratio<int>> values;
+	for(int n=0; n<200; ++n) {
+		for(int d=1; d<=50; ++d) {values.push_back(rto::Ratio<int>(n, d));}
+	}
+	const std::vector<std::uint32_t> ids = table.intern(values);
+	ASSERT_EQ(ids.size(), values.size());
+	for(std::size_t i=0; i<values.size(); ++i) {
+		ASSERT_EQ(table[ids[i]], values[i]);
+		ASSERT_EQ(table.find(values[i]), ids[i]);
+	}
+	std::unordered_set<rto::Ratio<int>> distinct(values.begin(), values.end());
+	ASSERT_EQ(table.size(), distinct.size());
+	ASSERT_LE(table.memoryBytes(), distinct.size() * (2 * sizeof(int) + 4 * sizeof(std::uint64_t)));
+
+	/// batch intern of a RatioArray, same ids
+	const rto::RatioArray<int> array(values);
+	ASSERT_EQ(table.intern(array), ids);
+	ASSERT_EQ(table.size(), distinct.size());
+}
+
+TEST (RatioInternTable, concurrentReaders) {
+	rto::RatioInternTable<int> table(1024);
+	for(int n=0; n<1000; ++n) {table.intern(rto::Ratio<int>(n, 3));}
+
+	/// readers look up the first values while a writer keeps interning new ones
+	std::atomic<int> errors(0);
+	std::thread writer([&table]() {
+		for(int n=1000; n<20000; ++n) {table.intern(rto::Ratio<int>(n, 3));}
+	});
+	std::vector<std::thread> readers;
+	for(int t=0; t<3; ++t) {
+		readers.emplace_back([&table, &errors, t]() {
+			for(int round=0; round<20; ++round) {
+				for(int n=t; n<1000; n+=3) {
+					const std::uint32_t id = table.find(rto::Ratio<int>(n, 3));
+					if(id == rto::RatioInternTable<int>::invalid || table[id] != rto::Ratio<int>(n, 3)) {++errors;}
+				}
+			}
+		});
+	}
+	writer.join();
+	for(std::thread &reader : readers) {reader.join();}
+	ASSERT_EQ(errors.load(), 0);
+	ASSERT_EQ(table.size(), 20000u);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include "RatioMath.hpp"
+
+
+/////////////////////////////////////////////////////
+// helpers
+
+template <typename R>
+static long double value(const R &rat) {
+	return static_cast<long double>(rat.numerator()) / static_cast<long double>(rat.denominator());
+}
+
+/// random ratios in [-max, max] with denominators up to 1000
+static std::vector<rto::Ratio<long long>> arguments(long long max, unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<long long> denominators(1, 1000);
+	std::vector<rto::Ratio<long long>> result;
+	for(int i=0; i<200; ++i) {
+		const long long denominator = denominators(generator);
+		std::uniform_int_distribution<long long> numerators(-max * denominator, max * denominator);
+		result.push_back(rto::Ratio<long long>(numerators(generator), denominator));
+	}
+	return result;
+}
+
+/////////////////////////////////////////////////////
+// tolerance
+
+TEST (RatioMath, sinCosTolerance) {
+	for(const double tolerance : {1e-3, 1e-9, 1e-15}) {
+		for(const rto::Ratio<long long> &x : arguments(100, 1)) {
+			ASSERT_LE(std::abs(value(rto::sin(x, tolerance)) - std::sin(value(x))), tolerance) << x << " " << tolerance;
+			ASSERT_LE(std::abs(value(rto::cos(x, tolerance)) - std::cos(value(x))), tolerance) << x << " " << tolerance;
+		}
+	}
+}
+
+TEST (RatioMath, tanTolerance) {
+	for(const double tolerance : {1e-3, 1e-9, 1e-13}) {
+		for(const rto::Ratio<long long> &x : arguments(1, 2)) {
+			ASSERT_LE(std::abs(value(rto::tan(x, tolerance)) - std::tan(value(x))), tolerance) << x << " " << tolerance;
+		}
+	}
+}
+
+TEST (RatioMath, expTolerance) {
+	for(const double tolerance : {1e-3, 1e-9, 1e-14}) {
+		for(const rto::Ratio<long long> &x : arguments(5, 3)) {
+			ASSERT_LE(std::abs(value(rto::exp(x, tolerance)) - std::exp(value(x))), tolerance * std::exp(5.0)) << x << " " << tolerance;
+			// absolute error as long as exp(x) stays small
+			if(x < rto::Ratio<long long>(1)) {
+				ASSERT_LE(std::abs(value(rto::exp(x, tolerance)) - std::exp(value(x))), tolerance) << x << " " << tolerance;
+			}
+		}
+	}
+}
+
+TEST (RatioMath, logTolerance) {
+	for(const double tolerance : {1e-3, 1e-9, 1e-15}) {
+		for(const rto::Ratio<long long> &x : arguments(1000, 4)) {
+			if(x <= rto::Ratio<long long>(0)) {continue;}
+			ASSERT_LE(std::abs(value(rto::log(x, tolerance)) - std::log(value(x))), tolerance) << x << " " << tolerance;
+		}
+	}
+}
+
+TEST (RatioMath, convergents) {
+	/// the first convergents of pi/2, e and log 2
+	using R = rto::Ratio<long long>;
+	ASSERT_EQ(rto::sin(R(1), 1e-2), R(5, 6));
+	ASSERT_EQ(rto::exp(R(1), 1e-3), R(87, 32));
+	ASSERT_EQ(rto::exp(R(1), 1e-1), R(8, 3));
+	ASSERT_EQ(rto::log(R(2), 1e-2), R(7, 10));
+
+	/// exact values
+	ASSERT_EQ(rto::sin(R(0), 1e-15), R(0));
+	ASSERT_EQ(rto::cos(R(0), 1e-15), R(1));
+	ASSERT_EQ(rto::exp(R(0), 1e-15), R(1));
+	ASSERT_EQ(rto::log(R(1), 1e-15), R(0));
+	ASSERT_EQ(rto::log(R(-8, -8), 1e-15), R(0));
+
+	/// found by ADL, next to the one argument versions
+	ASSERT_EQ(sin(R(1), 1e-2), R(5, 6));
+}
+
+TEST (RatioMath, largeArguments) {
+	/// the reduction by pi/2 stays exact on large arguments
+	using R = rto::Ratio<long long>;
+	const long long large = 1000000000000000000LL;
+	ASSERT_NEAR(static_cast<double>(value(rto::sin(R(large), 1e-12))), -0.9929693207404051, 1e-12);
+	ASSERT_NEAR(static_cast<double>(value(rto::cos(R(large), 1e-12))), 0.11837199021871073, 1e-12);
+	ASSERT_NEAR(static_cast<double>(value(rto::log(R(large), 1e-12))), 41.44653167389282, 1e-12);
+	ASSERT_NEAR(static_cast<double>(value(rto::log(R(1, large), 1e-12))), -41.44653167389282, 1e-12);
+	ASSERT_EQ(rto::exp(R(-large), 1e-12), R(0));
+}
+
+/////////////////////////////////////////////////////
+// denominator bound
+
+TEST (RatioMath, maxDenominator) {
+	using R = rto::Ratio<long long>;
+	/// best approximations of e with a bounded denominator : 19/7, 87/32, 193/71
+	ASSERT_EQ(rto::exp(R(1), 0.0, 7LL), R(19, 7));
+	ASSERT_EQ(rto::exp(R(1), 0.0, 32LL), R(87, 32));
+	ASSERT_EQ(rto::exp(R(1), 0.0, 80LL), R(193, 71));
+	/// sines with bounded denominators
+	for(const long long bound : {10LL, 100LL, 1000LL, 1000000LL}) {
+		for(const rto::Ratio<long long> &x : arguments(10, 5)) {
+			const R result = rto::sin(x, 0.0, bound);
+			ASSERT_LE(result.denominator(), bound);
+			ASSERT_GT(result.denominator(), 0);
+			/// n/d and its Farey neighbour e/f (d + f > bound) enclose sin(x) : the error is below 1/(d (bound + 1 - d))
+			const long double denominator = static_cast<long double>(result.denominator());
+			ASSERT_LE(std::abs(value(result) - std::sin(value(x))), 1.0L / (denominator * (bound + 1 - denominator)) + 1e-15L) << x;
+		}
+	}
+	/// the bound is converted to the integer type (an int literal with long long ratios)
+	ASSERT_EQ(rto::exp(R(1), 0.0, 7), R(19, 7));
+	ASSERT_LE(rto::sin(R(1), 0.0, 1000).denominator(), 1000);
+	/// int ratios
+	const rto::Ratio<int> half = rto::log(rto::Ratio<int>(3, 2), 0.0, 1000);
+	ASSERT_LE(half.denominator(), 1000);
+	ASSERT_NEAR(value(half), std::log(1.5), 1e-6);
+}
+
+/////////////////////////////////////////////////////
+// errors
+
+TEST (RatioMath, errors) {
+	using R = rto::Ratio<int>;
+	ASSERT_THROW(rto::log(R(0), 1e-6), std::domain_error);
+	ASSERT_THROW(rto::log(R(-1, 2), 1e-6), std::domain_error);
+	ASSERT_THROW(rto::exp(R(22), 1e-6), std::overflow_error);
+	ASSERT_THROW(rto::exp(R(100), 1e-6), std::overflow_error);
+	ASSERT_NO_THROW(rto::exp(R(21), 1e-6));
+	/// tan(355/226) is about -7.5e6
+	ASSERT_THROW(rto::tan(rto::Ratio<short>(355, 226), 1e-6), std::overflow_error);
+	ASSERT_NEAR(static_cast<double>(value(rto::tan(R(355, 226), 1e-3))), -7497258.18532, 1e-1);
+}
+
+/////////////////////////////////////////////////////
+// one argument versions
+
+TEST (RatioMath, exp) {
+	/// exp of a ratio whose value is not an integer
+	ASSERT_NEAR(static_cast<double>(value(exp(rto::Ratio<int>(1, 2)))), std::exp(0.5), 1e-6);
+}
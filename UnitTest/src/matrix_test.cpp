@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+#include "RatioMatrix.hpp"
+#include "RatioBigInt.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+template <typename R>
+static rto::Matrix<R> randomMatrix(std::size_t rows, std::size_t cols, unsigned int seed) {
+	using T = typename R::value_type;
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int> numerators(-9, 9);
+	std::uniform_int_distribution<int> denominators(1, 6);
+	rto::Matrix<R> mat(rows, cols);
+	for(std::size_t i=0; i<rows; ++i) {
+		for(std::size_t j=0; j<cols; ++j) {
+			mat(i, j) = R(T(numerators(generator)), T(denominators(generator)));
+		}
+	}
+	return mat;
+}
+
+/// straightforward product with the operators of Ratio
+template <typename R>
+static rto::Matrix<R> naiveProduct(const rto::Matrix<R> &a, const rto::Matrix<R> &b) {
+	rto::Matrix<R> result(a.rows(), b.cols());
+	for(std::size_t i=0; i<a.rows(); ++i) {
+		for(std::size_t j=0; j<b.cols(); ++j) {
+			for(std::size_t k=0; k<a.cols(); ++k) {
+				result(i, j) = result(i, j) + a(i, k) * b(k, j);
+			}
+		}
+	}
+	return result;
+}
+
+/////////////////////////////////////////////////////
+// product
+
+TEST (RatioMatrix, product) {
+	const rto::Matrix<rto::Ratio<long>> a = {{rto::Ratio<long>(1, 2), rto::Ratio<long>(1, 3)},
+	                                         {rto::Ratio<long>(2), rto::Ratio<long>(-1, 4)}};
+	const rto::Matrix<rto::Ratio<long>> b = {{rto::Ratio<long>(2), rto::Ratio<long>(0)},
+	                                         {rto::Ratio<long>(3, 2), rto::Ratio<long>(4)}};
+	const rto::Matrix<rto::Ratio<long>> c = a * b;
+	ASSERT_EQ(c(0, 0), rto::Ratio<long>(3, 2));
+	ASSERT_EQ(c(0, 1), rto::Ratio<long>(4, 3));
+	ASSERT_EQ(c(1, 0), rto::Ratio<long>(29, 8));
+	ASSERT_EQ(c(1, 1), rto::Ratio<long>(-1));
+}
+
+/// several tiles and slices, several threads, same result as the naive loops
+
+TEST (RatioMatrix, blockedProduct) {
+	const rto::Matrix<rto::Ratio<long>> a = randomMatrix<rto::Ratio<long>>(70, 300, 1);
+	const rto::Matrix<rto::Ratio<long>> b = randomMatrix<rto::Ratio<long>>(300, 45, 2);
+	const rto::Matrix<rto::Ratio<long>> expected = naiveProduct(a, b);
+	ASSERT_EQ(a.multiply(b, 1), expected);
+	ASSERT_EQ(a.multiply(b, 4), expected);
+}
+
+/// the common denominator of a row does not fit : ratio arithmetic
+
+TEST (RatioMatrix, productFallback) {
+	rto::Matrix<rto::Ratio<int>> a(2, 3);
+	a(0, 0) = rto::Ratio<int>(1, 65521);
+	a(0, 1) = rto::Ratio<int>(1, 65519);
+	a(0, 2) = rto::Ratio<int>(1, 65497);
+	a(1, 1) = rto::Ratio<int>(3);
+	const rto::Matrix<rto::Ratio<int>> b = rto::Matrix<rto::Ratio<int>>::identity(3);
+	ASSERT_EQ(a * b, a);
+}
+
+/////////////////////////////////////////////////////
+// Bareiss elimination
+
+TEST (RatioMatrix, determinant) {
+	const rto::Matrix<rto::Ratio<long>> a = {{rto::Ratio<long>(1, 2), rto::Ratio<long>(1, 3), rto::Ratio<long>(0)},
+	                                         {rto::Ratio<long>(0), rto::Ratio<long>(2), rto::Ratio<long>(1)},
+	                                         {rto::Ratio<long>(1), rto::Ratio<long>(0), rto::Ratio<long>(3, 4)}};
+	// 1/2*(2*3/4 - 0) - 1/3*(0*3/4 - 1) = 3/4 + 1/3
+	ASSERT_EQ(a.determinant(), rto::Ratio<long>(13, 12));
+	const rto::Matrix<rto::Ratio<long>> singular = {{rto::Ratio<long>(1), rto::Ratio<long>(2)},
+	                                                {rto::Ratio<long>(1, 2), rto::Ratio<long>(1)}};
+	ASSERT_EQ(singular.determinant(), rto::Ratio<long>(0));
+	const rto::Matrix<rto::Ratio<long>> swap = {{rto::Ratio<long>(0), rto::Ratio<long>(1)},
+	                                            {rto::Ratio<long>(1), rto::Ratio<long>(0)}};
+	ASSERT_EQ(swap.determinant(), rto::Ratio<long>(-1));
+}
+
+/// A * A^-1 = I, and A * solve(A, B) = B, with several threads
+
+TEST (RatioMatrix, solveInverse) {
+	using R = rto::Ratio<rto::BigInt>;
+	const rto::Matrix<R> a = randomMatrix<R>(12, 12, 3);
+	const rto::Matrix<R> b = randomMatrix<R>(12, 3, 4);
+	ASSERT_EQ(a * a.inverse(4), rto::Matrix<R>::identity(12));
+	ASSERT_EQ(a * a.solve(b, 1), b);
+	ASSERT_EQ(a.solve(b, 1), a.solve(b, 4));
+}
+
+/// the determinant with BigInt is the one of ratio arithmetic (cofactor expansion on a small matrix)
+
+TEST (RatioMatrix, determinantBigInt) {
+	using R = rto::Ratio<rto::BigInt>;
+	const rto::Matrix<R> a = randomMatrix<R>(3, 3, 5);
+	const R expected = a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1))
+	                 - a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0))
+	                 + a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+	ASSERT_EQ(a.determinant(), expected);
+}
+
+/// large enough for the elimination to use several threads : a tridiagonal L*U product with
+/// unit bidiagonal factors (determinant 1, every minor stays small), rows divided by small integers
+
+TEST (RatioMatrix, parallelElimination) {
+	using R = rto::Ratio<long>;
+	const std::size_t n = 200;
+	std::mt19937 generator(7);
+	rto::Matrix<R> a(n, n);
+	long product = 1;
+	long previousU = 0;
+	for(std::size_t i=0; i<n; ++i) {
+		const long l = (generator() & 1) ? 1 : -1;
+		const long u = (generator() & 1) ? 1 : -1;
+		const long scale = i < 30 ? 1 + static_cast<long>(generator() % 3) : 1;
+		product *= scale;
+		a(i, i) = R(1 + l * previousU, scale);
+		if(i > 0) {a(i, i-1) = R(l, scale);}
+		if(i+1 < n) {a(i, i+1) = R(u, scale);}
+		previousU = u;
+	}
+	const R det = a.determinant(4);
+	ASSERT_EQ(det, a.determinant(1));
+	ASSERT_EQ(det, R(1, product));
+	const rto::Matrix<R> b = randomMatrix<R>(n, 2, 8);
+	const rto::Matrix<R> x = a.solve(b, 4);
+	ASSERT_EQ(x, a.solve(b, 1));
+	ASSERT_EQ(a * x, b);
+}
+
+/// errors : singular systems, minors too large for the integer type
+
+TEST (RatioMatrix, errors) {
+	const rto::Matrix<rto::Ratio<long>> singular = {{rto::Ratio<long>(1), rto::Ratio<long>(2)},
+	                                                {rto::Ratio<long>(2), rto::Ratio<long>(4)}};
+	ASSERT_THROW(singular.inverse(), std::domain_error);
+	const rto::Matrix<rto::Ratio<int>> large = randomMatrix<rto::Ratio<int>>(30, 30, 6);
+	ASSERT_THROW(large.determinant(), std::overflow_error);
+}
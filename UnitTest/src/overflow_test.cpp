@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// overflow policies
+
+/// no overflow : every policy gives the same result
+
+TEST (RatioOverflow, sameResultWithoutOverflow) { 
+	rto::Ratio<int, rto::Eager, rto::Checked> checked = rto::Ratio<int, rto::Eager, rto::Checked>(5, 6) + rto::Ratio<int, rto::Eager, rto::Checked>(7, 10);
+	rto::Ratio<int, rto::Eager, rto::Widen> widen = rto::Ratio<int, rto::Eager, rto::Widen>(5, 6) + rto::Ratio<int, rto::Eager, rto::Widen>(7, 10);
+	rto::Ratio<int, rto::Eager, rto::Saturate> saturate = rto::Ratio<int, rto::Eager, rto::Saturate>(5, 6) + rto::Ratio<int, rto::Eager, rto::Saturate>(7, 10);
+	ASSERT_EQ(checked.numerator(), 23);
+	ASSERT_EQ(checked.denominator(), 15);
+	ASSERT_EQ(widen.numerator(), 23);
+	ASSERT_EQ(widen.denominator(), 15);
+	ASSERT_EQ(saturate.numerator(), 23);
+	ASSERT_EQ(saturate.denominator(), 15);
+}
+
+/// wrap : small types wrap around too (no promotion to int)
+
+TEST (RatioOverflow, wrapSmallTypes) { 
+	ASSERT_EQ(rto::Wrap::mul<short>(-1, -3), 3);
+	ASSERT_EQ(rto::Wrap::mul<short>(300, 300), static_cast<short>(90000 - 65536));
+	ASSERT_EQ(rto::Wrap::add<std::int8_t>(100, 100), static_cast<std::int8_t>(200 - 256));
+	ASSERT_EQ(rto::Wrap::sub<std::int8_t>(-100, 100), static_cast<std::int8_t>(56));
+	ASSERT_EQ(rto::Wrap::mul<unsigned short>(65535, 65533), static_cast<unsigned short>(3));
+}
+
+/// checked
+
+TEST (RatioOverflow, checkedThrows) { 
+	using R = rto::Ratio<std::int32_t, rto::Eager, rto::Checked>;
+	const R big(std::numeric_limits<std::int32_t>::max() / 2, 3);
+	ASSERT_THROW(big * R(7, 5), std::overflow_error);
+	ASSERT_THROW(R(1, 65537) + R(1, 65539), std::overflow_error);
+	ASSERT_NO_THROW(big * R(3, 5));
+}
+
+TEST (RatioOverflow, checkedDeferred) { 
+	using R = rto::Ratio<std::int32_t, rto::Deferred, rto::Checked>;
+	ASSERT_THROW(R(1, 65537) - R(1, 65539), std::overflow_error);
+}
+
+/// widen : the intermediates overflow, the irreducible result fits
+
+TEST (RatioOverflow, widenExact) { 
+	using R = rto::Ratio<std::int32_t, rto::Deferred, rto::Widen>;
+	R res = R(46341, 46342) * R(46342, 46341);
+	res.irreducible();
+	ASSERT_EQ(res.numerator(), 1);
+	ASSERT_EQ(res.denominator(), 1);
+
+	using L = rto::Ratio<std::int64_t, rto::Eager, rto::Widen>;
+	const std::int64_t big = std::int64_t(1) << 40;
+	L sum = L(1, big + 1) + L(1, big + 1);
+	ASSERT_EQ(sum.numerator(), 2);
+	ASSERT_EQ(sum.denominator(), big + 1);
+}
+
+TEST (RatioOverflow, widenThrows) { 
+	using R = rto::Ratio<std::int32_t, rto::Eager, rto::Widen>;
+	ASSERT_THROW(R(1, 65537) + R(1, 65539), std::overflow_error);
+}
+
+/// saturate
+
+TEST (RatioOverflow, saturateRounds) { 
+	using R = rto::Ratio<std::int32_t, rto::Eager, rto::Saturate>;
+	const R res = R(1, 65537) + R(1, 65539);
+	ASSERT_NEAR((double)res.numerator() / res.denominator(), 1.0 / 65537 + 1.0 / 65539, 1e-12);
+	ASSERT_EQ(std::gcd(res.numerator(), res.denominator()), 1);
+
+	const std::int32_t max = std::numeric_limits<std::int32_t>::max();
+	const R clamped = R(max, 1) * R(3, 1);
+	ASSERT_EQ(clamped.numerator(), max);
+	ASSERT_EQ(clamped.denominator(), 1);
+
+	const R negative = R(-max, 1) * R(3, 1);
+	ASSERT_EQ(negative.numerator(), -max);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "RatioPacked.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// Ratio is trivially copyable
+
+static_assert(std::is_trivially_copyable_v<rto::Ratio<int>>);
+static_assert(std::is_trivially_copyable_v<rto::Ratio<long long>>);
+static_assert(std::is_trivially_copyable_v<rto::Ratio<int, rto::Deferred, rto::Checked>>);
+static_assert(std::is_standard_layout_v<rto::Ratio<int>>);
+static_assert(std::is_standard_layout_v<rto::Ratio<short, rto::Eager, rto::Widen>>);
+static_assert(sizeof(rto::Ratio<int>) == 2 * sizeof(int));
+static_assert(std::is_same_v<decltype(std::declval<rto::Ratio<int>&>() = rto::Ratio<int>()), rto::Ratio<int>&>);
+
+TEST (RatioPacked, copies) {
+	/// chained assignments and moves
+	rto::Ratio<int> a, b;
+	a = b = rto::Ratio<int>(3, 4);
+	ASSERT_EQ(a, rto::Ratio<int>(3, 4));
+	rto::Ratio<int> c(std::move(a));
+	ASSERT_EQ(c, b);
+	std::vector<rto::Ratio<int>> values(1000, rto::Ratio<int>(1, 3));
+	values.resize(5000, rto::Ratio<int>(2, 3));
+	const std::vector<rto::Ratio<int>> copy = values;
+	ASSERT_EQ(copy[999], rto::Ratio<int>(1, 3));
+	ASSERT_EQ(copy[4999], rto::Ratio<int>(2, 3));
+}
+
+/////////////////////////////////////////////////////
+// packed storage
+
+/// fractions with numerators in [-2^19, 2^19) and denominators in [1, 4096]
+static std::vector<rto::Ratio<int>> smallFractions(std::size_t size, unsigned int seed) {
+	std::vector<rto::Ratio<int>> result = dataset::ratios<int>(size, {-(1 << 19), (1 << 19) - 1}, {1, 4096}, seed);
+	result.push_back(rto::Ratio<int>(-(1 << 19), 4095));
+	result.push_back(rto::Ratio<int>(1, 4096));
+	return result;
+}
+
+TEST (RatioPacked, roundTrip) {
+	const std::vector<rto::Ratio<int>> values = smallFractions(10000, 1);
+	const rto::PackedRatioVector<int> packed(values);
+	ASSERT_EQ(packed.size(), values.size());
+	/// 20 + 12 bits : half the memory of the ratios
+	ASSERT_EQ(packed.numeratorBits(), 20);
+	ASSERT_EQ(packed.denominatorBits(), 12);
+	ASSERT_LE(packed.memoryBytes(), values.size() * 4 + 16);
+	for(std::size_t i=0; i<values.size(); ++i) {
+		ASSERT_EQ(packed[i], values[i]) << i;
+	}
+	ASSERT_EQ(packed.unpack(), values);
+}
+
+TEST (RatioPacked, pushBack) {
+	/// the widths grow with the values, the ratios stored before are repacked
+	const std::vector<rto::Ratio<long long>> values = {{0}, {1, 2}, {-3, 4}, {1000, 7}, {-1, 1000000},
+	                                                   {std::numeric_limits<long long>::max(), 3}, {5, 6}};
+	rto::PackedRatioVector<long long> packed;
+	ASSERT_TRUE(packed.empty());
+	for(std::size_t i=0; i<values.size(); ++i) {
+		packed.push_back(values[i]);
+		for(std::size_t j=0; j<=i; ++j) {ASSERT_EQ(packed[j], values[j]) << i << " " << j;}
+	}
+	ASSERT_EQ(packed.numeratorBits(), 64);
+	ASSERT_EQ(packed.denominatorBits(), 20);
+
+	packed.set(1, rto::Ratio<long long>(-7, 8));
+	ASSERT_EQ(packed[1], rto::Ratio<long long>(-7, 8));
+	ASSERT_EQ(packed[2], values[2]);
+
+	packed.clear();
+	ASSERT_EQ(packed.size(), 0u);
+	ASSERT_EQ(packed.numeratorBits(), 1);
+}
+
+TEST (RatioPacked, canonical) {
+	/// positive denominators, Deferred ratios reduced
+	rto::PackedRatioVector<int> packed;
+	packed.push_back(rto::Ratio<int>(1, -2));
+	using D = rto::Ratio<int, rto::Deferred>;
+	packed.push_back(D(1, 4) + D(1, 4));
+	ASSERT_EQ(packed[0].numerator(), -1);
+	ASSERT_EQ(packed[0].denominator(), 2);
+	ASSERT_EQ(packed[1], rto::Ratio<int>(1, 2));
+}
+
+TEST (RatioPacked, limits) {
+	/// every type, with the extreme values
+	const std::vector<rto::Ratio<int>> ints = {{std::numeric_limits<int>::min(), 1}, {std::numeric_limits<int>::max(), std::numeric_limits<int>::max() - 1}, {0}};
+	ASSERT_EQ(rto::PackedRatioVector<int>(ints).unpack(), ints);
+
+	const std::vector<rto::Ratio<short>> shorts = {{-32768, 1}, {32767, 32766}, {-1, 3}};
+	ASSERT_EQ(rto::PackedRatioVector<short>(shorts).unpack(), shorts);
+
+	const std::vector<rto::Ratio<unsigned int>> unsigneds = {{4294967295u, 2u}, {0u, 1u}, {1u, 4294967295u}};
+	const rto::PackedRatioVector<unsigned int> packed(unsigneds);
+	ASSERT_EQ(packed.unpack(), unsigneds);
+	ASSERT_EQ(packed.numeratorBits(), 32);
+	ASSERT_EQ(packed.denominatorBits(), 32);
+
+	const std::vector<rto::Ratio<long long>> longs = {{std::numeric_limits<long long>::min(), 1}, {std::numeric_limits<long long>::max(), std::numeric_limits<long long>::max() - 1}};
+	ASSERT_EQ(rto::PackedRatioVector<long long>(longs).unpack(), longs);
+}
+
+TEST (RatioPacked, iterators) {
+	const std::vector<rto::Ratio<int>> values = smallFractions(100, 2);
+	const rto::PackedRatioVector<int> packed(values.begin(), values.end());
+	ASSERT_EQ(std::distance(packed.begin(), packed.end()), static_cast<std::ptrdiff_t>(values.size()));
+	std::size_t i = 0;
+	for(const rto::Ratio<int> rat : packed) {ASSERT_EQ(rat, values[i++]);}
+	rto::PackedRatioVector<int>::const_iterator it = packed.begin() + 10;
+	ASSERT_EQ(*it, values[10]);
+	ASSERT_EQ(it[5], values[15]);
+	ASSERT_EQ(*(--it), values[9]);
+	ASSERT_TRUE(packed.begin() < it);
+	ASSERT_EQ(std::vector<rto::Ratio<int>>(packed.begin(), packed.end()), values);
+}
+
+TEST (RatioPacked, ratioArray) {
+	const rto::RatioArray<int> array = {rto::Ratio<int>(1, 2), rto::Ratio<int>(-5, 3), rto::Ratio<int>(7)};
+	const rto::PackedRatioVector<int> packed(array);
+	ASSERT_EQ(packed.size(), 3u);
+	ASSERT_EQ(packed[1], rto::Ratio<int>(-5, 3));
+	ASSERT_EQ(packed.numeratorBits(), 4);
+	ASSERT_EQ(packed.denominatorBits(), 2);
+}
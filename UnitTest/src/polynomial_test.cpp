@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "RatioPolynomial.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// Polynomial
+
+TEST (RatioPolynomial, coefficients) {
+	const rto::Polynomial<int> poly = {rto::Ratio<int>(1, 2), rto::Ratio<int>(-2, 3), rto::Ratio<int>(0), rto::Ratio<int>(0)};
+	ASSERT_EQ(poly.degree(), 1u);
+	ASSERT_EQ(poly[1], rto::Ratio<int>(-2, 3));
+	ASSERT_EQ(poly[5], rto::Ratio<int>(0));
+	ASSERT_EQ(poly.denominator(), 6);
+	ASSERT_EQ(poly.integerCoefficients(), std::vector<int>({3, -4}));
+	ASSERT_EQ(rto::Polynomial<int>().degree(), 0u);
+}
+
+TEST (RatioPolynomial, evaluate) {
+	// 1/2 - x + 3/4 x^3
+	const rto::Polynomial<int> poly = {rto::Ratio<int>(1, 2), rto::Ratio<int>(-1), rto::Ratio<int>(0), rto::Ratio<int>(3, 4)};
+	ASSERT_EQ(poly(rto::Ratio<int>(0)), rto::Ratio<int>(1, 2));
+	ASSERT_EQ(poly(rto::Ratio<int>(2)), rto::Ratio<int>(9, 2));
+	ASSERT_EQ(poly(rto::Ratio<int>(-1, 3)), rto::Ratio<int>(29, 36));
+	const rto::Polynomial<int> constant = {rto::Ratio<int>(5, 7)};
+	ASSERT_EQ(constant(rto::Ratio<int>(3, 2)), rto::Ratio<int>(5, 7));
+}
+
+/// several blocks, same values as the Horner scheme on the ratio operators
+
+template <typename T>
+static void checkBatch() {
+	const rto::Polynomial<T> poly(dataset::ratios<T>(6, {-20, 20}, {1, 9}, 1));
+	// small enough for the ratio operators of horner() not to wrap around on int
+	const std::vector<rto::Ratio<T>> points = dataset::ratios<T>(1000, {-20, 20}, {1, 12}, 2);
+	const std::vector<rto::Ratio<T>> values = poly.evaluate(points);
+	ASSERT_EQ(values.size(), points.size());
+	for(std::size_t i=0; i<points.size(); ++i) {
+		const rto::Ratio<T> expected = poly.horner(points[i]);
+		ASSERT_EQ(values[i].numerator(), expected.numerator());
+		ASSERT_EQ(values[i].denominator(), expected.denominator());
+	}
+}
+
+TEST (RatioPolynomial, batch) {
+	checkBatch<int>();
+	checkBatch<long>();
+	checkBatch<unsigned int>();
+}
+
+/// points too large for the integer scheme are evaluated with the ratio operators
+
+TEST (RatioPolynomial, largePoints) {
+	const rto::Polynomial<long> poly = {rto::Ratio<long>(1), rto::Ratio<long>(1, 3), rto::Ratio<long>(0), rto::Ratio<long>(1, 5)};
+	rto::RatioArray<long> points = {rto::Ratio<long>(1L << 20, 3), rto::Ratio<long>(2, 1L << 19), rto::Ratio<long>(1, 2)};
+	rto::RatioArray<long> values;
+	poly.evaluate(points, values);
+	for(std::size_t i=0; i<points.size(); ++i) {
+		ASSERT_EQ(values[i], poly.horner(points[i]));
+	}
+	// in place
+	poly.evaluate(points, points);
+	ASSERT_EQ(points[2], rto::Ratio<long>(143, 120));
+}
+
+/////////////////////////////////////////////////////
+// RationalFunction
+
+TEST (RatioPolynomial, rationalFunction) {
+	// (1 + x^2) / (2/3 x - 1/2)
+	const rto::Polynomial<int> p = {rto::Ratio<int>(1), rto::Ratio<int>(0), rto::Ratio<int>(1)};
+	const rto::Polynomial<int> q = {rto::Ratio<int>(-1, 2), rto::Ratio<int>(2, 3)};
+	const rto::RationalFunction<int> f(p, q);
+	ASSERT_EQ(f(rto::Ratio<int>(0)), rto::Ratio<int>(-2));
+	ASSERT_EQ(f(rto::Ratio<int>(3)), rto::Ratio<int>(20, 3));
+	ASSERT_EQ(f(rto::Ratio<int>(1, 2)), rto::Ratio<int>(-15, 2));
+
+	const std::vector<rto::Ratio<long>> points = dataset::ratios<long>(700, {-15, 15}, {1, 10}, 3);
+	const rto::RationalFunction<long> g(rto::Polynomial<long>(dataset::ratios<long>(4, {-9, 9}, {1, 5}, 4)), rto::Polynomial<long>({rto::Ratio<long>(1), rto::Ratio<long>(0), rto::Ratio<long>(1, 7)}));
+	const std::vector<rto::Ratio<long>> values = g.evaluate(points);
+	for(std::size_t i=0; i<points.size(); ++i) {
+		ASSERT_EQ(values[i], g.numerator().horner(points[i]) / g.denominator().horner(points[i]));
+	}
+}
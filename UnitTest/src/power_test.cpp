@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// kernels, at compile time
+
+constexpr long long power(long long base, unsigned int exponent) {
+	long long result = 0;
+	return rto::overflow::powOverflows(base, exponent, result) ? -1 : result;
+}
+
+static_assert(power(3, 39) == 4052555153018976267LL);
+static_assert(power(-2, 63) == std::numeric_limits<long long>::min());
+static_assert(power(2, 63) == -1);
+static_assert(power(7, 0) == 1);
+static_assert(rto::kernel::isqrt(99U) == 9U);
+static_assert(rto::kernel::isqrt(100U) == 10U);
+static_assert(rto::kernel::isqrt(18446744073709551615ULL) == 4294967295ULL);
+
+/////////////////////////////////////////////////////
+// integer powers
+
+TEST (RatioPower, exact) {
+	ASSERT_EQ(pow(rto::Ratio<int>(2, 3), 3), rto::Ratio<int>(8, 27));
+	ASSERT_EQ(pow(rto::Ratio<int>(-2, 3), 3), rto::Ratio<int>(-8, 27));
+	ASSERT_EQ(pow(rto::Ratio<int>(-2, 3), 4), rto::Ratio<int>(16, 81));
+	ASSERT_EQ(pow(rto::Ratio<int>(2, 3), -3), rto::Ratio<int>(27, 8));
+	ASSERT_EQ(pow(rto::Ratio<int>(-2, 3), -3), rto::Ratio<int>(-27, 8));
+	ASSERT_EQ(pow(rto::Ratio<int>(5, 7), 0), rto::Ratio<int>(1));
+	ASSERT_EQ(pow(rto::Ratio<int>(0), 5), rto::Ratio<int>(0));
+	ASSERT_EQ(pow(rto::Ratio<int>(-1), 1000001), rto::Ratio<int>(-1));
+
+	/// beyond 2^53 : 3^39 and 7^22 are exact
+	const rto::Ratio<long long> power = pow(rto::Ratio<long long>(3, 7), 22);
+	ASSERT_EQ(power.numerator(), 31381059609LL);
+	ASSERT_EQ(power.denominator(), 3909821048582988049LL);
+	ASSERT_EQ(pow(rto::Ratio<long long>(3), 39).numerator(), 4052555153018976267LL);
+	ASSERT_EQ(pow(rto::Ratio<std::uint64_t>(1, 3), 40U).denominator(), 12157665459056928801ULL);
+
+	/// Deferred ratios are reduced first
+	using D = rto::Ratio<int, rto::Deferred>;
+	const D deferred = pow(D(1, 4) + D(1, 4), 10);
+	ASSERT_EQ(deferred.numerator(), 1);
+	ASSERT_EQ(deferred.denominator(), 1024);
+}
+
+TEST (RatioPower, overflow) {
+	/// Wrap : modulo 2^32, as the other operators
+	ASSERT_EQ(pow(rto::Ratio<int>(2), 32).numerator(), 0);
+	ASSERT_EQ(pow(rto::Ratio<int>(3), 21).numerator(), static_cast<int>(10460353203LL - 4294967296LL * 2));
+
+	/// Checked and Widen throw
+	using C = rto::Ratio<int, rto::Eager, rto::Checked>;
+	using W = rto::Ratio<int, rto::Eager, rto::Widen>;
+	ASSERT_EQ(pow(C(2), 30), C(1 << 30));
+	ASSERT_THROW(pow(C(2), 31), std::overflow_error);
+	ASSERT_THROW(pow(C(1, 2), 31), std::overflow_error);
+	ASSERT_THROW(pow(W(3, 2), 21), std::overflow_error);
+	ASSERT_EQ(pow(C(-2), 31), C(std::numeric_limits<int>::min()));
+
+	/// Saturate rounds
+	using S = rto::Ratio<int, rto::Eager, rto::Saturate>;
+	const S rounded = pow(S(3, 2), 40);
+	ASSERT_NEAR(static_cast<double>(rounded.numerator()) / rounded.denominator(), std::pow(1.5, 40), 1e-3);
+	ASSERT_EQ(pow(S(2), 40), S(std::numeric_limits<int>::max()));
+}
+
+TEST (RatioPower, realExponent) {
+	const rto::Ratio<int> root = pow(rto::Ratio<int>(2), 0.5);
+	ASSERT_NEAR(static_cast<double>(root.numerator()) / root.denominator(), std::sqrt(2.0), 1e-9);
+	const rto::Ratio<int> inverse = pow(rto::Ratio<int>(4), -1.5);
+	ASSERT_EQ(inverse, rto::Ratio<int>(1, 8));
+}
+
+/////////////////////////////////////////////////////
+// square root
+
+TEST (RatioSqrt, perfectSquares) {
+	ASSERT_EQ(sqrt(rto::Ratio<int>(9, 4)), rto::Ratio<int>(3, 2));
+	ASSERT_EQ(sqrt(rto::Ratio<int>(0)), rto::Ratio<int>(0));
+	ASSERT_EQ(sqrt(rto::Ratio<int>(1)), rto::Ratio<int>(1));
+	ASSERT_EQ(sqrt(rto::Ratio<int>(46340 * 46340, 49)), rto::Ratio<int>(46340, 7));
+	const long long large = 3037000499LL;
+	ASSERT_EQ(sqrt(rto::Ratio<long long>(large * large, 10201)), rto::Ratio<long long>(large, 101));
+	ASSERT_EQ(sqrt(rto::Ratio<std::uint64_t>(18446744065119617025ULL)), rto::Ratio<std::uint64_t>(4294967295ULL));
+}
+
+TEST (RatioSqrt, approximations) {
+	/// convergents of sqrt(2) = [1; 2, 2, 2, ...]
+	ASSERT_EQ(sqrt(rto::Ratio<int>(2), 12), rto::Ratio<int>(17, 12));
+	ASSERT_EQ(sqrt(rto::Ratio<int>(2), 70), rto::Ratio<int>(99, 70));
+	/// sqrt(3) = [1; 1, 2, 1, 2, ...] : the semiconvergent 12/7 is closer than 7/4, then 19/11
+	ASSERT_EQ(sqrt(rto::Ratio<int>(3), 10), rto::Ratio<int>(12, 7));
+	ASSERT_EQ(sqrt(rto::Ratio<int>(3), 11), rto::Ratio<int>(19, 11));
+	/// an exact root whose denominator is above the bound
+	ASSERT_EQ(sqrt(rto::Ratio<int>(1, 49), 5), rto::Ratio<int>(1, 5));
+
+	/// the whole range of T : as close as a double (or closer)
+	for(int n=2; n<200; ++n) {
+		for(int d : {1, 3, 7, 1000, 99991}) {
+			const rto::Ratio<int> rat(n, d);
+			const rto::Ratio<int> root = sqrt(rat);
+			const long double exact = std::sqrt(static_cast<long double>(rat.numerator()) / rat.denominator());
+			ASSERT_NEAR(static_cast<double>(static_cast<long double>(root.numerator()) / root.denominator()), static_cast<double>(exact), 1e-9 * exact) << rat;
+		}
+	}
+	/// best approximation of sqrt(2) on 64 bits
+	const rto::Ratio<long long> two = sqrt(rto::Ratio<long long>(2));
+	ASSERT_EQ(two, rto::Ratio<long long>(6882627592338442563LL, 4866752642924153522LL));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "RatioArray.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// helpers
+
+template <typename T>
+void expectSame(const rto::Ratio<T> &rat, const rto::Ratio<T> &expected) {
+	// same value, and same irreducible form up to the sign convention
+	ASSERT_EQ(static_cast<long long>(rat.numerator()) * expected.denominator(), static_cast<long long>(expected.numerator()) * rat.denominator());
+	ASSERT_EQ(std::gcd(rat.numerator(), rat.denominator()), 1);
+}
+
+/////////////////////////////////////////////////////
+// constructors
+
+TEST (RatioArray, constructors) { 
+	rto::RatioArray<int> empty;
+	ASSERT_TRUE(empty.empty());
+
+	rto::RatioArray<int> zeros(3);
+	ASSERT_EQ(zeros.size(), 3u);
+	ASSERT_EQ(zeros[2], rto::Ratio<int>(0, 1));
+
+	rto::RatioArray<int> array {rto::Ratio<int>(1, 2), rto::Ratio<int>(3, 4)};
+	ASSERT_EQ(array.size(), 2u);
+	ASSERT_EQ(array.numerators()[1], 3);
+	ASSERT_EQ(array.denominators()[1], 4);
+	ASSERT_EQ(array.toVector()[0], rto::Ratio<int>(1, 2));
+
+	// the kernels never read the operands of an empty array
+	ASSERT_TRUE((empty + empty).empty());
+	ASSERT_TRUE((empty * empty).empty());
+}
+
+/////////////////////////////////////////////////////
+// batch normalization
+
+TEST (RatioArray, irreducible) { 
+	rto::RatioArray<int> array(19);
+	for(std::size_t i=0; i<array.size(); ++i) {
+		array.numerators()[i] = static_cast<int>(6 * i) - 30;
+		array.denominators()[i] = static_cast<int>(4 * i) + 8;
+	}
+	array.irreducible();
+	for(std::size_t i=0; i<array.size(); ++i) {
+		expectSame(array[i], rto::Ratio<int>(static_cast<int>(6 * i) - 30, static_cast<int>(4 * i) + 8));
+	}
+}
+
+/////////////////////////////////////////////////////
+// batch kernels (compared with the Ratio operators)
+
+template <typename T>
+void checkKernels() {
+	const std::vector<rto::Ratio<T>> a = dataset::ratios<T>(101, {-1000, 1000}, {-1000, 1000}, 1);
+	const std::vector<rto::Ratio<T>> b = dataset::ratios<T>(101, {-1000, 1000}, {-1000, 1000}, 2);
+	const rto::RatioArray<T> arrayA(a);
+	const rto::RatioArray<T> arrayB(b);
+	const rto::Ratio<T> scalar(-7, 3);
+
+	const rto::RatioArray<T> sum = arrayA + arrayB;
+	const rto::RatioArray<T> difference = arrayA - arrayB;
+	const rto::RatioArray<T> product = arrayA * arrayB;
+	const rto::RatioArray<T> quotient = arrayA / arrayB;
+	const rto::RatioArray<T> sumScalar = arrayA + scalar;
+	const rto::RatioArray<T> quotientScalar = arrayA / scalar;
+	for(std::size_t i=0; i<a.size(); ++i) {
+		expectSame(sum[i], a[i] + b[i]);
+		expectSame(difference[i], a[i] - b[i]);
+		expectSame(product[i], a[i] * b[i]);
+		if(b[i].numerator() != 0) {expectSame(quotient[i], a[i] / b[i]);}
+		expectSame(sumScalar[i], a[i] + scalar);
+		expectSame(quotientScalar[i], a[i] / scalar);
+	}
+}
+
+TEST (RatioArray, kernelsInt) { 
+	checkKernels<int>();
+}
+
+TEST (RatioArray, kernelsLong) { 
+	checkKernels<long>();
+}
+
+/// an overflow wraps around (Wrap policy) in the vector body and in the scalar tail alike
+
+TEST (RatioArray, wrapAround) { 
+	const std::vector<rto::Ratio<int>> big(11, rto::Ratio<int>(2000000000, 1));
+	const std::vector<rto::Ratio<int>> small(11, rto::Ratio<int>(3, 7));
+	const rto::RatioArray<int> sum = rto::RatioArray<int>(big) + rto::RatioArray<int>(small);
+	// 2e9 * 7 + 3 modulo 2^32
+	const int wrapped = static_cast<int>(static_cast<std::uint32_t>(2000000000LL * 7 + 3));
+	for(std::size_t i=0; i<sum.size(); ++i) {
+		expectSame(sum[i], rto::Ratio<int>(wrapped, 7));
+	}
+}
+
+/// in place
+
+TEST (RatioArray, inPlace) { 
+	rto::RatioArray<int> array {rto::Ratio<int>(1, 2), rto::Ratio<int>(3, 4)};
+	rto::mul(array, rto::Ratio<int>(2, 3), array);
+	ASSERT_EQ(array[0], rto::Ratio<int>(1, 3));
+	ASSERT_EQ(array[1], rto::Ratio<int>(1, 2));
+}
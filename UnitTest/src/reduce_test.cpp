@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "RatioReduce.hpp"
+#include "RatioBigInt.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// reduceSum
+
+/// same value as the serial operator + when nothing overflows
+
+TEST (RatioReduce, sum) {
+	const std::vector<rto::Ratio<long>> ratios = dataset::ratios<long>(100000, {-100, 100}, {1, 12}, 1);
+	rto::Ratio<long> expected;
+	for(const rto::Ratio<long> &ratio : ratios) {
+		expected = expected + ratio;
+	}
+	const rto::Ratio<long> sum = rto::reduceSum(ratios.begin(), ratios.end(), 4);
+	ASSERT_EQ(sum.numerator(), expected.numerator());
+	ASSERT_EQ(sum.denominator(), expected.denominator());
+}
+
+/// identical bits for every thread count, even when the intermediates wrap around
+
+TEST (RatioReduce, threadCountInvariant) {
+	const std::vector<rto::Ratio<int>> ratios = dataset::ratios<int>(200000, {-100, 100}, {1, 1000}, 2);
+	const rto::Ratio<int> serial = rto::reduceSum(ratios.begin(), ratios.end(), 1);
+	for(unsigned int threads : {2u, 3u, 8u, 0u}) {
+		const rto::Ratio<int> parallel = rto::reduceSum(ratios.begin(), ratios.end(), threads);
+		ASSERT_EQ(parallel.numerator(), serial.numerator());
+		ASSERT_EQ(parallel.denominator(), serial.denominator());
+	}
+}
+
+/// unbounded integers : the common denominator never overflows
+
+TEST (RatioReduce, bigInt) {
+	const std::vector<rto::Ratio<long>> ratios = dataset::ratios<long>(40000, {-100, 100}, {1, 64}, 3);
+	std::vector<rto::Ratio<rto::BigInt>> exact;
+	rto::Ratio<rto::BigInt> expected;
+	for(const rto::Ratio<long> &ratio : ratios) {
+		exact.push_back(rto::Ratio<rto::BigInt>(ratio.numerator(), ratio.denominator()));
+		expected = expected + exact.back();
+	}
+	const rto::Ratio<rto::BigInt> sum = rto::reduceSum(exact.begin(), exact.end(), 4);
+	ASSERT_EQ(sum.numerator(), expected.numerator());
+	ASSERT_EQ(sum.denominator(), expected.denominator());
+}
+
+/// empty range, negative denominators
+
+TEST (RatioReduce, edgeCases) {
+	const std::vector<rto::Ratio<int>> empty;
+	ASSERT_EQ(rto::reduceSum(empty.begin(), empty.end()), rto::Ratio<int>(0));
+	ASSERT_EQ(rto::reduceProduct(empty.begin(), empty.end()), rto::Ratio<int>(1));
+	const std::vector<rto::Ratio<int>> ratios = {rto::Ratio<int>(1, -2), rto::Ratio<int>(1, 3)};
+	const rto::Ratio<int> sum = rto::reduceSum(ratios.begin(), ratios.end());
+	ASSERT_EQ(sum.numerator(), -1);
+	ASSERT_EQ(sum.denominator(), 6);
+}
+
+/// the overflow policy applies when the common denominator does not fit, exceptions reach the caller
+
+TEST (RatioReduce, checked) {
+	using R = rto::Ratio<int, rto::Eager, rto::Checked>;
+	std::vector<R> ratios;
+	for(int i=0; i<100000; ++i) {
+		ratios.push_back(R(1, 1000003 + i));
+	}
+	ASSERT_THROW(rto::reduceSum(ratios.begin(), ratios.end(), 4), std::overflow_error);
+}
+
+/////////////////////////////////////////////////////
+// reduceProduct and dot
+
+TEST (RatioReduce, product) {
+	std::vector<rto::Ratio<long>> ratios;
+	for(long i=1; i<=100000; ++i) {
+		ratios.push_back(rto::Ratio<long>(i + 1, i));
+	}
+	const rto::Ratio<long> product = rto::reduceProduct(ratios.begin(), ratios.end(), 3);
+	ASSERT_EQ(product, rto::Ratio<long>(100001, 1));
+}
+
+TEST (RatioReduce, dot) {
+	const std::vector<rto::Ratio<long>> a = dataset::ratios<long>(60000, {-100, 100}, {1, 8}, 4);
+	const std::vector<rto::Ratio<long>> b = dataset::ratios<long>(60000, {-100, 100}, {1, 8}, 5);
+	rto::Ratio<long> expected;
+	for(std::size_t i=0; i<a.size(); ++i) {
+		expected = expected + a[i] * b[i];
+	}
+	ASSERT_EQ(rto::dot(a.begin(), a.end(), b.begin(), 4), expected);
+	ASSERT_EQ(rto::dot(a.begin(), a.end(), b.begin(), 1), expected);
+}
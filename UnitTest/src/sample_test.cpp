@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <numeric>
+#include <vector>
 
 #include "Ratio.hpp"
 
@@ -158,6 +160,35 @@ TEST (operators, unary_minus) {
 	ASSERT_DOUBLE_EQ((double)rat.numerator() / rat.denominator(), -5.0/2.0);
 }
 
+/// cross-cancellation (the naive products would overflow an int)
+
+TEST (operators, multiplicationCrossCancel) { 
+	rto::Ratio<int> rat(46341, 2);
+	rto::Ratio<int> rat2(2, 46341);
+	rto::Ratio<int> res = rat * rat2;
+	ASSERT_EQ(res.numerator(), 1);
+	ASSERT_EQ(res.denominator(), 1);
+
+	res = rto::Ratio<int>(65536, 3) / rto::Ratio<int>(65536, 5);
+	ASSERT_EQ(res.numerator(), 5);
+	ASSERT_EQ(res.denominator(), 3);
+}
+
+TEST (operators, additionCrossCancel) { 
+	rto::Ratio<int> rat(1, 65536);
+	rto::Ratio<int> res = rat + rat;
+	ASSERT_EQ(res.numerator(), 1);
+	ASSERT_EQ(res.denominator(), 32768);
+
+	res = rto::Ratio<int>(5, 6) - rto::Ratio<int>(1, 6);
+	ASSERT_EQ(res.numerator(), 2);
+	ASSERT_EQ(res.denominator(), 3);
+
+	res = rto::Ratio<int>(3, 4) - rto::Ratio<int>(3, 4);
+	ASSERT_EQ(res.numerator(), 0);
+	ASSERT_EQ(res.denominator(), 1);
+}
+
 /////////////////////////////////////////////////////
 // comparison functions
 
@@ -227,6 +258,58 @@ TEST (comparison, not_equal) {
 	ASSERT_EQ(rat != rat2, false);
 }
 
+/// ordering by cross-multiplication (the integer parts are equal)
+
+TEST (comparison, crossMultiplication) { 
+	rto::Ratio<int> third(1, 3);
+	rto::Ratio<int> half(1, 2);
+	ASSERT_EQ(third < half, true);
+	ASSERT_EQ(third <= half, true);
+	ASSERT_EQ(third > half, false);
+	ASSERT_EQ(half >= third, true);
+	ASSERT_EQ(third != half, true);
+
+	rto::Ratio<int> big(2147483646, 2147483647);
+	rto::Ratio<int> bigger(2147483645, 2147483646);
+	ASSERT_EQ(bigger < big, true);
+	ASSERT_EQ(rto::Ratio<int>(-1, 3) < rto::Ratio<int>(-1, 4), true);
+}
+
+/// three-way compare, also with a negative denominator
+
+TEST (comparison, compare) { 
+	ASSERT_EQ(rto::Ratio<int>(1, 3).compare(rto::Ratio<int>(1, 2)), -1);
+	ASSERT_EQ(rto::Ratio<int>(2, 4).compare(rto::Ratio<int>(1, 2)), 0);
+	ASSERT_EQ(rto::Ratio<int>(1, -3).compare(rto::Ratio<int>(-1, 2)), 1);
+	ASSERT_EQ(rto::Ratio<int>(1, 2).compare(rto::Ratio<int>(1, -3)), 1);
+}
+
+/// 128-bit ratios : double filter, then exact comparison without products
+
+#if defined(__SIZEOF_INT128__)
+TEST (comparison, compareWithoutWiderType) { 
+	using R = rto::Ratio<rto::overflow::int128>;
+	const rto::overflow::int128 big = rto::overflow::int128(1) << 100;
+	ASSERT_EQ(R(1, 3).compare(R(1, 2)), -1);
+	ASSERT_EQ(R(big + 1, big).compare(R(big + 2, big + 1)), 1);
+	ASSERT_EQ(R(big - 1, big).compare(R(big - 2, big - 1)), 1);
+	ASSERT_EQ(R(-big - 1, big).compare(R(-big - 2, big + 1)), -1);
+	ASSERT_EQ(R(big + 1, big).compare(R(big + 1, big)), 0);
+	ASSERT_EQ(R(big + 1, -big).compare(R(big + 2, -big - 1)), -1);
+}
+#endif
+
+/// sorting
+
+TEST (comparison, sort) { 
+	std::vector<rto::Ratio<int>> ratios = {{1, 2}, {-3, 4}, {1, 3}, {5, 2}, {2, 3}, {0, 1}, {-1, 5}};
+	std::sort(ratios.begin(), ratios.end(), rto::RatioLess());
+	ASSERT_TRUE(std::is_sorted(ratios.begin(), ratios.end()));
+	ASSERT_EQ(ratios.front(), rto::Ratio<int>(-3, 4));
+	ASSERT_EQ(ratios[3], rto::Ratio<int>(1, 3));
+	ASSERT_EQ(ratios.back(), rto::Ratio<int>(5, 2));
+}
+
 /////////////////////////////////////////////////////
 // mathematical functions
 
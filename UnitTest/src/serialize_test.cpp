@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "RatioSerialize.hpp"
+#include "dataset.hpp"
+
+
+/////////////////////////////////////////////////////
+// dataset
+
+/// small and extreme values, negative denominators (as stored, not normalized)
+template <typename T>
+static std::vector<rto::Ratio<T>> sampleRatios(std::size_t size, unsigned int seed) {
+	std::vector<rto::Ratio<T>> ratios = dataset::ratios<T>(size, {-300, 300}, {-300, 300}, seed, false);
+	rto::Ratio<T> extreme;
+	extreme.numerator() = std::numeric_limits<T>::min();
+	extreme.denominator() = std::numeric_limits<T>::max();
+	ratios.push_back(extreme);
+	return ratios;
+}
+
+template <typename T>
+static void checkRoundTrip(rto::io::Encoding encoding) {
+	const std::vector<rto::Ratio<T>> ratios = sampleRatios<T>(1000, 1);
+	std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+	rto::io::write(stream, ratios, encoding);
+	const std::vector<rto::Ratio<T>> copy = rto::io::read<T>(stream).toVector();
+	ASSERT_EQ(copy.size(), ratios.size());
+	for(std::size_t i=0; i<ratios.size(); ++i) {
+		ASSERT_EQ(copy[i].numerator(), ratios[i].numerator());
+		ASSERT_EQ(copy[i].denominator(), ratios[i].denominator());
+	}
+}
+
+/////////////////////////////////////////////////////
+// encodings
+
+TEST (RatioSerialize, fixed) {
+	checkRoundTrip<std::int8_t>(rto::io::Encoding::Fixed);
+	checkRoundTrip<int>(rto::io::Encoding::Fixed);
+	checkRoundTrip<unsigned int>(rto::io::Encoding::Fixed);
+	checkRoundTrip<long long>(rto::io::Encoding::Fixed);
+}
+
+TEST (RatioSerialize, varint) {
+	checkRoundTrip<std::int8_t>(rto::io::Encoding::Varint);
+	checkRoundTrip<int>(rto::io::Encoding::Varint);
+	checkRoundTrip<unsigned int>(rto::io::Encoding::Varint);
+	checkRoundTrip<long long>(rto::io::Encoding::Varint);
+}
+
+/// layout of the header and of the payloads
+
+TEST (RatioSerialize, layout) {
+	const rto::RatioArray<int> array = {rto::Ratio<int>(-1, 2), rto::Ratio<int>(100, 3)};
+	std::ostringstream fixed(std::ios::binary), varint(std::ios::binary);
+	rto::io::write(fixed, array);
+	rto::io::write(varint, array, rto::io::Encoding::Varint);
+	// header, numerators padded to 32 bytes, denominators
+	ASSERT_EQ(fixed.str().size(), 32u + 32u + 8u);
+	ASSERT_EQ(fixed.str().substr(0, 4), "RTOA");
+	// zigzag : -1 -> 1, 2 -> 4, 100 -> 200 (2 bytes), 3 -> 6
+	const std::string bytes = varint.str();
+	ASSERT_EQ(bytes.size(), 32u + 5u);
+	ASSERT_EQ(bytes.substr(32), std::string("\x01\x04\xc8\x01\x06"));
+}
+
+/////////////////////////////////////////////////////
+// errors
+
+TEST (RatioSerialize, errors) {
+	const rto::RatioArray<int> array = {rto::Ratio<int>(1, 2), rto::Ratio<int>(3, 4)};
+	std::ostringstream out(std::ios::binary);
+	rto::io::write(out, array, rto::io::Encoding::Varint);
+	const std::string bytes = out.str();
+
+	std::istringstream wrongType(bytes, std::ios::binary);
+	ASSERT_THROW(rto::io::read<long>(wrongType), std::runtime_error);
+	std::istringstream truncated(bytes.substr(0, bytes.size() - 1), std::ios::binary);
+	ASSERT_THROW(rto::io::read<int>(truncated), std::runtime_error);
+	std::string corrupted = bytes;
+	corrupted[0] = 'X';
+	std::istringstream badMagic(corrupted, std::ios::binary);
+	ASSERT_THROW(rto::io::read<int>(badMagic), std::runtime_error);
+	corrupted = bytes;
+	corrupted[4] = 9;
+	std::istringstream badVersion(corrupted, std::ios::binary);
+	ASSERT_THROW(rto::io::read<int>(badVersion), std::runtime_error);
+
+	// a crafted size that wraps the payload size around to 0 (2^62 ints, 2^63 varint pairs)
+	for(const rto::io::Encoding encoding : {rto::io::Encoding::Fixed, rto::io::Encoding::Varint}) {
+		std::ostringstream small(std::ios::binary);
+		rto::io::write(small, array, encoding);
+		std::string crafted = small.str().substr(0, 32);
+		for(int i=0; i<8; ++i) {
+			crafted[12 + i] = static_cast<char>(i < 7 ? 0 : encoding == rto::io::Encoding::Fixed ? 0x40 : 0x80);
+			crafted[20 + i] = 0;
+		}
+		std::istringstream hugeSize(crafted, std::ios::binary);
+		ASSERT_THROW(rto::io::read<int>(hugeSize), std::runtime_error);
+	}
+}
+
+/////////////////////////////////////////////////////
+// MappedRatioArray
+
+#if RTO_HAS_MMAP
+
+TEST (RatioSerialize, mapped) {
+	const std::string path = testing::TempDir() + "ratio_serialize_test.bin";
+	const std::vector<rto::Ratio<long>> ratios = sampleRatios<long>(5000, 2);
+	{
+		std::ofstream file(path, std::ios::binary);
+		rto::io::write(file, ratios);
+	}
+	rto::MappedRatioArray<long> view(path);
+	ASSERT_EQ(view.size(), ratios.size());
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(view.denominators()) % 32, 0u);
+	for(std::size_t i=0; i<ratios.size(); ++i) {
+		ASSERT_EQ(view.numerators()[i], ratios[i].numerator());
+		ASSERT_EQ(view[i].denominator(), ratios[i].denominator());
+	}
+	const rto::MappedRatioArray<long> moved = std::move(view);
+	ASSERT_TRUE(view.empty());
+	ASSERT_EQ(moved.toArray()[4999].numerator(), ratios[4999].numerator());
+
+	ASSERT_THROW(rto::MappedRatioArray<int>{path}, std::runtime_error);
+	{
+		std::ofstream file(path, std::ios::binary);
+		rto::io::write(file, ratios, rto::io::Encoding::Varint);
+	}
+	ASSERT_THROW(rto::MappedRatioArray<long>{path}, std::runtime_error);
+	std::remove(path.c_str());
+	ASSERT_THROW(rto::MappedRatioArray<long>{path}, std::system_error);
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// built in its own executable (UnitTestsStats) with RTO_INSTRUMENTATION=1
+#include "Ratio.hpp"
+
+
+/////////////////////////////////////////////////////
+// counters
+
+/// gcd calls and the bit width of the largest operand
+
+TEST (RatioStats, gcd) {
+	ASSERT_TRUE(rto::stats::enabled);
+	rto::stats::reset();
+	rto::Ratio<int> ratio(6, 40);
+	const rto::stats::Snapshot snapshot = rto::stats::threadSnapshot();
+	ASSERT_EQ(ratio.denominator(), 20);
+	ASSERT_EQ(snapshot.gcdCalls, 1u);
+	ASSERT_EQ(snapshot.gcdBitWidths[6], 1u);
+	ASSERT_EQ(snapshot.normalizations, 1u);
+}
+
+/// Deferred results that stay small are not reduced
+
+TEST (RatioStats, normalizationsSkipped) {
+	using R = rto::Ratio<int, rto::Deferred>;
+	const R a(1, 3), b(1, 5);
+	rto::stats::reset();
+	const R sum = a + b;
+	ASSERT_EQ(sum.denominator(), 15);
+	ASSERT_EQ(rto::stats::threadSnapshot().normalizationsSkipped, 1u);
+	ASSERT_EQ(rto::stats::threadSnapshot().normalizations, 0u);
+}
+
+/// continued fraction steps, and conversions stopped by the denominator bound
+
+TEST (RatioStats, conversion) {
+	rto::stats::reset();
+	ASSERT_EQ(rto::Ratio<int>::fromReal(0.5), rto::Ratio<int>(1, 2));
+	rto::stats::Snapshot snapshot = rto::stats::threadSnapshot();
+	ASSERT_EQ(snapshot.conversions, 1u);
+	ASSERT_EQ(snapshot.conversionsBounded, 0u);
+	ASSERT_EQ(snapshot.conversionSteps[2], 1u);
+
+	ASSERT_EQ(rto::Ratio<int>::fromReal(M_PI, 100), rto::Ratio<int>(311, 99));
+	snapshot = rto::stats::threadSnapshot();
+	ASSERT_EQ(snapshot.conversions, 2u);
+	ASSERT_EQ(snapshot.conversionsBounded, 1u);
+}
+
+/// intermediates close to the limit of T, per operator
+
+TEST (RatioStats, nearMisses) {
+	rto::stats::reset();
+	const rto::Ratio<int> big(1 << 15, 3);
+	const rto::Ratio<int> product = big * rto::Ratio<int>(1 << 15, 5);
+	ASSERT_EQ(product.numerator(), 1 << 30);
+	const rto::Ratio<int> quotient = rto::Ratio<int>(1, 3) / rto::Ratio<int>(1, 5);
+	ASSERT_EQ(quotient, rto::Ratio<int>(5, 3));
+	const rto::stats::Snapshot snapshot = rto::stats::threadSnapshot();
+	ASSERT_EQ(snapshot[rto::stats::Operation::Multiply].operations, 1u);
+	ASSERT_EQ(snapshot[rto::stats::Operation::Multiply].nearMisses, 1u);
+	ASSERT_EQ(snapshot[rto::stats::Operation::Divide].operations, 1u);
+	ASSERT_EQ(snapshot[rto::stats::Operation::Divide].nearMisses, 0u);
+}
+
+/// with a wider intermediate type, the overflows themselves are counted
+
+TEST (RatioStats, overflows) {
+	using R = rto::Ratio<int, rto::Eager, rto::Widen>;
+	rto::stats::reset();
+	ASSERT_THROW(R(1 << 20, 3) * R(1 << 20, 5), std::overflow_error);
+	ASSERT_NO_THROW(R(1, 3) + R(1, 5));
+	const rto::stats::Snapshot snapshot = rto::stats::threadSnapshot();
+	ASSERT_EQ(snapshot[rto::stats::Operation::Multiply].overflows, 1u);
+	ASSERT_EQ(snapshot[rto::stats::Operation::Add].operations, 1u);
+	ASSERT_EQ(snapshot[rto::stats::Operation::Add].overflows, 0u);
+}
+
+/////////////////////////////////////////////////////
+// snapshot
+
+/// snapshot() sums the counters of every thread, also the threads that have exited
+
+TEST (RatioStats, threads) {
+	rto::stats::reset();
+	std::thread worker([]() {
+		rto::Ratio<long> sum;
+		for(long i=1; i<=30; ++i) {
+			sum = sum + rto::Ratio<long>(1, i);
+		}
+	});
+	worker.join();
+	rto::Ratio<int>(2, 4);
+	const rto::stats::Snapshot total = rto::stats::snapshot();
+	ASSERT_EQ(rto::stats::threadSnapshot().gcdCalls, 1u);
+	ASSERT_EQ(total[rto::stats::Operation::Add].operations, 30u);
+	ASSERT_GT(total.gcdCalls, 30u);
+}
+
+/// text and JSON dumps
+
+TEST (RatioStats, dump) {
+	rto::stats::reset();
+	rto::Ratio<int>(2, 4);
+	const rto::stats::Snapshot snapshot = rto::stats::threadSnapshot();
+	const std::string json = snapshot.toJson();
+	ASSERT_EQ(json.rfind("{\"gcd\":{\"calls\":1,\"bitWidths\":{\"3\":1}}", 0), 0u);
+	ASSERT_NE(json.find("\"multiply\":{\"operations\":0,\"nearMisses\":0,\"overflows\":0}"), std::string::npos);
+	const std::string text = snapshot.toText();
+	ASSERT_NE(text.find("gcd calls: 1\n"), std::string::npos);
+	ASSERT_NE(text.find("gcd operand bits = 3: 1\n"), std::string::npos);
+}
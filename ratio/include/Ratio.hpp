@@ -1,11 +1,33 @@
+#include <array>
 #include <iostream>
+#include <algorithm>
 #include <numeric>
 #include <cmath>
 #include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+#if defined(__cpp_impl_three_way_comparison) && __cpp_impl_three_way_comparison >= 201907L
+#include <compare>
+#endif
+
+#include "RatioPolicy.hpp"
+#include "RatioGcd.hpp"
+#include "RatioExpression.hpp"
 
 #pragma once
 
 
+/// functions that only run at compile time : consteval in C++20, constexpr before
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define RTO_CONSTEVAL consteval
+#else
+#define RTO_CONSTEVAL constexpr
+#endif
+
+
 // Doxygen menu
 /// \version 0.1
 /// \mainpage
@@ -16,6 +38,7 @@
 /// \subsection dependencies_sec Dependecies
 /// \li Cmake (>=3.13)
 /// \li libgtest-dev (google test)
+/// \li libbenchmark-dev (google benchmark)
 /// \li Doxygen (if you want the documentation)
 /// \subsection install_sec Install with cmake (Linux / Mac)
 /// \li go to main dir
@@ -25,6 +48,7 @@
 /// \li make
 /// \li ./example/example (run example)
 /// \li ./UnitTest/UnitTests (run tests)
+/// \li ./Benchmark/RatioBench (run benchmarks, make RatioBenchJson to get them in RatioBench.json)
 /// \li if Doxygen installed: make html
 /// \li The documentation is located in :
 /// 	- [path to build]/INTERFACE/doc/doc-doxygen/html/index.html
@@ -32,52 +56,130 @@
 
 /// \class Ratio
 /// \brief class using rationals to remplace floating-point arithmetic.
+/// \tparam T : integer type of the numerator and the denominator
+/// \tparam Norm : normalization policy (Eager, Deferred or Fused, see RatioPolicy.hpp)
+/// \tparam Overflow : overflow policy (Wrap, Checked, Widen or Saturate, see RatioPolicy.hpp)
 
 namespace rto {
-    template <typename T = int>
+
+    namespace kernel {
+
+        /// \brief absolute value of a real (std::abs is not constexpr)
+        template <typename F>
+        constexpr F absReal(const F &x) {
+            return x < F(0) ? -x : x;
+        }
+
+        /// \brief floor of a non-negative real: std::floor at run time (a single instruction), a truncation
+        /// in constant expressions where std::floor is not constexpr (the reals from 2^63 on are integers
+        /// in float, double and the 64-bit mantissa long double)
+        template <typename F>
+        constexpr F floorReal(const F &x) {
+            if(!constantEvaluated()) {return std::floor(x);}
+            return x < F(9223372036854775808.0) ? static_cast<F>(static_cast<std::int64_t>(x)) : x;
+        }
+    }
+
+    template <typename T = int, typename Norm = Eager, typename Overflow = Wrap>
     class Ratio {
 
     public :
 
+        using value_type = T;
+        using normalization = Norm;
+        using overflow_policy = Overflow;
+
         /// \brief defaultConstructor equal to 0
         /// @return a ratio (0/1)
-        constexpr Ratio() {
-            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
-            m_numerator = static_cast<T>(0);
-            m_denominator = static_cast<T>(1);
+        constexpr Ratio() : m_numerator(static_cast<T>(0)), m_denominator(static_cast<T>(1)) {
+            static_assert(std::numeric_limits<T>::is_integer, "Invalid type; should be an integer");
         };
 
         /// \brief constructor from a numerator and a denominator
         /// \param numerator : the numerator of the requested rational
         /// \param denominator : the denominator of the requested rational
         /// @return a ratio (numerator/denominator)
-        constexpr Ratio(const T &numerator, const T &denominator) {
-            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
-            this->m_numerator=numerator;
-            this->m_denominator=denominator;
+        constexpr Ratio(const T &numerator, const T &denominator) : m_numerator(numerator), m_denominator(denominator) {
+            static_assert(std::numeric_limits<T>::is_integer, "Invalid type; should be an integer");
             this->irreducible();
         }
 
         /// @brief Constructor which transforms a real into a Ratio
         /// @param real : a number to convert into a ratio
-        /// @return a ratio equal to the real
+        /// @return the closest ratio to the real that fits in T (see fromReal)
+        /// (only for numbers : a Fused expression converts itself with Node::operator Ratio)
+        template <typename U, typename = std::enable_if_t<std::is_arithmetic_v<U>>>
+        constexpr Ratio(const U &real) : Ratio(fromReal(real)) {}
+
+        /// \brief best rational approximation of a real, with a bound on the denominator
+        /// (iterative continued fraction: O(log maxDenominator) steps, no gcd, the last convergent
+        /// is replaced by the best semiconvergent when the next one does not fit)
+        /// \param real : a number to convert into a ratio
+        /// \param maxDenominator : largest denominator allowed (the largest T by default)
+        /// \param tolerance : stop at the first convergent closer than tolerance to the real
+        /// (never below the precision of U, so that 0.1 gives 1/10)
+        /// @return the closest ratio to real with a denominator up to maxDenominator, clamped to +-max/1
+        /// (for an unbounded T, like BigInt, there is no bound by default and a real that has no close
+        /// enough approximation on 64 bits gives its exact value)
         template <typename U>
-        constexpr Ratio(const U &real) {
-            static_assert(std::is_arithmetic_v<T>, "Invalid type; should be a number");
-            uint nb_iter=100;
-            int sign = real < static_cast<U>(0) ? -1 : 1;
-            *this = Ratio(sign,1) * convertRealToRatio<U>(std::abs(real),nb_iter);
-            this->irreducible();
+        static constexpr Ratio fromReal(const U &real, const T &maxDenominator = std::numeric_limits<T>::max(), const U &tolerance = U(0)) {
+            static_assert(std::is_arithmetic_v<U>, "Invalid type; should be a number");
+            if constexpr (std::is_integral_v<U>) {
+                return Ratio(static_cast<T>(real), static_cast<T>(1));
+            } else if constexpr (!std::numeric_limits<T>::is_bounded) {
+                constexpr std::int64_t smallMax = std::numeric_limits<std::int64_t>::max();
+                const bool bounded = maxDenominator > T(0) && maxDenominator < T(smallMax);
+                const Ratio<std::int64_t> small = Ratio<std::int64_t>::fromReal(real, bounded ? static_cast<std::int64_t>(maxDenominator) : smallMax, tolerance);
+                const Ratio approximation(static_cast<T>(small.numerator()), static_cast<T>(small.denominator()));
+                const U error = std::abs(real - static_cast<U>(small.numerator()) / static_cast<U>(small.denominator()));
+                Ratio exact;
+                if(bounded || error <= std::max(tolerance, std::numeric_limits<U>::epsilon() * std::abs(real)) || !convertExact(real, exact)) {
+                    return approximation;
+                }
+                return exact;
+            } else {
+                assert(maxDenominator > T(0) && "maxDenominator should be positive");
+                return convertRealToRatio(real, maxDenominator, tolerance);
+            }
         }
 
-        /// \brief copyConstructor
-        /// \param rat : Ratio copied
-        /// @return the ratio
-        constexpr Ratio(const Ratio &rat) {
-            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
-            m_numerator = rat.m_numerator;
-            m_denominator = rat.m_denominator;
-        };
+        /// \brief exact value of a float or a double, from its IEEE-754 bits: mantissa * 2^exponent,
+        /// reduced by shifting out the trailing zeros of the mantissa (no gcd, no loop)
+        /// \param real : a finite float or double
+        /// \throw std::overflow_error if the exact value does not fit in T (std::domain_error for NaN)
+        /// @return the ratio equal to real
+        template <typename U>
+        static Ratio fromExact(const U &real) {
+            Ratio result;
+            if(!convertExact(real, result)) {
+                if(std::isnan(real)) {throw std::domain_error("rto::Ratio : NaN has no exact value");}
+                throw std::overflow_error("rto::Ratio : exact value does not fit in the integer type");
+            }
+            return result;
+        }
+
+        /// \brief batch version of fromExact: the reals that do not fit are replaced by their
+        /// closest ratio (see fromReal) and counted instead of throwing
+        /// \param reals : floats or doubles
+        /// \param size : number of reals
+        /// \param result : the ratios (size elements)
+        /// @return the number of reals that were not converted exactly
+        template <typename U>
+        static std::size_t fromExact(const U *reals, std::size_t size, Ratio *result) {
+            std::size_t inexact = 0;
+            for(std::size_t i=0; i<size; ++i) {
+                if(!convertExact(reals[i], result[i])) {
+                    result[i] = fromReal(reals[i]);
+                    ++inexact;
+                }
+            }
+            return inexact;
+        }
+
+        /// \brief copy and move constructors, defaulted : for a built-in T, Ratio is trivially copyable
+        /// (std::vector copies and grows it with memcpy) and standard-layout
+        constexpr Ratio(const Ratio &rat) = default;
+        constexpr Ratio(Ratio &&rat) = default;
 
         /// \brief destructor
         ~Ratio() = default;
@@ -87,6 +189,117 @@ namespace rto {
         T m_numerator;
         T m_denominator;
 
+        /// \brief type of the intermediates of the operators (wider than T for Widen and Saturate)
+        using wide_type = typename Overflow::template wide_type<T>;
+
+        /// \brief count an operator result, and how close its intermediates came to overflowing T
+        /// (only compiled in with RTO_INSTRUMENTATION, see RatioStats.hpp)
+        /// \param operation : the operator
+        /// \param numerator : the wide numerator
+        /// \param denominator : the wide denominator
+        static constexpr void record(stats::Operation operation, const wide_type &numerator, const wide_type &denominator) {
+            if constexpr (std::numeric_limits<T>::is_bounded) {
+                const int width = std::max(kernel::bitWidth(kernel::magnitude(numerator)), kernel::bitWidth(kernel::magnitude(denominator)));
+                stats::operation(operation, width, std::numeric_limits<T>::digits);
+            } else {
+                stats::operation(operation, 0, std::numeric_limits<int>::max());
+            }
+        }
+
+        /// \brief bring a wide result back to T according to the overflow policy
+        /// \tparam Op : the operator computing the result
+        /// \param numerator : the wide numerator
+        /// \param denominator : the wide denominator
+        /// @return the ratio, not normalized
+        template <stats::Operation Op>
+        static constexpr Ratio narrow(const wide_type &numerator, const wide_type &denominator) {
+            if constexpr (stats::enabled) {
+                record(Op, numerator, denominator);
+            }
+            Ratio rat;
+            Overflow::narrow(numerator, denominator, rat.m_numerator, rat.m_denominator);
+            return rat;
+        }
+
+        /// \brief build the result of an operator, normalized according to the policy
+        /// \tparam Op : the operator computing the result
+        /// \param numerator : the raw numerator
+        /// \param denominator : the raw denominator
+        /// @return the ratio
+        template <stats::Operation Op>
+        static constexpr Ratio build(const wide_type &numerator, const wide_type &denominator) {
+            Ratio rat = narrow<Op>(numerator, denominator);
+            if constexpr (std::is_same_v<Norm, Deferred>) {
+                if(Deferred::needsNormalization(rat.m_numerator, rat.m_denominator)) {
+                    rat.irreducible();
+                } else {
+                    stats::normalization(false);
+                }
+            } else {
+                rat.irreducible();
+            }
+            return rat;
+        }
+
+        /// \brief product of two irreducible ratios, cross-cancelling first (Knuth, TAOCP 4.5.1):
+        /// gcd(a,d) and gcd(c,b) are removed before multiplying, so the intermediates stay small
+        /// and the result is already irreducible
+        /// \tparam Op : the operator computing the product (Multiply, or Divide by the inverse)
+        /// \param left : the ratio a/b
+        /// \param right : the ratio c/d
+        /// @return the irreducible product
+        template <stats::Operation Op>
+        static constexpr Ratio multiplyIrreducible(const Ratio &left, const Ratio &right) {
+            const T g1 = rto::gcd(left.m_numerator, right.m_denominator);
+            const T g2 = rto::gcd(right.m_numerator, left.m_denominator);
+            const wide_type num = Overflow::mul(wide_type(left.m_numerator / g1), wide_type(right.m_numerator / g2));
+            const wide_type den = Overflow::mul(wide_type(left.m_denominator / g2), wide_type(right.m_denominator / g1));
+            return narrow<Op>(num, den);
+        }
+
+        /// \brief sum (or difference) of two irreducible ratios a/b + c/d (Knuth, TAOCP 4.5.1): works on
+        /// d1=gcd(b,d), the result is already irreducible (no gcd at all when b and d are coprime)
+        /// \param left : the ratio a/b
+        /// \param right : the ratio c/d
+        /// @return the irreducible sum (difference if Subtract)
+        template <bool Subtract>
+        static constexpr Ratio addIrreducible(const Ratio &left, const Ratio &right) {
+            const wide_type a = left.m_numerator, b = left.m_denominator;
+            const wide_type c = right.m_numerator, d = right.m_denominator;
+            const T d1 = rto::gcd(left.m_denominator, right.m_denominator);
+            constexpr stats::Operation operation = Subtract ? stats::Operation::Subtract : stats::Operation::Add;
+            Ratio rat;
+            if(d1 == static_cast<T>(1)) {
+                const wide_type ad = Overflow::mul(a, d);
+                const wide_type bc = Overflow::mul(b, c);
+                rat = narrow<operation>(Subtract ? Overflow::sub(ad, bc) : Overflow::add(ad, bc), Overflow::mul(b, d));
+            } else {
+                const wide_type ad = Overflow::mul(a, wide_type(right.m_denominator / d1));
+                const wide_type cb = Overflow::mul(c, wide_type(left.m_denominator / d1));
+                const wide_type t = Subtract ? Overflow::sub(ad, cb) : Overflow::add(ad, cb);
+                const T d2 = rto::gcd(static_cast<T>(t % wide_type(d1)), d1);
+                rat = narrow<operation>(t / wide_type(d2), Overflow::mul(wide_type(left.m_denominator / d1), wide_type(right.m_denominator / d2)));
+            }
+            return rat;
+        }
+
+        /// \brief product *this * rat, with the normalization policy
+        /// \tparam Op : the operator computing the product (Multiply, or Divide by the inverse)
+        /// \param rat : the rational
+        /// @return the ratio (an expression node for Fused)
+        template <stats::Operation Op>
+        constexpr auto product(const Ratio &rat) const {
+            if constexpr (std::is_same_v<Norm, Fused>) {
+                return expr::Node<expr::Mul, Ratio, Ratio>(*this, rat);
+            } else if constexpr (std::is_same_v<Norm, Eager>) {
+                return multiplyIrreducible<Op>(*this, rat);
+            } else {
+                const wide_type num = Overflow::mul(wide_type(this->m_numerator), wide_type(rat.m_numerator));
+                const wide_type den = Overflow::mul(wide_type(this->m_denominator), wide_type(rat.m_denominator));
+                return build<Op>(num, den);
+            }
+        }
+
     public :
 
         /// \brief get numerator
@@ -108,7 +321,8 @@ namespace rto {
         /// \brief transforms a Ratio into an irreducible fraction
         /// @return void
         constexpr void irreducible() {
-            T pgcd = std::gcd(this->m_numerator,this->m_denominator);
+            stats::normalization(true);
+            T pgcd = rto::gcd(this->m_numerator,this->m_denominator);
             this->m_numerator=this->m_numerator/pgcd;
             this->m_denominator=this->m_denominator/pgcd;
         }
@@ -125,82 +339,134 @@ namespace rto {
             this->m_denominator=temp;
         }
 
-        /// \brief operator =
-        /// \param rat : the rational
-        /// @return void
-        constexpr void operator=(const Ratio &rat) {
-            this->m_numerator=rat.m_numerator;
-            this->m_denominator=rat.m_denominator;
-        }
+        /// \brief copy and move assignments, defaulted
+        /// @return *this
+        constexpr Ratio & operator=(const Ratio &rat) = default;
+        constexpr Ratio & operator=(Ratio &&rat) = default;
 
         /// \brief operator *
         /// \param rat : the rational
         /// @return the ratio
-        constexpr Ratio operator*(const Ratio &rat) const {
-            T num = this->m_numerator * rat.m_numerator;
-            T den = this->m_denominator * rat.m_denominator;
-            return Ratio(num, den);
+        constexpr auto operator*(const Ratio &rat) const {
+            return product<stats::Operation::Multiply>(rat);
         }
 
         /// \brief operator +
         /// \param rat : the rational
         /// @return the ratio
-        constexpr Ratio operator+(const Ratio &rat) const {
-            T num = this->m_numerator * rat.m_denominator + this->m_denominator * rat.m_numerator;
-            T den = this->m_denominator * rat.m_denominator;
-            return Ratio(num, den);
+        constexpr auto operator+(const Ratio &rat) const {
+            if constexpr (std::is_same_v<Norm, Fused>) {
+                return expr::Node<expr::Add, Ratio, Ratio>(*this, rat);
+            } else if constexpr (std::is_same_v<Norm, Eager>) {
+                return addIrreducible<false>(*this, rat);
+            } else {
+                const wide_type num = Overflow::add(Overflow::mul(wide_type(this->m_numerator), wide_type(rat.m_denominator)),
+                                                    Overflow::mul(wide_type(this->m_denominator), wide_type(rat.m_numerator)));
+                const wide_type den = Overflow::mul(wide_type(this->m_denominator), wide_type(rat.m_denominator));
+                return build<stats::Operation::Add>(num, den);
+            }
         }
 
         /// \brief operator -
         /// \param r : the rational
         /// @return the ratio
-        constexpr Ratio operator-(const Ratio &rat) const {
-            T num = this->m_numerator * rat.m_denominator - this->m_denominator * rat.m_numerator;
-            T den = this->m_denominator * rat.m_denominator;
-            return Ratio(num, den);
+        constexpr auto operator-(const Ratio &rat) const {
+            if constexpr (std::is_same_v<Norm, Fused>) {
+                return expr::Node<expr::Sub, Ratio, Ratio>(*this, rat);
+            } else if constexpr (std::is_same_v<Norm, Eager>) {
+                return addIrreducible<true>(*this, rat);
+            } else {
+                const wide_type num = Overflow::sub(Overflow::mul(wide_type(this->m_numerator), wide_type(rat.m_denominator)),
+                                                    Overflow::mul(wide_type(this->m_denominator), wide_type(rat.m_numerator)));
+                const wide_type den = Overflow::mul(wide_type(this->m_denominator), wide_type(rat.m_denominator));
+                return build<stats::Operation::Subtract>(num, den);
+            }
         }
 
         /// \brief operator /
         /// \param rat : the rational
         /// @return the ratio
-        constexpr Ratio operator/(Ratio rat) const {
+        constexpr auto operator/(Ratio rat) const {
             assert(rat.m_numerator!=0 && "Can't divide by 0"); 
             rat.inverse();
-            return *this*rat;
+            return product<stats::Operation::Divide>(rat);
+        }
+
+        /// \brief three-way comparison by cross-multiplication, a/b ? c/d <=> a*d ? c*b, in the wider
+        /// integer type when there is one (exact, no division, works on non reduced ratios).
+        /// Without a wider type (128-bit T, BigInt) the products are first compared in double, and the
+        /// exact comparison only runs when the doubles are too close to decide.
+        /// \param rat : the rational
+        /// @return -1 if *this < rat, 0 if they are equal, 1 if *this > rat
+        constexpr int compare(const Ratio &rat) const {
+            int sign = 1;
+            if constexpr (std::numeric_limits<T>::is_signed) {
+                if((this->m_denominator < T(0)) != (rat.m_denominator < T(0))) {sign = -1;}
+            }
+            if constexpr (overflow::hasWider<T>()) {
+                using W = typename overflow::wider<T>::type;
+                const W left = W(this->m_numerator) * W(rat.m_denominator);
+                const W right = W(rat.m_numerator) * W(this->m_denominator);
+                return sign * ((left > right) - (left < right));
+            } else if constexpr (!std::numeric_limits<T>::is_bounded) {
+                const int filtered = compareFiltered(rat);
+                if(filtered != 0) {return sign * filtered;}
+                const T left = this->m_numerator * rat.m_denominator;
+                const T right = rat.m_numerator * this->m_denominator;
+                return sign * ((left > right) - (left < right));
+            } else {
+                const int filtered = compareFiltered(rat);
+                if(filtered != 0) {return sign * filtered;}
+                return compareExact(rat);
+            }
+        }
+
+    #if defined(__cpp_impl_three_way_comparison) && __cpp_impl_three_way_comparison >= 201907L
+        /// \brief operator <=>
+        /// \param rat : the rational
+        /// @return the ordering of *this and rat (see compare)
+        constexpr std::strong_ordering operator<=>(const Ratio& rat) const {
+            return this->compare(rat) <=> 0;
         }
+    #endif
 
         /// \brief operator <=
         /// \param rat : the rational
         /// @return result
         constexpr bool operator<=(const Ratio& rat) const {
-            return (this->m_numerator / this->m_denominator) <= (rat.m_numerator / rat.m_denominator);
+            return this->compare(rat) <= 0;
         }
 
         /// \brief operator >=
         /// \param rat : the rational
         /// @return result
         constexpr bool operator>=(const Ratio& rat) const {
-            return (this->m_numerator / this->m_denominator) >= (rat.m_numerator / rat.m_denominator);
+            return this->compare(rat) >= 0;
         }
 
         /// \brief operator <
         /// \param rat : the rational
         /// @return result
         constexpr bool operator<(const Ratio& rat) const {
-            return (this->m_numerator / this->m_denominator) < (rat.m_numerator / rat.m_denominator);
+            return this->compare(rat) < 0;
         }
 
         /// \brief operator >
         /// \param rat : the rational
         /// @return result
         constexpr bool operator>(const Ratio& rat) const {
-            return (this->m_numerator / this->m_denominator) > (rat.m_numerator / rat.m_denominator);
+            return this->compare(rat) > 0;
         }
 
         /// \brief operator ==
         /// \param rat : the rational
         /// @return result
         constexpr bool operator==(const Ratio& rat) const {
+            if constexpr (std::is_same_v<Norm, Deferred>) {
+                Ratio left(this->m_numerator, this->m_denominator);
+                Ratio right(rat.m_numerator, rat.m_denominator);
+                return (left.m_numerator == right.m_numerator) && (left.m_denominator == right.m_denominator);
+            }
             return (this->m_numerator == rat.m_numerator) && (this->m_denominator == rat.m_denominator);
         }
 
@@ -208,7 +474,7 @@ namespace rto {
         /// \param rat : the rational
         /// @return result
         constexpr bool operator!=(const Ratio& rat) const {
-            return (this->m_numerator / this->m_denominator) != (rat.m_numerator / rat.m_denominator);
+            return !(*this == rat);
         }
 
 
@@ -217,9 +483,9 @@ namespace rto {
         /// \param value : the number
         /// @return a ratio
         template <typename U>
-        constexpr friend Ratio operator*(const Ratio &rat, const U &value) {
+        constexpr friend auto operator*(const Ratio &rat, const U &value) {
             static_assert(std::is_arithmetic_v<U>, "Invalid type; should be a number");
-            rto::Ratio val(value);
+            Ratio val(value);
             return rat*val;
         }
 
@@ -228,9 +494,9 @@ namespace rto {
         /// \param value : the number
         /// @return a ratio
         template <typename U>
-        constexpr friend Ratio operator/(const Ratio &rat, const U &value) {
+        constexpr friend auto operator/(const Ratio &rat, const U &value) {
             static_assert(std::is_arithmetic_v<U>, "Invalid type; should be a number");
-            rto::Ratio val(value);
+            Ratio val(value);
             return rat/val;
         }
 
@@ -239,9 +505,9 @@ namespace rto {
         /// \param value : the number
         /// @return a ratio
         template <typename U>
-        constexpr friend Ratio operator+(const Ratio &rat, const U &value) {
+        constexpr friend auto operator+(const Ratio &rat, const U &value) {
             static_assert(std::is_arithmetic_v<U>, "Invalid type; should be a number");
-            rto::Ratio val(value);
+            Ratio val(value);
             return rat+val;
         }
 
@@ -250,16 +516,16 @@ namespace rto {
         /// \param value : the number
         /// @return a ratio
         template <typename U>
-        constexpr friend Ratio operator-(const Ratio &rat, const U &value) {
+        constexpr friend auto operator-(const Ratio &rat, const U &value) {
             static_assert(std::is_arithmetic_v<U>, "Invalid type; should be a number");
-            rto::Ratio val(value);
+            Ratio val(value);
             return rat-val;
         }
 
         /// \brief unary minus
         /// \param rat : ratio
         /// @return -ratio
-        inline friend Ratio operator-(const Ratio &rat) {return Ratio(-rat.m_numerator,rat.m_denominator);}
+        constexpr friend Ratio operator-(const Ratio &rat) {return Ratio(-rat.m_numerator,rat.m_denominator);}
 
         //mathematical fonctions
 
@@ -267,7 +533,10 @@ namespace rto {
         /// \param rat : the rational
         /// @return abs of the rational
         constexpr friend Ratio abs(const Ratio & rat) {
-            return Ratio(std::abs(rat.m_numerator),rat.m_denominator);
+            if constexpr (std::numeric_limits<T>::is_signed) {
+                return Ratio(rat.m_numerator < T(0) ? -rat.m_numerator : rat.m_numerator, rat.m_denominator);
+            }
+            return rat;
         }
 
         /// \brief floor
@@ -308,7 +577,7 @@ namespace rto {
         /// \param rat : the rational
         /// @return exp of the rational
         constexpr friend Ratio exp(const Ratio & rat) {
-            double value=std::exp(rat.m_numerator/rat.m_denominator);
+            double value=std::exp(double(rat.m_numerator)/double(rat.m_denominator));
             return Ratio(value);
         }
 
@@ -319,25 +588,65 @@ namespace rto {
             return Ratio(std::log(double(rat.m_numerator))-std::log(double(rat.m_denominator)));
         }
 
-        /// \brief square_root
-        /// \param rat : the rational
+        /// \brief square root, on integers only: exact when the numerator and the denominator are perfect
+        /// squares, otherwise the continued fraction of sqrt(p q) / q stopped at the best approximation
+        /// with a denominator up to maxDenominator (and a numerator that fits in T)
+        /// \param rat : the rational, not negative
+        /// \param maxDenominator : largest denominator of an approximation
         /// @return sqrt of the rational
-        constexpr friend Ratio sqrt(const Ratio & rat) {
-            return Ratio(pow(rat, 0.5));
+        constexpr friend Ratio sqrt(const Ratio & rat, const T &maxDenominator = std::numeric_limits<T>::max()) {
+            assert(rat.m_numerator >= T(0) && "square root of a negative ratio");
+            if constexpr (overflow::hasWider<T>()) {
+                Ratio reduced = rat;
+                if constexpr (!std::is_same_v<Norm, Eager>) {reduced.irreducible();}
+                const T numeratorRoot = static_cast<T>(kernel::isqrt(kernel::magnitude(reduced.m_numerator)));
+                const T denominatorRoot = static_cast<T>(kernel::isqrt(kernel::magnitude(reduced.m_denominator)));
+                if(numeratorRoot * numeratorRoot == reduced.m_numerator && denominatorRoot * denominatorRoot == reduced.m_denominator
+                   && denominatorRoot <= maxDenominator) {
+                    Ratio result;
+                    result.m_numerator = numeratorRoot;
+                    result.m_denominator = denominatorRoot;
+                    return result;
+                }
+                return convertSqrtToRatio(reduced.m_numerator, reduced.m_denominator, maxDenominator);
+            } else {
+                return fromReal(std::sqrt(static_cast<long double>(rat.m_numerator) / static_cast<long double>(rat.m_denominator)), maxDenominator);
+            }
         }
 
         /// \brief pow
         /// \param rat : the rational
-        /// \param n : a number
+        /// \param n : a number; an integer exponent is computed exactly by square-and-multiply
+        /// on the numerator and the denominator (coprime, so is the result: no gcd), a power that
+        /// does not fit in T follows the overflow policy (wraps, throws std::overflow_error, or is rounded)
         /// @return pow of the rational
         template <typename U>
         constexpr friend Ratio pow(Ratio rat, U n) {
             static_assert(std::is_arithmetic_v<U>, "Invalid type; should be a number");
             if(n<static_cast<U>(0)) {
+                assert(rat.m_numerator != T(0) && "negative power of zero");
                 rat.inverse();
-                n=-n;
             }
-            return Ratio(std::pow(rat.m_numerator,n),std::pow(rat.m_denominator,n));
+            if constexpr (std::is_integral_v<U>) {
+                using E = std::make_unsigned_t<U>;
+                const E exponent = n < static_cast<U>(0) ? E(0) - static_cast<E>(n) : static_cast<E>(n);
+                if constexpr (!std::is_same_v<Norm, Eager>) {rat.irreducible();}
+                Ratio result;
+                const bool numeratorOverflows = overflow::powOverflows(rat.m_numerator, exponent, result.m_numerator);
+                const bool overflows = overflow::powOverflows(rat.m_denominator, exponent, result.m_denominator) || numeratorOverflows;
+                if constexpr (!std::is_same_v<Overflow, Wrap>) {
+                    if(overflows) {
+                        if constexpr (std::is_same_v<Overflow, Saturate>) {
+                            return fromReal(std::pow(static_cast<long double>(rat.m_numerator) / static_cast<long double>(rat.m_denominator), static_cast<long double>(exponent)));
+                        } else {
+                            throw std::overflow_error("rto::Ratio : power does not fit in the integer type");
+                        }
+                    }
+                }
+                return result;
+            } else {
+                return fromReal(std::pow(static_cast<long double>(rat.m_numerator) / static_cast<long double>(rat.m_denominator), static_cast<long double>(n < static_cast<U>(0) ? -n : n)));
+            }
         }
 
         /// \brief overload the operator << for Ratio
@@ -345,29 +654,311 @@ namespace rto {
         /// \param v : the ratio to output
         /// \return the output stream containing the ratio data
         constexpr friend std::ostream& operator<<(std::ostream& stream, const Ratio& r) {
+            if constexpr (std::is_same_v<Norm, Deferred>) {
+                Ratio rat(r.numerator(), r.denominator());
+                stream << "(" << rat.numerator() << "/" << rat.denominator() << ")";
+                return stream;
+            }
             stream << "(" << r.numerator() << "/" << r.denominator() << ")";
             return stream;
         }
 
 
     private : //Utilities
+
+        /// \brief compare a*d and c*b in double: each product is within 3 ulps of the exact one,
+        /// so a relative gap above 2^-50 decides the comparison
+        /// @return -1 or 1 when decided, 0 when the exact comparison is needed
+        constexpr int compareFiltered(const Ratio &rat) const {
+            const double left = static_cast<double>(this->m_numerator) * static_cast<double>(rat.m_denominator);
+            const double right = static_cast<double>(rat.m_numerator) * static_cast<double>(this->m_denominator);
+            const double bound = (kernel::absReal(left) + kernel::absReal(right)) * 0x1p-50;
+            return (left - right > bound) - (right - left > bound);
+        }
+
+        /// \brief exact comparison without any product: compares the integer parts, then the
+        /// inverted remainders (continued fraction expansions of both ratios, Euclid like)
+        /// @return -1, 0 or 1
+        constexpr int compareExact(const Ratio &rat) const {
+            T a = this->m_numerator, b = this->m_denominator;
+            T c = rat.m_numerator, d = rat.m_denominator;
+            if constexpr (std::numeric_limits<T>::is_signed) {
+                if(b < T(0)) {a = -a; b = -b;}
+                if(d < T(0)) {c = -c; d = -d;}
+            }
+            int sign = 1;
+            while(true) {
+                // floor division, so that the remainders are in [0, denominator)
+                T q1 = a / b, q2 = c / d;
+                T r1 = a % b, r2 = c % d;
+                if constexpr (std::numeric_limits<T>::is_signed) {
+                    if(r1 < T(0)) {--q1; r1 += b;}
+                    if(r2 < T(0)) {--q2; r2 += d;}
+                }
+                if(q1 != q2) {return q1 < q2 ? -sign : sign;}
+                if(r1 == T(0) || r2 == T(0)) {return sign * ((r1 != T(0)) - (r2 != T(0)));}
+                // r1/b < r2/d <=> b/r1 > d/r2
+                a = b; c = d;
+                b = r1; d = r2;
+                sign = -sign;
+            }
+        }
         
+        /// \brief exact conversion of a float or a double, see fromExact
+        /// @return false (and result unchanged) if real is not finite or does not fit in T
         template <typename U>
-        constexpr rto::Ratio<T> convertRealToRatio(U real, uint nb_iter) {
-            //1st stopping condition : return 0/1
-            if(real==static_cast<U>(0)){return rto::Ratio();}
+        static bool convertExact(const U &real, Ratio &result) {
+            static_assert(std::is_same_v<U, float> || std::is_same_v<U, double>, "Invalid type; should be a float or a double");
+            using Bits = std::conditional_t<std::is_same_v<U, float>, std::uint32_t, std::uint64_t>;
+            constexpr int mantissaBits = std::numeric_limits<U>::digits - 1;
+            constexpr int exponentBias = std::numeric_limits<U>::max_exponent - 1;
+            constexpr Bits exponentMask = (Bits(1) << (sizeof(U) * 8 - 1 - mantissaBits)) - 1;
+            constexpr int digits = std::numeric_limits<T>::digits;
+
+            Bits bits;
+            std::memcpy(&bits, &real, sizeof(U));
+            const bool negative = (bits >> (sizeof(U) * 8 - 1)) != 0;
+            const Bits biased = (bits >> mantissaBits) & exponentMask;
+            Bits mantissa = bits & ((Bits(1) << mantissaBits) - 1);
+            if(biased == exponentMask) {return false;}
+            if(mantissa == 0 && biased == 0) {
+                result = Ratio();
+                return true;
+            }
 
-            //2nd stopping condition : return 0/1
-            if(nb_iter==0){return rto::Ratio();}
+            // normal numbers have an implicit leading 1, subnormal numbers the exponent of the smallest normal one
+            int exponent = (biased ? static_cast<int>(biased) : 1) - exponentBias - mantissaBits;
+            if(biased) {mantissa |= Bits(1) << mantissaBits;}
+            const int zeros = kernel::countTrailingZeros(mantissa);
+            mantissa >>= zeros;
+            exponent += zeros;
+
+            if constexpr (!std::numeric_limits<T>::is_bounded) {
+                const T numerator = exponent > 0 ? T(mantissa) << static_cast<std::size_t>(exponent) : T(mantissa);
+                result.m_numerator = negative ? -numerator : numerator;
+                result.m_denominator = exponent < 0 ? T(1) << static_cast<std::size_t>(-exponent) : T(1);
+                return true;
+            } else {
+                using UT = typename kernel::unsignedOf<T>::type;
+                const int width = kernel::bitWidth(mantissa);
+                if((negative && std::is_unsigned_v<T>) || width + (exponent > 0 ? exponent : 0) > digits || -exponent >= digits) {return false;}
+
+                const UT numerator = exponent > 0 ? UT(mantissa) << exponent : UT(mantissa);
+                result.m_numerator = negative ? static_cast<T>(UT(0) - numerator) : static_cast<T>(numerator);
+                result.m_denominator = exponent < 0 ? static_cast<T>(UT(1) << -exponent) : T(1);
+                return true;
+            }
+        }
+        
+        /// \brief continued fraction expansion of a real, keeping the convergents h/k in unsigned integers
+        template <typename U>
+        static constexpr Ratio convertRealToRatio(const U &real, const T &maxDenominator, const U &tolerance) {
+            using F = std::conditional_t<std::is_same_v<U, long double>, long double, double>;
+            using UT = typename kernel::unsignedOf<T>::type;
+            constexpr UT maxNumerator = static_cast<UT>(std::numeric_limits<T>::max());
+            const UT maxDen = static_cast<UT>(maxDenominator);
+
+            const F value = static_cast<F>(real);
+            if(value != value) {return Ratio();}
+            const bool negative = value < F(0);
+            if constexpr (std::is_unsigned_v<T>) {
+                assert(!negative && "negative real for an unsigned Ratio");
+            }
+            const F absValue = negative ? -value : value;
+            const F precision = std::max(static_cast<F>(tolerance), std::numeric_limits<U>::epsilon() * absValue);
+
+            Ratio result;
+            int steps = 0;
+            bool bounded = true;
+            if(!(absValue < static_cast<F>(maxNumerator))) {
+                // too large (or infinite) : clamp
+                result.m_numerator = std::numeric_limits<T>::max();
+            } else {
+                bounded = false;
+                // h1/k1 last convergent, h2/k2 the previous one
+                UT h1 = 1, k1 = 0, h2 = 0, k2 = 1;
+                F x = absValue;
+                for(int i=0; i<2*std::numeric_limits<UT>::digits; ++i) {
+                    ++steps;
+                    const F digit = kernel::floorReal(x);
+                    UT a = static_cast<UT>(digit);
+                    UT h{}, k{};
+                    const bool fits = !(digit > static_cast<F>(maxNumerator))
+                                   && !overflow::mulOverflows(a, h1, h) && !overflow::addOverflows(h, h2, h) && h <= maxNumerator
+                                   && !overflow::mulOverflows(a, k1, k) && !overflow::addOverflows(k, k2, k) && k <= maxDen;
+                    if(!fits) {
+                        // largest a' < a that keeps the semiconvergent (a'h1+h2)/(a'k1+k2) in bounds
+                        a = k1 ? (maxDen - k2) / k1 : maxNumerator;
+                        if(h1) {a = std::min<UT>(a, (maxNumerator - h2) / h1);}
+                        if(a > UT(0) && k1 > UT(0)) {
+                            h = a * h1 + h2;
+                            k = a * k1 + k2;
+                            const F semiError = kernel::absReal(absValue - static_cast<F>(h) / static_cast<F>(k));
+                            const F error = kernel::absReal(absValue - static_cast<F>(h1) / static_cast<F>(k1));
+                            if(semiError < error) {
+                                h1 = h;
+                                k1 = k;
+                            }
+                        }
+                        bounded = true;
+                        break;
+                    }
+                    h2 = h1; h1 = h;
+                    k2 = k1; k1 = k;
+
+                    const F remainder = x - digit;
+                    if(remainder == F(0) || kernel::absReal(absValue - static_cast<F>(h1) / static_cast<F>(k1)) <= precision) {break;}
+                    x = F(1) / remainder;
+                }
+                result.m_numerator = static_cast<T>(h1);
+                result.m_denominator = static_cast<T>(k1);
+            }
+            stats::conversion(steps, bounded);
+            if constexpr (std::is_signed_v<T>) {
+                if(negative) {result.m_numerator = -result.m_numerator;}
+            }
+            return result;
+        }
 
-            //case |real|<1
-            if(real < static_cast<U>(1)) {
-                rto::Ratio rat=convertRealToRatio<U>(static_cast<U>(1)/real,nb_iter);
-                rat.inverse();
-                return rat;
-            } else { //case |real|>=1
-                int q=floor(real);
-                return (rto::Ratio(q,1) + convertRealToRatio<U>(real-q, nb_iter-1));
+        /// \brief continued fraction expansion of sqrt(numerator/denominator) = sqrt(D)/denominator, D = numerator*denominator,
+        /// on exact integers : the complete quotients are (P + sqrt(D))/Q with Q dividing D - P^2 (P < sqrt(D), 0 < Q < 2 sqrt(D)),
+        /// only the first step divides D, the next ones use Q' = Q" + a (P - P') on integers of the size of T
+        static constexpr Ratio convertSqrtToRatio(const T &numerator, const T &denominator, const T &maxDenominator) {
+            using W = typename kernel::unsignedOf<typename overflow::wider<T>::type>::type;
+            using UT = typename kernel::unsignedOf<T>::type;
+            // P + sqrt(D) < 2^digits(T) + 1 : the unsigned T holds P and Q for a signed T
+            using V = std::conditional_t<std::is_signed_v<T>, UT, W>;
+            constexpr UT maxNumerator = static_cast<UT>(std::numeric_limits<T>::max());
+            const UT maxDen = static_cast<UT>(maxDenominator);
+            assert(maxDenominator > T(0) && "maxDenominator should be positive");
+
+            const W D = static_cast<W>(numerator) * static_cast<W>(denominator);
+            const V root = static_cast<V>(kernel::isqrt(D));
+            V P = 0, Q = static_cast<V>(denominator), previousQ = 0;
+            // h1/k1 last convergent, h2/k2 the previous one
+            UT h1 = 1, k1 = 0, h2 = 0, k2 = 1;
+            int steps = 0;
+            while(true) {
+                ++steps;
+                const V digit = (P + root) / Q;
+                UT a = static_cast<UT>(digit);
+                UT h{}, k{};
+                const bool fits = digit <= static_cast<V>(maxNumerator)
+                               && !overflow::mulOverflows(a, h1, h) && !overflow::addOverflows(h, h2, h) && h <= maxNumerator
+                               && !overflow::mulOverflows(a, k1, k) && !overflow::addOverflows(k, k2, k) && k <= maxDen;
+                if(!fits) {
+                    // largest a' < a that keeps the semiconvergent (a'h1+h2)/(a'k1+k2) in bounds : it is closer than h1/k1
+                    // when 2a' > a, or when 2a' = a and the complete quotient x is below a + k2/k1
+                    UT semi = k1 ? (maxDen - k2) / k1 : maxNumerator;
+                    if(h1) {semi = std::min<UT>(semi, (maxNumerator - h2) / h1);}
+                    const W twice = static_cast<W>(semi) * 2;
+                    if(k1 > UT(0) && semi > UT(0) && twice >= static_cast<W>(digit)) {
+                        bool closer = twice > static_cast<W>(digit);
+                        if(!closer) {
+                            // sqrt(D) from root by one Newton step, only to break the tie
+                            const W wideRoot = static_cast<W>(root);
+                            const long double sqrtD = static_cast<long double>(root) + static_cast<long double>(D - wideRoot * wideRoot) / static_cast<long double>(2 * wideRoot + 1);
+                            const long double x = (static_cast<long double>(P) + sqrtD) / static_cast<long double>(Q);
+                            closer = x < static_cast<long double>(digit) + static_cast<long double>(k2) / static_cast<long double>(k1);
+                        }
+                        if(closer) {
+                            h1 = semi * h1 + h2;
+                            k1 = semi * k1 + k2;
+                        }
+                    }
+                    break;
+                }
+                h2 = h1; h1 = h;
+                k2 = k1; k1 = k;
+                const V nextP = digit * Q - P;
+                // the differences are taken modulo 2^bits : the result is exact
+                const V nextQ = steps == 1 ? static_cast<V>((D - static_cast<W>(nextP) * static_cast<W>(nextP)) / static_cast<W>(Q))
+                                           : static_cast<V>(previousQ + digit * (P - nextP));
+                previousQ = Q;
+                P = nextP;
+                Q = nextQ;
+            }
+            stats::conversion(steps, true);
+            Ratio result;
+            result.m_numerator = static_cast<T>(h1);
+            result.m_denominator = static_cast<T>(k1);
+            return result;
+        }
+    };
+
+    /// \brief strict weak ordering of ratios for std::sort, std::lower_bound, std::map...
+    /// (a single compare() per call: one widened cross-multiplication, no division)
+    struct RatioLess {
+        template <typename T, typename Norm, typename Overflow>
+        constexpr bool operator()(const Ratio<T,Norm,Overflow> &left, const Ratio<T,Norm,Overflow> &right) const {
+            return left.compare(right) < 0;
+        }
+    };
+
+    /// \brief table of N values computed by a function of the index, to build the tables of coefficients
+    /// at compile time : constexpr auto inverses = rto::make_table<16>([](std::size_t i) {return Ratio<int>(1, int(i) + 1);});
+    /// (consteval in C++20, so that it can never run at startup)
+    /// \tparam N : number of values
+    /// \param f : a constexpr function of the index (0 to N-1)
+    /// @return std::array of the N values
+    template <std::size_t N, typename F>
+    RTO_CONSTEVAL auto make_table(F f) {
+        std::array<decltype(f(std::size_t(0))), N> table{};
+        for(std::size_t i=0; i<N; ++i) {table[i] = f(i);}
+        return table;
+    }
+
+    namespace kernel {
+
+        /// \brief 64-bit finalizer of splitmix64 : every input bit changes half of the output bits
+        constexpr std::uint64_t mix(std::uint64_t x) {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        /// \brief hash of an irreducible numerator and denominator, the sign is carried by the numerator
+        /// \param numerator : the numerator
+        /// \param denominator : the denominator
+        /// @return the hash, equal for n/-d and -n/d
+        template <typename T>
+        constexpr std::uint64_t hashRatio(const T &numerator, const T &denominator) {
+            if constexpr (std::is_integral_v<T> && sizeof(T) <= 8) {
+                using U = std::make_unsigned_t<T>;
+                U num = static_cast<U>(numerator), den = static_cast<U>(denominator);
+                if constexpr (std::is_signed_v<T>) {
+                    if(denominator < T(0)) {
+                        num = U(0) - num;
+                        den = U(0) - den;
+                    }
+                }
+                if constexpr (sizeof(T) <= 4) {
+                    return mix((static_cast<std::uint64_t>(num) << 32) | static_cast<std::uint64_t>(den));
+                } else {
+                    return mix(static_cast<std::uint64_t>(num) * 0x9e3779b97f4a7c15ULL + mix(static_cast<std::uint64_t>(den)));
+                }
+            } else {
+                const bool negative = denominator < T(0);
+                const std::uint64_t num = std::hash<T>{}(negative ? -numerator : numerator);
+                const std::uint64_t den = std::hash<T>{}(negative ? -denominator : denominator);
+                return mix(num * 0x9e3779b97f4a7c15ULL + mix(den));
+            }
+        }
+    }
+}
+
+namespace std {
+
+    /// \brief hash of a ratio, for std::unordered_map and std::unordered_set : computed on the irreducible
+    /// form (Deferred ratios are reduced first), so that equal ratios have equal hashes
+    template <typename T, typename Norm, typename Overflow>
+    struct hash<rto::Ratio<T,Norm,Overflow>> {
+        std::size_t operator()(const rto::Ratio<T,Norm,Overflow> &rat) const noexcept {
+            if constexpr (std::is_same_v<Norm, rto::Deferred>) {
+                const rto::Ratio<T,Norm,Overflow> reduced(rat.numerator(), rat.denominator());
+                return static_cast<std::size_t>(rto::kernel::hashRatio(reduced.numerator(), reduced.denominator()));
+            } else {
+                return static_cast<std::size_t>(rto::kernel::hashRatio(rat.numerator(), rat.denominator()));
             }
         }
     };
@@ -0,0 +1,251 @@
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \class RatioAccumulator
+/// \brief exact running sum of ratios for streaming aggregation : the sum is kept as a numerator and a
+/// common denominator in the wider integer type (int64 for int32, __int128 for int64), not normalized
+/// after every add like a chain of Ratio::operator+.
+/// \li a value whose denominator divides the common one (the usual case: prices in cents, readings in 1/1024,
+/// ratios with small denominators once their lcm is reached) costs a division and a multiply-add, no gcd
+/// \li other values extend the common denominator to the lcm (one gcd)
+/// \li the sum is reduced only when an intermediate would overflow the wider type, and by result()
+/// \li merge() adds the partial sum of another accumulator (one per thread, merged at the end)
+/// Sums that do not fit in the wider type, even reduced, throw std::overflow_error; so do the results
+/// that do not fit in T.
+/// \tparam T : integer type of the ratios added and of the results
+
+namespace rto {
+
+    template <typename T = int>
+    class RatioAccumulator {
+
+        static_assert(std::is_integral_v<T>, "Invalid type; should be an integer");
+        static_assert(overflow::hasWider<T>(), "Invalid type; needs a wider integer type");
+
+    public :
+
+        using value_type = T;
+        using wide_type = typename overflow::wider<T>::type;
+
+        /// \brief defaultConstructor, empty sum (0/1)
+        RatioAccumulator() = default;
+
+        /// \brief add a ratio
+        /// \param value : the ratio (not necessarily irreducible)
+        template <typename Norm, typename Overflow>
+        void add(const Ratio<T,Norm,Overflow> &value) {
+            assert(value.denominator() != T(0) && "Denominator cannot be equal to 0");
+            if constexpr (std::is_signed_v<T>) {
+                if(value.denominator() < T(0)) {
+                    addWide(-wide_type(value.numerator()), -wide_type(value.denominator()));
+                    ++m_count;
+                    return;
+                }
+            }
+            addWide(wide_type(value.numerator()), wide_type(value.denominator()));
+            ++m_count;
+        }
+
+        /// \brief add a ratio
+        /// \param value : the ratio
+        /// @return *this
+        template <typename Norm, typename Overflow>
+        RatioAccumulator & operator+=(const Ratio<T,Norm,Overflow> &value) {
+            add(value);
+            return *this;
+        }
+
+        /// \brief add the product of a value and its weight (computed exactly in the wider type)
+        /// \param value : the ratio
+        /// \param weight : its weight
+        template <typename Norm, typename Overflow>
+        void addProduct(const Ratio<T,Norm,Overflow> &value, const Ratio<T,Norm,Overflow> &weight) {
+            wide_type numerator = wide_type(value.numerator()) * wide_type(weight.numerator());
+            wide_type denominator = wide_type(value.denominator()) * wide_type(weight.denominator());
+            assert(denominator != wide_type(0) && "Denominator cannot be equal to 0");
+            if constexpr (std::is_signed_v<T>) {
+                if(denominator < wide_type(0)) {
+                    numerator = -numerator;
+                    denominator = -denominator;
+                }
+            }
+            addWide(numerator, denominator);
+            ++m_count;
+        }
+
+        /// \brief add the partial sum of another accumulator
+        /// \param other : the accumulator (of another thread)
+        void merge(const RatioAccumulator &other) {
+            addWide(other.m_numerator, other.m_denominator);
+            m_count += other.m_count;
+        }
+
+        /// \brief the sum
+        /// \throw std::overflow_error if the irreducible sum does not fit in T
+        /// @return the irreducible sum, with a positive denominator
+        Ratio<T> result() const {
+            return narrow(m_numerator, m_denominator);
+        }
+
+        /// \brief the arithmetic mean of the values added (merged accumulators count their values)
+        /// \throw std::overflow_error if the irreducible mean does not fit in T (or its denominator in the wider type)
+        /// @return sum / count
+        Ratio<T> mean() const {
+            assert(m_count > 0 && "Mean of no value");
+            return quotient(m_numerator, m_denominator, static_cast<wide_type>(m_count), wide_type(1));
+        }
+
+        /// \brief quotient of two sums, for weighted means : sum of the products / sum of the weights
+        /// \param divisor : the accumulator of the weights
+        /// \throw std::overflow_error if the irreducible quotient does not fit in T
+        /// @return the irreducible quotient
+        Ratio<T> divide(const RatioAccumulator &divisor) const {
+            assert(divisor.m_numerator != wide_type(0) && "Division by 0");
+            return quotient(m_numerator, m_denominator, divisor.m_numerator, divisor.m_denominator);
+        }
+
+        /// \brief number of values added
+        std::size_t count() const {return m_count;}
+
+        /// \brief current numerator and common denominator (not reduced)
+        const wide_type & numerator() const {return m_numerator;}
+        const wide_type & denominator() const {return m_denominator;}
+
+        /// \brief back to the empty sum
+        void clear() {
+            m_numerator = wide_type(0);
+            m_denominator = wide_type(1);
+            m_count = 0;
+        }
+
+    private :
+
+        wide_type m_numerator = wide_type(0);
+        wide_type m_denominator = wide_type(1);
+        std::size_t m_count = 0;
+
+        /// \brief add numerator/denominator (positive denominator)
+        void addWide(const wide_type &numerator, const wide_type &denominator) {
+            // the builtins store the wrapped value on overflow : the sum is only written when it fits
+            wide_type sum{};
+            if(denominator == m_denominator) {
+                if(!overflow::addOverflows(m_numerator, numerator, sum)) {
+                    m_numerator = sum;
+                    return;
+                }
+            } else {
+                const wide_type factor = m_denominator / denominator;
+                if(factor * denominator == m_denominator
+                   && !overflow::mulOverflows(numerator, factor, sum)
+                   && !overflow::addOverflows(m_numerator, sum, sum)) {
+                    m_numerator = sum;
+                    return;
+                }
+            }
+            addSlow(numerator, denominator);
+        }
+
+        /// \brief add on the lcm of the denominators, reducing the sum first if it overflows
+        void addSlow(wide_type numerator, wide_type denominator) {
+            for(int attempt=0; attempt<2; ++attempt) {
+                const wide_type g = rto::gcd(m_denominator, denominator);
+                const wide_type left = denominator / g, right = m_denominator / g;
+                wide_type common{}, a{}, b{}, sum{};
+                if(!overflow::mulOverflows(m_denominator, left, common)
+                   && !overflow::mulOverflows(m_numerator, left, a)
+                   && !overflow::mulOverflows(numerator, right, b)
+                   && !overflow::addOverflows(a, b, sum)) {
+                    m_numerator = sum;
+                    m_denominator = common;
+                    return;
+                }
+                // near the limit of the wider type : reduce both fractions and try again
+                reduce(m_numerator, m_denominator);
+                reduce(numerator, denominator);
+            }
+            throw std::overflow_error("rto::RatioAccumulator : sum does not fit in the wider integer type");
+        }
+
+        static void reduce(wide_type &numerator, wide_type &denominator) {
+            const wide_type g = rto::gcd(numerator, denominator);
+            if(g > wide_type(1)) {
+                numerator /= g;
+                denominator /= g;
+            }
+        }
+
+        /// \brief irreducible numerator/denominator (positive denominator) as a Ratio<T>
+        static Ratio<T> narrow(wide_type numerator, wide_type denominator) {
+            reduce(numerator, denominator);
+            if(!overflow::fits<T>(numerator) || !overflow::fits<T>(denominator)) {
+                throw std::overflow_error("rto::RatioAccumulator : result does not fit in the integer type");
+            }
+            Ratio<T> rat;
+            rat.numerator() = static_cast<T>(numerator);
+            rat.denominator() = static_cast<T>(denominator);
+            return rat;
+        }
+
+        /// \brief (a/b) / (c/d) with positive b and d, cross-cancelled before the products
+        static Ratio<T> quotient(wide_type a, wide_type b, wide_type c, wide_type d) {
+            reduce(a, b);
+            reduce(c, d);
+            const wide_type g1 = rto::gcd(a, c), g2 = rto::gcd(b, d);
+            if(g1 > wide_type(1)) {
+                a /= g1;
+                c /= g1;
+            }
+            if(g2 > wide_type(1)) {
+                b /= g2;
+                d /= g2;
+            }
+            if constexpr (std::is_signed_v<T>) {
+                if(c < wide_type(0)) {
+                    a = -a;
+                    c = -c;
+                }
+            }
+            wide_type numerator{}, denominator{};
+            if(overflow::mulOverflows(a, d, numerator) || overflow::mulOverflows(b, c, denominator)) {
+                throw std::overflow_error("rto::RatioAccumulator : result does not fit in the integer type");
+            }
+            return narrow(numerator, denominator);
+        }
+    };
+
+    /// \brief exact arithmetic mean
+    /// \param values : the ratios (at least one)
+    /// \throw std::overflow_error if the mean does not fit in T
+    /// @return the irreducible mean
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T> mean(const std::vector<Ratio<T,Norm,Overflow>> &values) {
+        RatioAccumulator<T> accumulator;
+        for(const Ratio<T,Norm,Overflow> &value : values) {accumulator.add(value);}
+        return accumulator.mean();
+    }
+
+    /// \brief exact weighted mean, sum(values[i] * weights[i]) / sum(weights[i])
+    /// \param values : the ratios
+    /// \param weights : their weights (same size, non-null sum)
+    /// \throw std::overflow_error if the mean does not fit in T
+    /// @return the irreducible weighted mean
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T> weightedMean(const std::vector<Ratio<T,Norm,Overflow>> &values, const std::vector<Ratio<T,Norm,Overflow>> &weights) {
+        assert(values.size()==weights.size() && "Arrays must have the same size");
+        RatioAccumulator<T> products, sum;
+        for(std::size_t i=0; i<values.size(); ++i) {
+            products.addProduct(values[i], weights[i]);
+            sum.add(weights[i]);
+        }
+        return products.divide(sum);
+    }
+}
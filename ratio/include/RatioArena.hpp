@@ -0,0 +1,266 @@
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#pragma once
+
+
+/// \class RatioArena
+/// \brief memory arena for the limbs of multi-precision ratios (Ratio<BigInt>).
+/// Memory is carved from large chunks by bumping a pointer; freed blocks go to per size class
+/// free lists and are reused by the next allocations of the same class. reset() releases
+/// everything at once, so a batch computation frees in O(1).
+/// An arena is not thread-safe: each thread works with its own (see threadLocal()), and a
+/// RatioArena::Scope makes it the arena used by the BigInt created on this thread.
+/// Every value allocated in a scope must be destroyed before the arena is reset.
+
+namespace rto {
+
+    class RatioArena {
+
+    public :
+
+        /// \brief allocation counters
+        struct Stats {
+            std::size_t allocations = 0;        // blocks handed out
+            std::size_t deallocations = 0;      // blocks given back
+            std::size_t reused = 0;             // allocations served by a free list
+            std::size_t systemAllocations = 0;  // chunks requested from malloc
+            std::size_t bytesReserved = 0;      // total size of the chunks
+            std::size_t bytesInUse = 0;         // size of the blocks not given back
+        };
+
+        /// \brief constructor
+        /// \param chunkSize : size of the first chunk (the next ones are at least as large)
+        /// @return an empty arena, no memory is reserved before the first allocation
+        explicit RatioArena(std::size_t chunkSize = std::size_t(1) << 16) : m_chunkSize(chunkSize) {}
+
+        RatioArena(const RatioArena &) = delete;
+        RatioArena& operator=(const RatioArena &) = delete;
+
+        ~RatioArena() {
+            for(const Chunk &chunk : m_chunks) {std::free(chunk.data);}
+        }
+
+        /// \brief get a block of at least bytes bytes (aligned on alignof(std::max_align_t))
+        /// \param bytes : size of the block
+        /// @return the block
+        void* allocate(std::size_t bytes) {
+            const std::size_t sizeClass = classOf(bytes);
+            const std::size_t size = blockSize(sizeClass);
+            ++m_stats.allocations;
+            m_stats.bytesInUse += size;
+            if(m_freeLists[sizeClass] != nullptr) {
+                FreeBlock *block = m_freeLists[sizeClass];
+                m_freeLists[sizeClass] = block->next;
+                ++m_stats.reused;
+                return block;
+            }
+            if(m_chunks.empty() || m_offset + size > m_chunks[m_current].size) {
+                nextChunk(size);
+            }
+            void *block = m_chunks[m_current].data + m_offset;
+            m_offset += size;
+            return block;
+        }
+
+        /// \brief give a block back, it is reused by the next allocation of the same size class
+        /// \param block : a block returned by allocate
+        /// \param bytes : the size given to allocate
+        void deallocate(void *block, std::size_t bytes) {
+            const std::size_t sizeClass = classOf(bytes);
+            ++m_stats.deallocations;
+            m_stats.bytesInUse -= blockSize(sizeClass);
+            FreeBlock *free = static_cast<FreeBlock*>(block);
+            free->next = m_freeLists[sizeClass];
+            m_freeLists[sizeClass] = free;
+        }
+
+        /// \brief release every block at once. The chunks are kept; when the last batch needed
+        /// several of them, they are merged into a single one so that the next batch of the same
+        /// size does not call malloc at all
+        void reset() {
+            m_freeLists.fill(nullptr);
+            m_current = 0;
+            m_offset = 0;
+            m_stats.bytesInUse = 0;
+            if(m_chunks.size() > 1) {
+                std::size_t total = 0;
+                for(const Chunk &chunk : m_chunks) {
+                    total += chunk.size;
+                    std::free(chunk.data);
+                }
+                m_chunks.clear();
+                m_stats.bytesReserved = 0;
+                m_chunkSize = total;
+            }
+        }
+
+        /// \brief allocation counters since the construction (or the last resetStats)
+        /// @return the counters
+        inline const Stats& stats() const {return m_stats;};
+
+        /// \brief set the counters to 0 (bytesReserved and bytesInUse are kept)
+        void resetStats() {
+            const Stats previous = m_stats;
+            m_stats = Stats();
+            m_stats.bytesReserved = previous.bytesReserved;
+            m_stats.bytesInUse = previous.bytesInUse;
+        }
+
+        /// \brief arena of the innermost Scope on this thread
+        /// @return the arena, nullptr outside of any scope (the heap is used)
+        static RatioArena* current() {return currentSlot();}
+
+        /// \brief an arena owned by the calling thread
+        /// @return the arena of this thread
+        static RatioArena& threadLocal() {
+            static thread_local RatioArena arena;
+            return arena;
+        }
+
+        /// \brief number of blocks taken from the heap on this thread because no arena was active
+        /// @return the counter
+        static std::size_t& heapAllocations() {
+            static thread_local std::size_t count = 0;
+            return count;
+        }
+
+        /// \class Scope
+        /// \brief makes an arena the current one on this thread, and resets it on exit
+        class Scope {
+        public :
+            /// \brief constructor
+            /// \param arena : the arena to use until the end of the scope
+            /// \param resetOnExit : release every block of the arena at the end of the scope
+            explicit Scope(RatioArena &arena, bool resetOnExit = true) : m_arena(arena), m_previous(currentSlot()), m_resetOnExit(resetOnExit) {
+                currentSlot() = &arena;
+            }
+
+            Scope(const Scope &) = delete;
+            Scope& operator=(const Scope &) = delete;
+
+            ~Scope() {
+                currentSlot() = m_previous;
+                if(m_resetOnExit) {m_arena.reset();}
+            }
+
+        private :
+            RatioArena &m_arena;
+            RatioArena *m_previous;
+            bool m_resetOnExit;
+        };
+
+    private :
+
+        struct Chunk {
+            char *data;
+            std::size_t size;
+        };
+
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        static constexpr std::size_t alignment = alignof(std::max_align_t);
+        static constexpr std::size_t classCount = 48;
+
+        std::size_t m_chunkSize;
+        std::vector<Chunk> m_chunks;
+        std::size_t m_current = 0;
+        std::size_t m_offset = 0;
+        std::array<FreeBlock*, classCount> m_freeLists{};
+        Stats m_stats;
+
+        static RatioArena*& currentSlot() {
+            static thread_local RatioArena *arena = nullptr;
+            return arena;
+        }
+
+        /// \brief size classes are powers of two, from the alignment up
+        static std::size_t classOf(std::size_t bytes) {
+            std::size_t sizeClass = 0;
+            while(blockSize(sizeClass) < bytes) {++sizeClass;}
+            return sizeClass;
+        }
+
+        static constexpr std::size_t blockSize(std::size_t sizeClass) {
+            return alignment << sizeClass;
+        }
+
+        /// \brief move to the next chunk that can hold size bytes, allocating it if needed
+        void nextChunk(std::size_t size) {
+            if(!m_chunks.empty()) {++m_current;}
+            while(m_current < m_chunks.size() && m_chunks[m_current].size < size) {++m_current;}
+            if(m_current == m_chunks.size()) {
+                const std::size_t chunkSize = size > m_chunkSize ? size : m_chunkSize;
+                char *data = static_cast<char*>(std::malloc(chunkSize));
+                if(data == nullptr) {throw std::bad_alloc();}
+                m_chunks.push_back(Chunk{data, chunkSize});
+                ++m_stats.systemAllocations;
+                m_stats.bytesReserved += chunkSize;
+            }
+            m_offset = 0;
+        }
+    };
+
+
+    /// \class ArenaAllocator
+    /// \brief standard allocator drawing from the arena that is current when the container is
+    /// created (RatioArena::current()), from the heap outside of any RatioArena::Scope.
+    /// An assignment (copy or move) keeps the allocator of the target, so assigning a value to a
+    /// variable created outside of the scope keeps it after the reset : a move between different
+    /// arenas copies the limbs.
+    template <typename T>
+    class ArenaAllocator {
+
+    public :
+
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        ArenaAllocator() noexcept : m_arena(RatioArena::current()) {}
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) noexcept : m_arena(other.arena()) {}
+
+        T* allocate(std::size_t n) {
+            if(m_arena != nullptr) {
+                return static_cast<T*>(m_arena->allocate(n * sizeof(T)));
+            }
+            ++RatioArena::heapAllocations();
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T *block, std::size_t n) {
+            if(m_arena != nullptr) {
+                m_arena->deallocate(block, n * sizeof(T));
+            } else {
+                std::allocator<T>().deallocate(block, n);
+            }
+        }
+
+        /// \brief copies of a container use the arena current at the time of the copy
+        ArenaAllocator select_on_container_copy_construction() const {return ArenaAllocator();}
+
+        /// \brief the arena used by this allocator (nullptr for the heap)
+        inline RatioArena* arena() const {return m_arena;};
+
+        template <typename U>
+        friend bool operator==(const ArenaAllocator &left, const ArenaAllocator<U> &right) {return left.arena() == right.arena();}
+
+        template <typename U>
+        friend bool operator!=(const ArenaAllocator &left, const ArenaAllocator<U> &right) {return left.arena() != right.arena();}
+
+    private :
+
+        RatioArena *m_arena;
+    };
+}
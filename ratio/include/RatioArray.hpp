@@ -0,0 +1,508 @@
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <initializer_list>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \class RatioArray
+/// \brief structure-of-arrays container of rationals with batch arithmetic kernels.
+/// Numerators and denominators are kept in two contiguous buffers, so the kernels
+/// can process several ratios per instruction (AVX2 or SSE4.1 for 32-bit types,
+/// scalar loops otherwise) and normalize the results in a single batch pass.
+/// The kernels wrap around on overflow (Wrap policy), in the SIMD bodies and the scalar loops alike.
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief batch normalization of rationals stored as separate buffers
+        /// \param num : the numerators
+        /// \param den : the denominators
+        /// \param size : number of rationals
+        template <typename T>
+        void irreducibleScalar(T *num, T *den, std::size_t size) {
+            for(std::size_t i=0; i<size; ++i) {
+                const T pgcd = rto::gcd(num[i], den[i]);
+                if(pgcd > T(1)) {
+                    num[i] /= pgcd;
+                    den[i] /= pgcd;
+                }
+            }
+        }
+
+        /// \brief true when T can use the 32-bit SIMD kernels
+        template <typename T>
+        inline constexpr bool isSimd32 = std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4;
+
+    #if defined(__AVX2__)
+
+        /// \brief per lane exact division, the quotient must be an integer
+        /// \param x : 8 dividends
+        /// \param y : 8 non-null divisors
+        /// @return x/y per lane
+        inline __m256i divideExact(__m256i x, __m256i y) {
+            const __m256d low = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(x)),
+                                              _mm256_cvtepi32_pd(_mm256_castsi256_si128(y)));
+            const __m256d high = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(x, 1)),
+                                               _mm256_cvtepi32_pd(_mm256_extracti128_si256(y, 1)));
+            return _mm256_set_m128i(_mm256_cvttpd_epi32(high), _mm256_cvttpd_epi32(low));
+        }
+
+        /// \brief normalizes 8 rationals held in registers
+        /// \param num : the numerators
+        /// \param den : the denominators
+        inline void irreducible(__m256i &num, __m256i &den) {
+            __m256i pgcd = binaryGcd(num, den);
+            pgcd = _mm256_blendv_epi8(pgcd, _mm256_set1_epi32(1), _mm256_cmpeq_epi32(pgcd, _mm256_setzero_si256()));
+            num = divideExact(num, pgcd);
+            den = divideExact(den, pgcd);
+        }
+
+    #endif
+
+        /// \brief batch normalization of rationals stored as separate buffers
+        /// \param num : the numerators
+        /// \param den : the denominators
+        /// \param size : number of rationals
+        template <typename T>
+        void irreducible(T *num, T *den, std::size_t size) {
+            std::size_t i=0;
+        #if defined(__AVX2__)
+            if constexpr (isSimd32<T>) {
+                for(; i+8<=size; i+=8) {
+                    __m256i n = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(num+i));
+                    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(den+i));
+                    irreducible(n, d);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(num+i), n);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(den+i), d);
+                }
+            }
+        #endif
+            irreducibleScalar(num+i, den+i, size-i);
+        }
+
+        /// \brief addition kernel
+        struct Add {
+            template <typename T>
+            static constexpr void apply(T an, T ad, T bn, T bd, T &rn, T &rd) {
+                rn = Wrap::add(Wrap::mul(an, bd), Wrap::mul(ad, bn));
+                rd = Wrap::mul(ad, bd);
+            }
+        #if defined(__AVX2__)
+            static void apply(__m256i an, __m256i ad, __m256i bn, __m256i bd, __m256i &rn, __m256i &rd) {
+                rn = _mm256_add_epi32(_mm256_mullo_epi32(an, bd), _mm256_mullo_epi32(ad, bn));
+                rd = _mm256_mullo_epi32(ad, bd);
+            }
+        #endif
+        #if defined(__SSE4_1__)
+            static void apply(__m128i an, __m128i ad, __m128i bn, __m128i bd, __m128i &rn, __m128i &rd) {
+                rn = _mm_add_epi32(_mm_mullo_epi32(an, bd), _mm_mullo_epi32(ad, bn));
+                rd = _mm_mullo_epi32(ad, bd);
+            }
+        #endif
+        };
+
+        /// \brief subtraction kernel
+        struct Sub {
+            template <typename T>
+            static constexpr void apply(T an, T ad, T bn, T bd, T &rn, T &rd) {
+                rn = Wrap::sub(Wrap::mul(an, bd), Wrap::mul(ad, bn));
+                rd = Wrap::mul(ad, bd);
+            }
+        #if defined(__AVX2__)
+            static void apply(__m256i an, __m256i ad, __m256i bn, __m256i bd, __m256i &rn, __m256i &rd) {
+                rn = _mm256_sub_epi32(_mm256_mullo_epi32(an, bd), _mm256_mullo_epi32(ad, bn));
+                rd = _mm256_mullo_epi32(ad, bd);
+            }
+        #endif
+        #if defined(__SSE4_1__)
+            static void apply(__m128i an, __m128i ad, __m128i bn, __m128i bd, __m128i &rn, __m128i &rd) {
+                rn = _mm_sub_epi32(_mm_mullo_epi32(an, bd), _mm_mullo_epi32(ad, bn));
+                rd = _mm_mullo_epi32(ad, bd);
+            }
+        #endif
+        };
+
+        /// \brief multiplication kernel
+        struct Mul {
+            template <typename T>
+            static constexpr void apply(T an, T ad, T bn, T bd, T &rn, T &rd) {
+                rn = Wrap::mul(an, bn);
+                rd = Wrap::mul(ad, bd);
+            }
+        #if defined(__AVX2__)
+            static void apply(__m256i an, __m256i ad, __m256i bn, __m256i bd, __m256i &rn, __m256i &rd) {
+                rn = _mm256_mullo_epi32(an, bn);
+                rd = _mm256_mullo_epi32(ad, bd);
+            }
+        #endif
+        #if defined(__SSE4_1__)
+            static void apply(__m128i an, __m128i ad, __m128i bn, __m128i bd, __m128i &rn, __m128i &rd) {
+                rn = _mm_mullo_epi32(an, bn);
+                rd = _mm_mullo_epi32(ad, bd);
+            }
+        #endif
+        };
+
+        /// \brief division kernel, the sign is carried by the numerator (as Ratio::inverse)
+        struct Div {
+            template <typename T>
+            static constexpr void apply(T an, T ad, T bn, T bd, T &rn, T &rd) {
+                const bool negative = bn < T(0);
+                rn = Wrap::mul(an, negative ? Wrap::sub(T(0), bd) : bd);
+                rd = Wrap::mul(ad, negative ? Wrap::sub(T(0), bn) : bn);
+            }
+        #if defined(__AVX2__)
+            static void apply(__m256i an, __m256i ad, __m256i bn, __m256i bd, __m256i &rn, __m256i &rd) {
+                rn = _mm256_mullo_epi32(an, _mm256_sign_epi32(bd, bn));
+                rd = _mm256_mullo_epi32(ad, _mm256_abs_epi32(bn));
+            }
+        #endif
+        #if defined(__SSE4_1__)
+            static void apply(__m128i an, __m128i ad, __m128i bn, __m128i bd, __m128i &rn, __m128i &rd) {
+                rn = _mm_mullo_epi32(an, _mm_sign_epi32(bd, bn));
+                rd = _mm_mullo_epi32(ad, _mm_abs_epi32(bn));
+            }
+        #endif
+        };
+
+        /// \brief applies a kernel on whole buffers then normalizes the results
+        /// \param an, ad : numerators and denominators of the left operands
+        /// \param bn, bd : numerators and denominators of the right operands (a single value if Broadcast)
+        /// \param rn, rd : numerators and denominators of the results (may alias the left operands)
+        /// \param size : number of rationals
+        template <typename Op, bool Broadcast, typename T>
+        void transform(const T *an, const T *ad, const T *bn, const T *bd, T *rn, T *rd, std::size_t size) {
+            std::size_t i=0;
+            if constexpr (isSimd32<T>) {
+            #if defined(__AVX2__)
+                // the right operands are only read when broadcast (bn may be null for an empty array)
+                __m256i bnBroadcast = _mm256_setzero_si256(), bdBroadcast = _mm256_setzero_si256();
+                if constexpr (Broadcast) {
+                    bnBroadcast = _mm256_set1_epi32(*bn);
+                    bdBroadcast = _mm256_set1_epi32(*bd);
+                }
+                for(; i+8<=size; i+=8) {
+                    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(an+i));
+                    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ad+i));
+                    __m256i vn, vd;
+                    if constexpr (Broadcast) {
+                        Op::apply(va, vb, bnBroadcast, bdBroadcast, vn, vd);
+                    } else {
+                        Op::apply(va, vb,
+                                  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bn+i)),
+                                  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bd+i)), vn, vd);
+                    }
+                    irreducible(vn, vd);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(rn+i), vn);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(rd+i), vd);
+                }
+            #elif defined(__SSE4_1__)
+                // the right operands are only read when broadcast (bn may be null for an empty array)
+                __m128i bnBroadcast = _mm_setzero_si128(), bdBroadcast = _mm_setzero_si128();
+                if constexpr (Broadcast) {
+                    bnBroadcast = _mm_set1_epi32(*bn);
+                    bdBroadcast = _mm_set1_epi32(*bd);
+                }
+                for(; i+4<=size; i+=4) {
+                    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(an+i));
+                    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ad+i));
+                    __m128i vn, vd;
+                    if constexpr (Broadcast) {
+                        Op::apply(va, vb, bnBroadcast, bdBroadcast, vn, vd);
+                    } else {
+                        Op::apply(va, vb,
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(bn+i)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(bd+i)), vn, vd);
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(rn+i), vn);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(rd+i), vd);
+                }
+                irreducibleScalar(rn, rd, i);
+            #endif
+            }
+            for(std::size_t j=i; j<size; ++j) {
+                if constexpr (Broadcast) {
+                    Op::apply(an[j], ad[j], *bn, *bd, rn[j], rd[j]);
+                } else {
+                    Op::apply(an[j], ad[j], bn[j], bd[j], rn[j], rd[j]);
+                }
+            }
+            irreducibleScalar(rn+i, rd+i, size-i);
+        }
+    }
+
+
+    template <typename T = int>
+    class RatioArray {
+
+    public :
+
+        /// \brief defaultConstructor, empty array
+        /// @return an empty array
+        RatioArray() {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+        }
+
+        /// \brief constructor of an array of null ratios
+        /// \param size : number of ratios
+        /// @return an array of size ratios (0/1)
+        explicit RatioArray(std::size_t size) : m_numerators(size, T(0)), m_denominators(size, T(1)) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+        }
+
+        /// \brief constructor from a list of ratios
+        /// \param ratios : the ratios
+        /// @return an array holding the ratios
+        RatioArray(std::initializer_list<Ratio<T>> ratios) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+            reserve(ratios.size());
+            for(const Ratio<T> &rat : ratios) {push_back(rat);}
+        }
+
+        /// \brief constructor from an array of structures
+        /// \param ratios : the ratios
+        /// @return an array holding the ratios
+        explicit RatioArray(const std::vector<Ratio<T>> &ratios) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+            reserve(ratios.size());
+            for(const Ratio<T> &rat : ratios) {push_back(rat);}
+        }
+
+    private :
+
+        std::vector<T> m_numerators;
+        std::vector<T> m_denominators;
+
+    public :
+
+        /// \brief get the number of ratios
+        /// @return the size
+        inline std::size_t size() const {return m_numerators.size();};
+
+        /// \brief check if the array is empty
+        /// @return true if empty
+        inline bool empty() const {return m_numerators.empty();};
+
+        /// \brief resize the array, new ratios are (0/1)
+        /// \param size : the new size
+        inline void resize(std::size_t size) {
+            m_numerators.resize(size, T(0));
+            m_denominators.resize(size, T(1));
+        }
+
+        /// \brief reserve memory
+        /// \param capacity : the number of ratios to reserve
+        inline void reserve(std::size_t capacity) {
+            m_numerators.reserve(capacity);
+            m_denominators.reserve(capacity);
+        }
+
+        /// \brief add a ratio at the end
+        /// \param rat : the ratio
+        inline void push_back(const Ratio<T> &rat) {
+            m_numerators.push_back(rat.numerator());
+            m_denominators.push_back(rat.denominator());
+        }
+
+        /// \brief get a ratio
+        /// \param i : index of the ratio
+        /// @return a copy of the ratio (not normalized again)
+        inline Ratio<T> operator[](std::size_t i) const {
+            Ratio<T> rat;
+            rat.numerator() = m_numerators[i];
+            rat.denominator() = m_denominators[i];
+            return rat;
+        }
+
+        /// \brief set a ratio
+        /// \param i : index of the ratio
+        /// \param rat : the ratio
+        inline void set(std::size_t i, const Ratio<T> &rat) {
+            m_numerators[i] = rat.numerator();
+            m_denominators[i] = rat.denominator();
+        }
+
+        /// \brief get the numerators buffer
+        /// @return pointer to the contiguous numerators
+        inline T * numerators() {return m_numerators.data();};
+
+        /// \brief get the denominators buffer
+        /// @return pointer to the contiguous denominators
+        inline T * denominators() {return m_denominators.data();};
+
+        /// \brief get the numerators buffer
+        /// @return pointer to the contiguous numerators
+        inline const T * numerators() const {return m_numerators.data();};
+
+        /// \brief get the denominators buffer
+        /// @return pointer to the contiguous denominators
+        inline const T * denominators() const {return m_denominators.data();};
+
+        /// \brief transforms every ratio into an irreducible fraction (batch normalization)
+        /// @return void
+        void irreducible() {
+            kernel::irreducible(numerators(), denominators(), size());
+        }
+
+        /// \brief convert to an array of structures
+        /// @return a vector of ratios
+        std::vector<Ratio<T>> toVector() const {
+            std::vector<Ratio<T>> ratios;
+            ratios.reserve(size());
+            for(std::size_t i=0; i<size(); ++i) {ratios.push_back((*this)[i]);}
+            return ratios;
+        }
+
+        /// \brief overload the operator << for RatioArray
+        /// \param stream : input stream
+        /// \param array : the array to output
+        /// \return the output stream containing the ratios
+        friend std::ostream& operator<<(std::ostream& stream, const RatioArray& array) {
+            stream << "[";
+            for(std::size_t i=0; i<array.size(); ++i) {
+                stream << (i ? " " : "") << array[i];
+            }
+            stream << "]";
+            return stream;
+        }
+    };
+
+
+    // batch kernels : result[i] = a[i] op b[i], result may be one of the operands
+
+    /// \brief batch addition
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the sums, resized to a.size()
+    template <typename T>
+    void add(const RatioArray<T> &a, const RatioArray<T> &b, RatioArray<T> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        kernel::transform<kernel::Add,false>(a.numerators(), a.denominators(), b.numerators(), b.denominators(),
+                                             result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief batch subtraction
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the differences, resized to a.size()
+    template <typename T>
+    void sub(const RatioArray<T> &a, const RatioArray<T> &b, RatioArray<T> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        kernel::transform<kernel::Sub,false>(a.numerators(), a.denominators(), b.numerators(), b.denominators(),
+                                             result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief batch multiplication
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the products, resized to a.size()
+    template <typename T>
+    void mul(const RatioArray<T> &a, const RatioArray<T> &b, RatioArray<T> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        kernel::transform<kernel::Mul,false>(a.numerators(), a.denominators(), b.numerators(), b.denominators(),
+                                             result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief batch division, no ratio of b may be null
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the quotients, resized to a.size()
+    template <typename T>
+    void div(const RatioArray<T> &a, const RatioArray<T> &b, RatioArray<T> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        kernel::transform<kernel::Div,false>(a.numerators(), a.denominators(), b.numerators(), b.denominators(),
+                                             result.numerators(), result.denominators(), a.size());
+    }
+
+    // scalar broadcast kernels : result[i] = a[i] op rat
+
+    /// \brief batch addition of a ratio
+    /// \param a : left operands
+    /// \param rat : the ratio added to every element
+    /// \param result : the sums, resized to a.size()
+    template <typename T>
+    void add(const RatioArray<T> &a, const Ratio<T> &rat, RatioArray<T> &result) {
+        result.resize(a.size());
+        kernel::transform<kernel::Add,true>(a.numerators(), a.denominators(), &rat.numerator(), &rat.denominator(),
+                                            result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief batch subtraction of a ratio
+    /// \param a : left operands
+    /// \param rat : the ratio subtracted from every element
+    /// \param result : the differences, resized to a.size()
+    template <typename T>
+    void sub(const RatioArray<T> &a, const Ratio<T> &rat, RatioArray<T> &result) {
+        result.resize(a.size());
+        kernel::transform<kernel::Sub,true>(a.numerators(), a.denominators(), &rat.numerator(), &rat.denominator(),
+                                            result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief batch multiplication by a ratio
+    /// \param a : left operands
+    /// \param rat : the ratio multiplying every element
+    /// \param result : the products, resized to a.size()
+    template <typename T>
+    void mul(const RatioArray<T> &a, const Ratio<T> &rat, RatioArray<T> &result) {
+        result.resize(a.size());
+        kernel::transform<kernel::Mul,true>(a.numerators(), a.denominators(), &rat.numerator(), &rat.denominator(),
+                                            result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief batch division by a ratio
+    /// \param a : left operands
+    /// \param rat : the (non null) ratio dividing every element
+    /// \param result : the quotients, resized to a.size()
+    template <typename T>
+    void div(const RatioArray<T> &a, const Ratio<T> &rat, RatioArray<T> &result) {
+        assert(rat.numerator()!=0 && "Can't divide by 0");
+        result.resize(a.size());
+        kernel::transform<kernel::Div,true>(a.numerators(), a.denominators(), &rat.numerator(), &rat.denominator(),
+                                            result.numerators(), result.denominators(), a.size());
+    }
+
+    /// \brief operator + between arrays
+    template <typename T>
+    RatioArray<T> operator+(const RatioArray<T> &a, const RatioArray<T> &b) {RatioArray<T> r; add(a, b, r); return r;}
+
+    /// \brief operator - between arrays
+    template <typename T>
+    RatioArray<T> operator-(const RatioArray<T> &a, const RatioArray<T> &b) {RatioArray<T> r; sub(a, b, r); return r;}
+
+    /// \brief operator * between arrays
+    template <typename T>
+    RatioArray<T> operator*(const RatioArray<T> &a, const RatioArray<T> &b) {RatioArray<T> r; mul(a, b, r); return r;}
+
+    /// \brief operator / between arrays
+    template <typename T>
+    RatioArray<T> operator/(const RatioArray<T> &a, const RatioArray<T> &b) {RatioArray<T> r; div(a, b, r); return r;}
+
+    /// \brief operator + with a ratio
+    template <typename T>
+    RatioArray<T> operator+(const RatioArray<T> &a, const Ratio<T> &rat) {RatioArray<T> r; add(a, rat, r); return r;}
+
+    /// \brief operator - with a ratio
+    template <typename T>
+    RatioArray<T> operator-(const RatioArray<T> &a, const Ratio<T> &rat) {RatioArray<T> r; sub(a, rat, r); return r;}
+
+    /// \brief operator * with a ratio
+    template <typename T>
+    RatioArray<T> operator*(const RatioArray<T> &a, const Ratio<T> &rat) {RatioArray<T> r; mul(a, rat, r); return r;}
+
+    /// \brief operator / with a ratio
+    template <typename T>
+    RatioArray<T> operator/(const RatioArray<T> &a, const Ratio<T> &rat) {RatioArray<T> r; div(a, rat, r); return r;}
+}
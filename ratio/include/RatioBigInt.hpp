@@ -0,0 +1,717 @@
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <type_traits>
+
+#include "Ratio.hpp"
+#include "RatioArena.hpp"
+
+#pragma once
+
+
+/// \class BigInt
+/// \brief arbitrary precision signed integer, usable as Ratio<rto::BigInt>.
+/// Values that fit in an int64 are stored inline and use the hardware arithmetic (no allocation);
+/// larger values spill to a vector of 64-bit limbs (sign and magnitude, least significant limb first).
+/// Products use the schoolbook algorithm, Karatsuba above karatsubaThreshold limbs; the gcd is Lehmer's.
+/// The limbs come from the current RatioArena when a RatioArena::Scope is active on the thread.
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief full 64x64 -> 128-bit product
+        /// \param a : first factor
+        /// \param b : second factor
+        /// \param high : receives the high word of the product
+        /// @return the low word of the product
+        inline std::uint64_t mulWide(std::uint64_t a, std::uint64_t b, std::uint64_t &high) {
+        #if defined(__SIZEOF_INT128__)
+            const overflow::uint128 product = overflow::uint128(a) * b;
+            high = static_cast<std::uint64_t>(product >> 64);
+            return static_cast<std::uint64_t>(product);
+        #else
+            const std::uint64_t a0 = a & 0xFFFFFFFFu, a1 = a >> 32;
+            const std::uint64_t b0 = b & 0xFFFFFFFFu, b1 = b >> 32;
+            const std::uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+            const std::uint64_t middle = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+            high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+            return (middle << 32) | (p00 & 0xFFFFFFFFu);
+        #endif
+        }
+
+        /// \brief 128/64-bit division of (high:low), requires high < divisor
+        /// \param high : high word of the dividend
+        /// \param low : low word of the dividend
+        /// \param divisor : the divisor
+        /// \param remainder : receives the remainder
+        /// @return the quotient
+        inline std::uint64_t divWide(std::uint64_t high, std::uint64_t low, std::uint64_t divisor, std::uint64_t &remainder) {
+        #if defined(__SIZEOF_INT128__)
+            const overflow::uint128 dividend = (overflow::uint128(high) << 64) | low;
+            remainder = static_cast<std::uint64_t>(dividend % divisor);
+            return static_cast<std::uint64_t>(dividend / divisor);
+        #else
+            std::uint64_t quotient = 0;
+            for(int i=0; i<64; ++i) {
+                const bool carry = (high >> 63) != 0;
+                high = (high << 1) | (low >> 63);
+                low <<= 1;
+                quotient <<= 1;
+                if(carry || high >= divisor) {
+                    high -= divisor;
+                    quotient |= 1;
+                }
+            }
+            remainder = high;
+            return quotient;
+        #endif
+        }
+    }
+
+
+    class BigInt {
+
+    public :
+
+        using limb_type = std::uint64_t;
+        using limbs_type = std::vector<limb_type, ArenaAllocator<limb_type>>;
+
+        /// \brief number of limbs of the smallest operand from which products use Karatsuba
+        static constexpr std::size_t karatsubaThreshold = 32;
+
+        /// \brief defaultConstructor equal to 0
+        /// @return a BigInt (0)
+        BigInt() = default;
+
+        /// \brief constructor from a built-in integer (stored inline when it fits in an int64)
+        /// \param value : the integer
+        /// @return a BigInt equal to value
+        template <typename I, std::enable_if_t<std::is_integral_v<I> && !std::is_same_v<I, bool>, int> = 0>
+        BigInt(const I &value) {
+            if constexpr (std::is_signed_v<I> && sizeof(I) <= sizeof(std::int64_t)) {
+                if(static_cast<std::int64_t>(value) != std::numeric_limits<std::int64_t>::min()) {
+                    m_small = static_cast<std::int64_t>(value);
+                    return;
+                }
+            } else if constexpr (!std::is_signed_v<I> && sizeof(I) <= sizeof(std::int64_t)) {
+                if(static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                    m_small = static_cast<std::int64_t>(value);
+                    return;
+                }
+            }
+            auto magnitude = kernel::magnitude(value);
+            limbs_type limbs;
+            while(magnitude != 0) {
+                limbs.push_back(static_cast<limb_type>(magnitude));
+                if constexpr (sizeof(I) > sizeof(limb_type)) {
+                    magnitude >>= 64;
+                } else {
+                    magnitude = 0;
+                }
+            }
+            bool negative = false;
+            if constexpr (std::is_signed_v<I>) {negative = value < I(0);}
+            *this = fromMagnitude(std::move(limbs), negative);
+        }
+
+        /// \brief check if the value is stored inline
+        /// @return true if the value fits in an int64 (no heap storage)
+        inline bool isSmall() const {return m_limbs.empty();};
+
+        /// \brief number of 64-bit limbs of the magnitude
+        /// @return the number of limbs (1 for an inline value, 0 for 0)
+        inline std::size_t size() const {return isSmall() ? (m_small != 0) : m_limbs.size();};
+
+        /// \brief sign of the value
+        /// @return -1, 0 or 1
+        inline int sign() const {
+            if(isSmall()) {return (m_small > 0) - (m_small < 0);}
+            return m_negative ? -1 : 1;
+        }
+
+        /// \brief number of significant bits of the magnitude
+        /// @return the position of the highest set bit plus one (0 for 0)
+        std::size_t bitWidth() const {
+            if(isSmall()) {return static_cast<std::size_t>(kernel::bitWidth(kernel::magnitude(m_small)));}
+            return (m_limbs.size() - 1) * 64 + static_cast<std::size_t>(kernel::bitWidth(m_limbs.back()));
+        }
+
+        /// \brief conversion to double (rounded toward zero on the 128 leading bits)
+        /// @return the closest double
+        explicit operator double() const {
+            if(isSmall()) {return static_cast<double>(m_small);}
+            const std::size_t n = m_limbs.size();
+            double result = static_cast<double>(m_limbs[n-1]);
+            if(n > 1) {
+                result = std::ldexp(std::ldexp(result, 64) + static_cast<double>(m_limbs[n-2]), static_cast<int>(64 * (n - 2)));
+            }
+            return m_negative ? -result : result;
+        }
+
+        /// \brief conversion to a built-in integer (keeps the low bits, like the built-in narrowing conversions)
+        template <typename I, std::enable_if_t<std::is_integral_v<I> && !std::is_same_v<I, bool>, int> = 0>
+        explicit operator I() const {
+            if(isSmall()) {return static_cast<I>(m_small);}
+            const limb_type low = m_limbs[0];
+            return m_negative ? static_cast<I>(limb_type(0) - low) : static_cast<I>(low);
+        }
+
+        /// \brief check if the value is not null
+        explicit operator bool() const {return !isSmall() || m_small != 0;}
+
+        /// \brief decimal representation
+        /// @return the value in base 10
+        std::string toString() const {
+            if(isSmall()) {return std::to_string(m_small);}
+            // chunks of 19 decimal digits, least significant first
+            constexpr limb_type chunk = 10000000000000000000ull;
+            limbs_type magnitude = m_limbs;
+            std::string digits;
+            while(!magnitude.empty()) {
+                limb_type remainder = divideLimb(magnitude, chunk);
+                for(int i=0; i<19 && (remainder != 0 || !magnitude.empty()); ++i) {
+                    digits.push_back(static_cast<char>('0' + remainder % 10));
+                    remainder /= 10;
+                }
+            }
+            if(m_negative) {digits.push_back('-');}
+            std::reverse(digits.begin(), digits.end());
+            return digits;
+        }
+
+        /// \brief overload the operator << for BigInt
+        /// \param stream : input stream
+        /// \param value : the integer to output
+        /// \return the output stream containing the decimal value
+        friend std::ostream& operator<<(std::ostream& stream, const BigInt& value) {
+            return stream << value.toString();
+        }
+
+        /// \brief unary minus
+        friend BigInt operator-(const BigInt &value) {
+            BigInt result = value;
+            if(result.isSmall()) {
+                result.m_small = -result.m_small;
+            } else {
+                result.m_negative = !result.m_negative;
+            }
+            return result;
+        }
+
+        /// \brief operator +
+        friend BigInt operator+(const BigInt &left, const BigInt &right) {
+            if(left.isSmall() && right.isSmall()) {
+                std::int64_t result{};
+                if(!overflow::addOverflows(left.m_small, right.m_small, result) && result != std::numeric_limits<std::int64_t>::min()) {
+                    return BigInt(result);
+                }
+            }
+            return addSigned(left, right, false);
+        }
+
+        /// \brief operator -
+        friend BigInt operator-(const BigInt &left, const BigInt &right) {
+            if(left.isSmall() && right.isSmall()) {
+                std::int64_t result{};
+                if(!overflow::subOverflows(left.m_small, right.m_small, result) && result != std::numeric_limits<std::int64_t>::min()) {
+                    return BigInt(result);
+                }
+            }
+            return addSigned(left, right, true);
+        }
+
+        /// \brief operator *
+        friend BigInt operator*(const BigInt &left, const BigInt &right) {
+            if(left.isSmall() && right.isSmall()) {
+                std::int64_t result{};
+                if(!overflow::mulOverflows(left.m_small, right.m_small, result) && result != std::numeric_limits<std::int64_t>::min()) {
+                    return BigInt(result);
+                }
+            }
+            limb_type leftStorage{}, rightStorage{};
+            const limb_type *a = nullptr, *b = nullptr;
+            std::size_t na = 0, nb = 0;
+            left.view(leftStorage, a, na);
+            right.view(rightStorage, b, nb);
+            if(na == 0 || nb == 0) {return BigInt();}
+            limbs_type product(na + nb, 0);
+            multiplyMagnitude(a, na, b, nb, product.data());
+            return fromMagnitude(std::move(product), left.isNegative() != right.isNegative());
+        }
+
+        /// \brief operator / (truncated toward zero, like the built-in integers)
+        friend BigInt operator/(const BigInt &left, const BigInt &right) {
+            BigInt quotient, remainder;
+            divide(left, right, quotient, remainder);
+            return quotient;
+        }
+
+        /// \brief operator % (the sign of the left operand, like the built-in integers)
+        friend BigInt operator%(const BigInt &left, const BigInt &right) {
+            BigInt quotient, remainder;
+            divide(left, right, quotient, remainder);
+            return remainder;
+        }
+
+        /// \brief shift of the magnitude to the left (multiplication by 2^shift)
+        friend BigInt operator<<(const BigInt &value, std::size_t shift) {
+            limb_type storage{};
+            const limb_type *a = nullptr;
+            std::size_t na = 0;
+            value.view(storage, a, na);
+            if(na == 0) {return BigInt();}
+            const std::size_t limbShift = shift / 64, bitShift = shift % 64;
+            limbs_type result(na + limbShift + 1, 0);
+            for(std::size_t i=0; i<na; ++i) {
+                result[i + limbShift] |= a[i] << bitShift;
+                if(bitShift) {result[i + limbShift + 1] = a[i] >> (64 - bitShift);}
+            }
+            return fromMagnitude(std::move(result), value.isNegative());
+        }
+
+        /// \brief shift of the magnitude to the right (division by 2^shift, truncated toward zero)
+        friend BigInt operator>>(const BigInt &value, std::size_t shift) {
+            if(value.isSmall()) {
+                if(shift >= 64) {return BigInt();}
+                const limb_type magnitude = kernel::magnitude(value.m_small) >> shift;
+                return value.m_small < 0 ? BigInt(-static_cast<std::int64_t>(magnitude)) : BigInt(static_cast<std::int64_t>(magnitude));
+            }
+            return fromMagnitude(shiftRight(value.m_limbs.data(), value.m_limbs.size(), shift), value.m_negative);
+        }
+
+        BigInt& operator+=(const BigInt &value) {return *this = *this + value;}
+        BigInt& operator-=(const BigInt &value) {return *this = *this - value;}
+        BigInt& operator*=(const BigInt &value) {return *this = *this * value;}
+        BigInt& operator/=(const BigInt &value) {return *this = *this / value;}
+        BigInt& operator%=(const BigInt &value) {return *this = *this % value;}
+        BigInt& operator<<=(std::size_t shift) {return *this = *this << shift;}
+        BigInt& operator>>=(std::size_t shift) {return *this = *this >> shift;}
+        BigInt& operator++() {return *this += BigInt(1);}
+        BigInt& operator--() {return *this -= BigInt(1);}
+
+        /// \brief three-way comparison
+        /// \param left : first integer
+        /// \param right : second integer
+        /// @return -1, 0 or 1
+        friend int compare(const BigInt &left, const BigInt &right) {
+            if(left.isSmall() && right.isSmall()) {return (left.m_small > right.m_small) - (left.m_small < right.m_small);}
+            const int leftSign = left.sign(), rightSign = right.sign();
+            if(leftSign != rightSign) {return leftSign < rightSign ? -1 : 1;}
+            limb_type leftStorage{}, rightStorage{};
+            const limb_type *a = nullptr, *b = nullptr;
+            std::size_t na = 0, nb = 0;
+            left.view(leftStorage, a, na);
+            right.view(rightStorage, b, nb);
+            return leftSign * compareMagnitude(a, na, b, nb);
+        }
+
+        friend bool operator==(const BigInt &left, const BigInt &right) {
+            if(left.isSmall() != right.isSmall()) {return false;}
+            if(left.isSmall()) {return left.m_small == right.m_small;}
+            return left.m_negative == right.m_negative && left.m_limbs == right.m_limbs;
+        }
+        friend bool operator!=(const BigInt &left, const BigInt &right) {return !(left == right);}
+        friend bool operator<(const BigInt &left, const BigInt &right) {return compare(left, right) < 0;}
+        friend bool operator<=(const BigInt &left, const BigInt &right) {return compare(left, right) <= 0;}
+        friend bool operator>(const BigInt &left, const BigInt &right) {return compare(left, right) > 0;}
+        friend bool operator>=(const BigInt &left, const BigInt &right) {return compare(left, right) >= 0;}
+
+        /// \brief Lehmer gcd (Knuth, TAOCP 4.5.2 algorithm L) on the leading 62 bits, binary gcd
+        /// once both values fit in a limb
+        /// \param left : first integer
+        /// \param right : second integer
+        /// @return the (positive) gcd, 0 if both are null
+        static BigInt gcd(const BigInt &left, const BigInt &right) {
+            if(left.isSmall() && right.isSmall()) {
+                return BigInt(static_cast<std::int64_t>(kernel::binaryGcd(kernel::magnitude(left.m_small), kernel::magnitude(right.m_small))));
+            }
+            limbs_type u = left.magnitude(), v = right.magnitude();
+            if(compareMagnitude(u.data(), u.size(), v.data(), v.size()) < 0) {u.swap(v);}
+
+            constexpr int digits = 62;
+            while(v.size() > 1) {
+                const std::size_t shift = (u.size() - 1) * 64 + static_cast<std::size_t>(kernel::bitWidth(u.back())) - digits;
+                std::int64_t x = static_cast<std::int64_t>(leadingBits(u, shift));
+                std::int64_t y = static_cast<std::int64_t>(leadingBits(v, shift));
+                std::int64_t a = 1, b = 0, c = 0, d = 1;
+                // both quotients are computed: x+a, x+b, y+c and y+d stay in [0, 2^Digits]
+                while(y + c != 0 && y + d != 0) {
+                    const std::int64_t q = (x + a) / (y + c);
+                    if(q != (x + b) / (y + d)) {break;}
+                    std::int64_t t = a - q * c; a = c; c = t;
+                    t = b - q * d; b = d; d = t;
+                    t = x - q * y; x = y; y = t;
+                }
+                if(b == 0) {
+                    // the leading digits did not give a quotient : one full Euclid step
+                    limbs_type quotient, remainder;
+                    divideMagnitude(u.data(), u.size(), v.data(), v.size(), quotient, remainder);
+                    u.swap(v);
+                    v.swap(remainder);
+                } else {
+                    limbs_type nu = combine(u, a, v, b);
+                    limbs_type nv = combine(u, c, v, d);
+                    u.swap(nu);
+                    v.swap(nv);
+                }
+            }
+            if(v.empty()) {return fromMagnitude(std::move(u), false);}
+            const limb_type remainder = divideLimb(u, v[0]);
+            return fromMagnitude(limbs_type{kernel::binaryGcd(v[0], remainder)}, false);
+        }
+
+    private :
+
+        std::int64_t m_small = 0;   // the value when m_limbs is empty
+        bool m_negative = false;    // sign of the value stored in m_limbs
+        limbs_type m_limbs;         // magnitude of a value that does not fit in an int64
+
+        inline bool isNegative() const {return isSmall() ? m_small < 0 : m_negative;}
+
+        /// \brief magnitude as a pointer and a size, storage holds the limb of an inline value
+        void view(limb_type &storage, const limb_type *&data, std::size_t &size) const {
+            if(isSmall()) {
+                storage = kernel::magnitude(m_small);
+                data = &storage;
+                size = (storage != 0);
+            } else {
+                data = m_limbs.data();
+                size = m_limbs.size();
+            }
+        }
+
+        /// \brief magnitude as limbs
+        limbs_type magnitude() const {
+            if(isSmall()) {return m_small ? limbs_type{kernel::magnitude(m_small)} : limbs_type{};}
+            return m_limbs;
+        }
+
+        /// \brief build a value from a magnitude, inline if it fits in an int64
+        static BigInt fromMagnitude(limbs_type &&limbs, bool negative) {
+            while(!limbs.empty() && limbs.back() == 0) {limbs.pop_back();}
+            BigInt result;
+            if(limbs.empty()) {return result;}
+            if(limbs.size() == 1 && limbs[0] <= static_cast<limb_type>(std::numeric_limits<std::int64_t>::max())) {
+                result.m_small = negative ? -static_cast<std::int64_t>(limbs[0]) : static_cast<std::int64_t>(limbs[0]);
+                return result;
+            }
+            result.m_negative = negative;
+            result.m_limbs = std::move(limbs);
+            return result;
+        }
+
+        /// \brief compare two magnitudes (without leading zero limbs)
+        static int compareMagnitude(const limb_type *a, std::size_t na, const limb_type *b, std::size_t nb) {
+            if(na != nb) {return na < nb ? -1 : 1;}
+            for(std::size_t i=na; i-->0;) {
+                if(a[i] != b[i]) {return a[i] < b[i] ? -1 : 1;}
+            }
+            return 0;
+        }
+
+        /// \brief r += a, r has at least na limbs
+        /// @return the carry out of r
+        static limb_type addInPlace(limb_type *r, std::size_t nr, const limb_type *a, std::size_t na) {
+            limb_type carry = 0;
+            std::size_t i = 0;
+            for(; i<na; ++i) {
+                const limb_type sum = r[i] + a[i];
+                const limb_type next = sum < a[i];
+                r[i] = sum + carry;
+                carry = next + (r[i] < sum);
+            }
+            for(; carry && i<nr; ++i) {
+                r[i] += carry;
+                carry = r[i] == 0;
+            }
+            return carry;
+        }
+
+        /// \brief r -= a, requires r >= a
+        static void subInPlace(limb_type *r, std::size_t nr, const limb_type *a, std::size_t na) {
+            limb_type borrow = 0;
+            std::size_t i = 0;
+            for(; i<na; ++i) {
+                const limb_type difference = r[i] - a[i];
+                const limb_type next = r[i] < a[i];
+                r[i] = difference - borrow;
+                borrow = next + (difference < borrow);
+            }
+            for(; borrow && i<nr; ++i) {
+                borrow = r[i] == 0;
+                --r[i];
+            }
+        }
+
+        /// \brief signed sum, or difference if negateRight
+        static BigInt addSigned(const BigInt &left, const BigInt &right, bool negateRight) {
+            limb_type leftStorage{}, rightStorage{};
+            const limb_type *a = nullptr, *b = nullptr;
+            std::size_t na = 0, nb = 0;
+            left.view(leftStorage, a, na);
+            right.view(rightStorage, b, nb);
+            const bool leftNegative = left.isNegative();
+            const bool rightNegative = right.isNegative() != negateRight;
+
+            if(leftNegative == rightNegative) {
+                if(na < nb) {
+                    std::swap(a, b);
+                    std::swap(na, nb);
+                }
+                limbs_type sum(a, a + na);
+                sum.push_back(0);
+                addInPlace(sum.data(), sum.size(), b, nb);
+                return fromMagnitude(std::move(sum), leftNegative);
+            }
+            const int order = compareMagnitude(a, na, b, nb);
+            if(order == 0) {return BigInt();}
+            if(order < 0) {
+                limbs_type difference(b, b + nb);
+                subInPlace(difference.data(), difference.size(), a, na);
+                return fromMagnitude(std::move(difference), rightNegative);
+            }
+            limbs_type difference(a, a + na);
+            subInPlace(difference.data(), difference.size(), b, nb);
+            return fromMagnitude(std::move(difference), leftNegative);
+        }
+
+        /// \brief r = a * b, r has na+nb limbs set to 0 and does not alias a or b
+        static void multiplyMagnitude(const limb_type *a, std::size_t na, const limb_type *b, std::size_t nb, limb_type *r) {
+            if(na < nb) {
+                std::swap(a, b);
+                std::swap(na, nb);
+            }
+            if(nb < karatsubaThreshold || 2 * nb <= na) {
+                // schoolbook
+                for(std::size_t j=0; j<nb; ++j) {
+                    limb_type carry = 0;
+                    for(std::size_t i=0; i<na; ++i) {
+                        limb_type high{};
+                        limb_type low = kernel::mulWide(a[i], b[j], high);
+                        low += carry;
+                        high += low < carry;
+                        low += r[i + j];
+                        high += low < r[i + j];
+                        r[i + j] = low;
+                        carry = high;
+                    }
+                    r[na + j] = carry;
+                }
+                return;
+            }
+            // Karatsuba : a = a1*B^m + a0, b = b1*B^m + b0, z1 = (a0+a1)(b0+b1) - a0*b0 - a1*b1
+            const std::size_t m = na / 2;
+            multiplyMagnitude(a, m, b, m, r);
+            multiplyMagnitude(a + m, na - m, b + m, nb - m, r + 2 * m);
+
+            limbs_type sumA(a + m, a + na);
+            sumA.push_back(0);
+            addInPlace(sumA.data(), sumA.size(), a, m);
+            limbs_type sumB(b + m, b + nb);
+            sumB.resize(std::max(nb - m, m) + 1, 0);
+            addInPlace(sumB.data(), sumB.size(), b, m);
+
+            limbs_type middle(sumA.size() + sumB.size(), 0);
+            multiplyMagnitude(sumA.data(), sumA.size(), sumB.data(), sumB.size(), middle.data());
+            subInPlace(middle.data(), middle.size(), r, 2 * m);
+            subInPlace(middle.data(), middle.size(), r + 2 * m, na + nb - 2 * m);
+            while(!middle.empty() && middle.back() == 0) {middle.pop_back();}
+            addInPlace(r + m, na + nb - m, middle.data(), middle.size());
+        }
+
+        /// \brief a * factor
+        static limbs_type multiplyLimb(const limbs_type &a, limb_type factor) {
+            limbs_type result(a.size() + 1, 0);
+            limb_type carry = 0;
+            for(std::size_t i=0; i<a.size(); ++i) {
+                limb_type high{};
+                limb_type low = kernel::mulWide(a[i], factor, high);
+                low += carry;
+                high += low < carry;
+                result[i] = low;
+                carry = high;
+            }
+            result.back() = carry;
+            return result;
+        }
+
+        /// \brief a = a / divisor
+        /// @return the remainder
+        static limb_type divideLimb(limbs_type &a, limb_type divisor) {
+            limb_type remainder = 0;
+            for(std::size_t i=a.size(); i-->0;) {
+                a[i] = kernel::divWide(remainder, a[i], divisor, remainder);
+            }
+            while(!a.empty() && a.back() == 0) {a.pop_back();}
+            return remainder;
+        }
+
+        /// \brief magnitude shifted right by shift bits
+        static limbs_type shiftRight(const limb_type *a, std::size_t na, std::size_t shift) {
+            const std::size_t limbShift = shift / 64, bitShift = shift % 64;
+            if(limbShift >= na) {return limbs_type();}
+            limbs_type result(na - limbShift, 0);
+            for(std::size_t i=0; i<result.size(); ++i) {
+                result[i] = a[i + limbShift] >> bitShift;
+                if(bitShift && i + limbShift + 1 < na) {result[i] |= a[i + limbShift + 1] << (64 - bitShift);}
+            }
+            return result;
+        }
+
+        /// \brief quotient and remainder of two magnitudes (Knuth, TAOCP 4.3.1 algorithm D)
+        static void divideMagnitude(const limb_type *a, std::size_t na, const limb_type *b, std::size_t nb, limbs_type &quotient, limbs_type &remainder) {
+            if(compareMagnitude(a, na, b, nb) < 0) {
+                quotient.clear();
+                remainder.assign(a, a + na);
+                return;
+            }
+            if(nb == 1) {
+                quotient.assign(a, a + na);
+                const limb_type rest = divideLimb(quotient, b[0]);
+                remainder = rest ? limbs_type{rest} : limbs_type{};
+                return;
+            }
+            // normalize so that the leading limb of the divisor has its top bit set
+            const int shift = 64 - kernel::bitWidth(b[nb - 1]);
+            limbs_type v(nb), u(na + 1);
+            for(std::size_t i=nb; i-->0;) {
+                v[i] = (b[i] << shift) | (shift && i ? b[i - 1] >> (64 - shift) : 0);
+            }
+            u[na] = shift ? a[na - 1] >> (64 - shift) : 0;
+            for(std::size_t i=na; i-->0;) {
+                u[i] = (a[i] << shift) | (shift && i ? a[i - 1] >> (64 - shift) : 0);
+            }
+
+            quotient.assign(na - nb + 1, 0);
+            for(std::size_t j=na - nb + 1; j-->0;) {
+                // estimate the quotient digit from the two leading limbs
+                limb_type qhat{}, rhat{};
+                bool rhatOverflow = false;
+                if(u[j + nb] >= v[nb - 1]) {
+                    qhat = ~limb_type(0);
+                    rhat = u[j + nb - 1] + v[nb - 1];
+                    rhatOverflow = rhat < v[nb - 1];
+                } else {
+                    qhat = kernel::divWide(u[j + nb], u[j + nb - 1], v[nb - 1], rhat);
+                }
+                while(!rhatOverflow) {
+                    limb_type high{};
+                    const limb_type low = kernel::mulWide(qhat, v[nb - 2], high);
+                    if(high < rhat || (high == rhat && low <= u[j + nb - 2])) {break;}
+                    --qhat;
+                    rhat += v[nb - 1];
+                    rhatOverflow = rhat < v[nb - 1];
+                }
+
+                // u[j..j+nb] -= qhat * v
+                limb_type carry = 0, borrow = 0;
+                for(std::size_t i=0; i<nb; ++i) {
+                    limb_type high{};
+                    limb_type low = kernel::mulWide(qhat, v[i], high);
+                    low += carry;
+                    high += low < carry;
+                    carry = high;
+                    const limb_type difference = u[i + j] - low;
+                    const limb_type next = u[i + j] < low;
+                    u[i + j] = difference - borrow;
+                    borrow = next + (difference < borrow);
+                }
+                const limb_type top = u[j + nb];
+                u[j + nb] = top - carry - borrow;
+                if(top < carry + borrow || carry + borrow < carry) {
+                    // qhat was one too large : add v back
+                    --qhat;
+                    u[j + nb] += addInPlace(u.data() + j, nb, v.data(), nb);
+                }
+                quotient[j] = qhat;
+            }
+            while(!quotient.empty() && quotient.back() == 0) {quotient.pop_back();}
+            remainder = shiftRight(u.data(), nb, static_cast<std::size_t>(shift));
+            while(!remainder.empty() && remainder.back() == 0) {remainder.pop_back();}
+        }
+
+        /// \brief truncated division of signed values
+        static void divide(const BigInt &left, const BigInt &right, BigInt &quotient, BigInt &remainder) {
+            assert(right.sign() != 0 && "Can't divide by 0");
+            if(left.isSmall() && right.isSmall()) {
+                quotient = BigInt(left.m_small / right.m_small);
+                remainder = BigInt(left.m_small % right.m_small);
+                return;
+            }
+            limb_type leftStorage{}, rightStorage{};
+            const limb_type *a = nullptr, *b = nullptr;
+            std::size_t na = 0, nb = 0;
+            left.view(leftStorage, a, na);
+            right.view(rightStorage, b, nb);
+            limbs_type q, r;
+            divideMagnitude(a, na, b, nb, q, r);
+            quotient = fromMagnitude(std::move(q), left.isNegative() != right.isNegative());
+            remainder = fromMagnitude(std::move(r), left.isNegative());
+        }
+
+        /// \brief the 64 bits of a magnitude starting at bit shift
+        static limb_type leadingBits(const limbs_type &a, std::size_t shift) {
+            const std::size_t limb = shift / 64, bit = shift % 64;
+            if(limb >= a.size()) {return 0;}
+            limb_type result = a[limb] >> bit;
+            if(bit && limb + 1 < a.size()) {result |= a[limb + 1] << (64 - bit);}
+            return result;
+        }
+
+        /// \brief x*u + y*v for cofactors of a Lehmer step (the result is known to be non negative)
+        static limbs_type combine(const limbs_type &u, std::int64_t x, const limbs_type &v, std::int64_t y) {
+            limbs_type first = multiplyLimb(u, kernel::magnitude(x));
+            limbs_type second = multiplyLimb(v, kernel::magnitude(y));
+            if(x < 0) {first.swap(second);}
+            // first - second, with x >= 0 >= y (or the opposite, swapped above)
+            while(!first.empty() && first.back() == 0) {first.pop_back();}
+            while(!second.empty() && second.back() == 0) {second.pop_back();}
+            if(x >= 0 && y >= 0) {
+                first.resize(std::max(first.size(), second.size()) + 1, 0);
+                addInPlace(first.data(), first.size(), second.data(), second.size());
+            } else {
+                subInPlace(first.data(), first.size(), second.data(), second.size());
+            }
+            while(!first.empty() && first.back() == 0) {first.pop_back();}
+            return first;
+        }
+    };
+
+    /// \brief gcd of two BigInt (Lehmer), used by Ratio<BigInt>::irreducible() and the operators
+    template <>
+    inline BigInt gcd<BigInt>(const BigInt &a, const BigInt &b) {
+        if constexpr (stats::enabled) {
+            stats::gcdCall(static_cast<int>(std::max(a.bitWidth(), b.bitWidth())));
+        }
+        return BigInt::gcd(a, b);
+    }
+}
+
+
+namespace std {
+
+    /// \brief BigInt is a signed, exact and unbounded integer
+    template <>
+    class numeric_limits<rto::BigInt> {
+    public :
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = true;
+        static constexpr bool is_exact = true;
+        static constexpr bool is_bounded = false;
+        static constexpr bool is_modulo = false;
+        static constexpr int radix = 2;
+        static constexpr int digits = 0;
+        static constexpr int digits10 = 0;
+        static rto::BigInt min() {return rto::BigInt();}
+        static rto::BigInt max() {return rto::BigInt();}
+        static rto::BigInt lowest() {return rto::BigInt();}
+    };
+}
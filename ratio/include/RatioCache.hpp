@@ -0,0 +1,289 @@
+#include <atomic>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \file RatioCache.hpp
+/// \brief memoization of the double to Ratio conversions, for inputs with many repeated values.
+/// rto::cachedFromReal<T>(real, maxDenominator, tolerance) returns Ratio<T>::fromReal(real, maxDenominator, tolerance);
+/// the key is the exact bit pattern of the double and the two parameters, so that a hit gives the same
+/// ratio as the conversion (0.0 and -0.0, or two NaNs with different payloads, are different keys).
+/// Two tiers, both direct-mapped (a new entry replaces the one at its index):
+/// \li a thread-local tier of RTO_CACHE_LOCAL_SIZE entries, without any synchronization
+/// \li a tier shared by every thread, RTO_CACHE_SHARED_SIZE entries, filled by the conversions and read
+/// without lock (one sequence number per entry, a writer skips an entry another one is writing)
+/// The memory is bounded: per integer type T, the shared tier and one local tier per thread that uses it
+/// (cacheMemoryBytes<T>()). The counters of hits and misses are per thread, summed by cacheStatistics().
+
+/// entries of the thread-local tier (a power of two)
+#ifndef RTO_CACHE_LOCAL_SIZE
+#define RTO_CACHE_LOCAL_SIZE 512
+#endif
+
+/// entries of the shared tier (a power of two)
+#ifndef RTO_CACHE_SHARED_SIZE
+#define RTO_CACHE_SHARED_SIZE 4096
+#endif
+
+namespace rto {
+
+    /// \brief hits and misses of the conversion cache
+    struct CacheStatistics {
+        std::uint64_t hits = 0;         // found in the thread-local tier
+        std::uint64_t sharedHits = 0;   // found in the shared tier
+        std::uint64_t misses = 0;       // converted
+
+        /// \brief number of conversions asked to the cache
+        std::uint64_t lookups() const {return hits + sharedHits + misses;}
+
+        /// \brief fraction of the lookups served by a tier, 0 without lookup
+        double hitRate() const {
+            return lookups() ? static_cast<double>(hits + sharedHits) / static_cast<double>(lookups()) : 0.0;
+        }
+
+        CacheStatistics& operator+=(const CacheStatistics &other) {
+            hits += other.hits;
+            sharedHits += other.sharedHits;
+            misses += other.misses;
+            return *this;
+        }
+    };
+
+    namespace cache {
+
+        constexpr std::size_t localSize = RTO_CACHE_LOCAL_SIZE;
+        constexpr std::size_t sharedSize = RTO_CACHE_SHARED_SIZE;
+
+        static_assert(localSize > 0 && (localSize & (localSize - 1)) == 0, "RTO_CACHE_LOCAL_SIZE should be a power of two");
+        static_assert(sharedSize > 0 && (sharedSize & (sharedSize - 1)) == 0, "RTO_CACHE_SHARED_SIZE should be a power of two");
+
+        /// \brief a conversion : bits of the real, of the bound on the denominator and of the tolerance
+        /// (an entry whose maxDenominator is 0 is empty, fromReal asks for a positive bound)
+        struct Key {
+            std::uint64_t real = 0;
+            std::uint64_t maxDenominator = 0;
+            std::uint64_t tolerance = 0;
+
+            bool operator==(const Key &other) const {
+                return real == other.real && maxDenominator == other.maxDenominator && tolerance == other.tolerance;
+            }
+
+            std::uint64_t hash() const {
+                return kernel::mix(real ^ kernel::mix(maxDenominator * 0x9e3779b97f4a7c15ULL + tolerance));
+            }
+        };
+
+        inline std::uint64_t bitsOf(double real) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &real, sizeof(bits));
+            return bits;
+        }
+
+        /// \brief counters of one thread : written by it only, relaxed loads and stores (see stats::detail::Counter)
+        struct ThreadCounters {
+            stats::detail::Counter hits;
+            stats::detail::Counter sharedHits;
+            stats::detail::Counter misses;
+
+            CacheStatistics load() const {
+                CacheStatistics statistics;
+                statistics.hits = hits.value();
+                statistics.sharedHits = sharedHits.value();
+                statistics.misses = misses.value();
+                return statistics;
+            }
+
+            void clear() {
+                hits.clear();
+                sharedHits.clear();
+                misses.clear();
+            }
+        };
+
+        using Registry = stats::detail::ThreadRegistry<ThreadCounters, CacheStatistics>;
+
+        inline ThreadCounters& counters() {
+            return Registry::local();
+        }
+
+        /// \brief thread-local tier of the ratios of T
+        template <typename T>
+        struct LocalTier {
+            struct Entry {
+                Key key;
+                T numerator{};
+                T denominator{};
+            };
+
+            std::vector<Entry> entries = std::vector<Entry>(localSize);
+        };
+
+        /// \brief a ratio already irreducible (a cached conversion), built without gcd
+        template <typename T>
+        Ratio<T> stored(const T &numerator, const T &denominator) {
+            Ratio<T> rat;
+            rat.numerator() = numerator;
+            rat.denominator() = denominator;
+            return rat;
+        }
+
+        template <typename T>
+        LocalTier<T>& localTier() {
+            static thread_local LocalTier<T> tier;
+            return tier;
+        }
+
+        /// \brief shared tier of the ratios of T : every field is an atomic read and written with relaxed
+        /// accesses, the sequence number (odd while an entry is written) tells a reader a torn entry apart
+        template <typename T>
+        class SharedTier {
+        public :
+
+            struct Entry {
+                std::atomic<std::uint32_t> sequence{0};
+                std::atomic<std::uint64_t> real{0};
+                std::atomic<std::uint64_t> maxDenominator{0};
+                std::atomic<std::uint64_t> tolerance{0};
+                std::atomic<std::uint64_t> numerator{0};
+                std::atomic<std::uint64_t> denominator{0};
+            };
+
+            SharedTier() : m_entries(sharedSize) {}
+
+            /// \brief read an entry
+            /// @return true if the entry holds key, then numerator and denominator are its ratio
+            bool find(std::size_t index, const Key &key, T &numerator, T &denominator) const {
+                const Entry &entry = m_entries[index];
+                const std::uint32_t sequence = entry.sequence.load(std::memory_order_acquire);
+                if(sequence & 1u) {return false;}
+                const Key stored{entry.real.load(std::memory_order_relaxed),
+                                 entry.maxDenominator.load(std::memory_order_relaxed),
+                                 entry.tolerance.load(std::memory_order_relaxed)};
+                const std::uint64_t num = entry.numerator.load(std::memory_order_relaxed);
+                const std::uint64_t den = entry.denominator.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(entry.sequence.load(std::memory_order_relaxed) != sequence || !(stored == key)) {return false;}
+                numerator = static_cast<T>(num);
+                denominator = static_cast<T>(den);
+                return true;
+            }
+
+            /// \brief write an entry, skipped if another thread is writing it
+            void store(std::size_t index, const Key &key, const T &numerator, const T &denominator) {
+                Entry &entry = m_entries[index];
+                std::uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+                if((sequence & 1u) || !entry.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+                entry.real.store(key.real, std::memory_order_relaxed);
+                entry.maxDenominator.store(key.maxDenominator, std::memory_order_relaxed);
+                entry.tolerance.store(key.tolerance, std::memory_order_relaxed);
+                entry.numerator.store(static_cast<std::uint64_t>(numerator), std::memory_order_relaxed);
+                entry.denominator.store(static_cast<std::uint64_t>(denominator), std::memory_order_relaxed);
+                entry.sequence.store(sequence + 2, std::memory_order_release);
+            }
+
+            /// \brief empty every entry (but the ones being written by another thread)
+            void clear() {
+                for(std::size_t i=0; i<m_entries.size(); ++i) {store(i, Key(), T(0), T(1));}
+            }
+
+        private :
+
+            std::vector<Entry> m_entries;
+        };
+
+        template <typename T>
+        SharedTier<T>& sharedTier() {
+            static SharedTier<T> tier;
+            return tier;
+        }
+    }
+
+    /// \brief Ratio<T>::fromReal(real, maxDenominator, tolerance), memoized in the conversion cache
+    /// \param real : a number to convert into a ratio
+    /// \param maxDenominator : largest denominator allowed (the largest T by default)
+    /// \param tolerance : stop at the first convergent closer than tolerance to the real
+    /// @return the same ratio as fromReal
+    template <typename T = int>
+    Ratio<T> cachedFromReal(double real, const T &maxDenominator = std::numeric_limits<T>::max(), double tolerance = 0.0) {
+        static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(std::uint64_t), "Invalid type; should be an integer of at most 64 bits");
+        assert(maxDenominator > T(0) && "maxDenominator should be positive");
+        const cache::Key key{cache::bitsOf(real), static_cast<std::uint64_t>(maxDenominator), cache::bitsOf(tolerance)};
+        const std::uint64_t hash = key.hash();
+
+        typename cache::LocalTier<T>::Entry &local = cache::localTier<T>().entries[hash & (cache::localSize - 1)];
+        if(local.key == key) {
+            cache::counters().hits.add();
+            return cache::stored(local.numerator, local.denominator);
+        }
+
+        cache::SharedTier<T> &shared = cache::sharedTier<T>();
+        const std::size_t sharedIndex = static_cast<std::size_t>(hash >> 32) & (cache::sharedSize - 1);
+        T numerator{}, denominator{};
+        if(shared.find(sharedIndex, key, numerator, denominator)) {
+            cache::counters().sharedHits.add();
+        } else {
+            cache::counters().misses.add();
+            const Ratio<T> result = Ratio<T>::fromReal(real, maxDenominator, tolerance);
+            numerator = result.numerator();
+            denominator = result.denominator();
+            shared.store(sharedIndex, key, numerator, denominator);
+        }
+        local.key = key;
+        local.numerator = numerator;
+        local.denominator = denominator;
+        return cache::stored(numerator, denominator);
+    }
+
+    /// \brief batch version of cachedFromReal
+    /// \param reals : the doubles
+    /// \param size : number of reals
+    /// \param result : the ratios (size elements)
+    /// \param maxDenominator : largest denominator allowed (the largest T by default)
+    /// \param tolerance : stop at the first convergent closer than tolerance to the real
+    template <typename T>
+    void cachedFromReal(const double *reals, std::size_t size, Ratio<T> *result, const T &maxDenominator = std::numeric_limits<T>::max(), double tolerance = 0.0) {
+        for(std::size_t i=0; i<size; ++i) {result[i] = cachedFromReal<T>(reals[i], maxDenominator, tolerance);}
+    }
+
+    /// \brief hits and misses of every thread since the start (or the last resetCacheStatistics)
+    inline CacheStatistics cacheStatistics() {
+        return cache::Registry::total();
+    }
+
+    /// \brief hits and misses of the calling thread
+    inline CacheStatistics threadCacheStatistics() {
+        return cache::counters().load();
+    }
+
+    /// \brief set the counters of every thread to 0
+    inline void resetCacheStatistics() {
+        cache::Registry::clear();
+    }
+
+    /// \brief empty the shared tier of T and the local tier of the calling thread
+    /// (the local tiers of the other threads keep their entries, which are still valid conversions)
+    template <typename T>
+    void clearCache() {
+        for(typename cache::LocalTier<T>::Entry &entry : cache::localTier<T>().entries) {entry.key = cache::Key();}
+        cache::sharedTier<T>().clear();
+    }
+
+    /// \brief memory used by the cache of T
+    /// \param threads : number of threads converting to Ratio<T>
+    /// @return the size in bytes of the shared tier and of the local tiers
+    template <typename T>
+    constexpr std::size_t cacheMemoryBytes(std::size_t threads = 1) {
+        return cache::sharedSize * sizeof(typename cache::SharedTier<T>::Entry) + threads * cache::localSize * sizeof(typename cache::LocalTier<T>::Entry);
+    }
+}
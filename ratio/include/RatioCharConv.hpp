@@ -0,0 +1,245 @@
+#include <limits>
+#include <cstddef>
+#include <cstring>
+#include <charconv>
+#include <type_traits>
+#include <system_error>
+
+#include "Ratio.hpp"
+#include "RatioArray.hpp"
+
+#pragma once
+
+
+/// \file RatioCharConv.hpp
+/// \brief text formatting and parsing of ratios without iostreams nor heap allocation, built on
+/// std::to_chars and std::from_chars (same conventions: the caller owns the buffer, no locale, no
+/// leading whitespace, the result tells where the conversion stopped and why it failed).
+/// Accepted syntaxes : "n", "n/d", "(n/d)" and decimals "-1.25", "2.5e-3" (converted exactly).
+/// \li rto::to_chars / rto::from_chars : one ratio
+/// \li rto::from_chars_column : one column of a CSV buffer, line by line
+
+namespace rto {
+
+    /// \brief output syntax of to_chars
+    enum class CharsFormat {
+        Fraction,       ///< n/d
+        Compact,        ///< n when d is 1, n/d otherwise
+        Parenthesized   ///< (n/d), as operator <<
+    };
+
+    /// \brief size of a buffer large enough for any Ratio<T> written by to_chars
+    template <typename T>
+    constexpr std::size_t maxChars = 2 * (std::numeric_limits<T>::digits10 + 2) + 3;
+
+    namespace kernel {
+
+        /// \brief parse an optional '-' followed by decimal digits, as a magnitude
+        /// \param first, last : the characters
+        /// \param negative : receives true if there is a '-'
+        /// \param magnitude : receives the absolute value
+        /// @return std::from_chars_result (ptr on the first character not parsed)
+        template <typename U>
+        std::from_chars_result parseMagnitude(const char *first, const char *last, bool &negative, U &magnitude) {
+            negative = first != last && *first == '-';
+            const std::from_chars_result result = std::from_chars(first + (negative ? 1 : 0), last, magnitude);
+            if(result.ec == std::errc::invalid_argument) {return {first, result.ec};}
+            return result;
+        }
+
+        /// \brief multiply a magnitude by 10^exponent
+        /// @return false if it overflows U
+        template <typename U>
+        bool scaleByTen(U &value, unsigned int exponent) {
+            for(; exponent > 0; --exponent) {
+                if(overflow::mulOverflows(value, U(10), value)) {return false;}
+            }
+            return true;
+        }
+
+        /// \brief store a reduced signed fraction of magnitudes in a ratio
+        /// @return false if it does not fit in T
+        template <typename T, typename U, typename R>
+        bool storeRatio(bool negative, U numerator, U denominator, R &value) {
+            const U g = rto::gcd(numerator, denominator);
+            if(g > U(1)) {
+                numerator /= g;
+                denominator /= g;
+            }
+            if(numerator == U(0)) {negative = false;}
+            const U max = static_cast<U>(std::numeric_limits<T>::max());
+            if(denominator > max || numerator > max + U(negative && std::numeric_limits<T>::is_signed ? 1 : 0)) {return false;}
+            if(negative && !std::numeric_limits<T>::is_signed) {return false;}
+            value.numerator() = negative ? static_cast<T>(U(0) - numerator) : static_cast<T>(numerator);
+            value.denominator() = static_cast<T>(denominator);
+            return true;
+        }
+
+        /// \brief std::to_chars of an integer, also in constant expressions (std::to_chars is not
+        /// constexpr before C++23 : the digits are then written one by one)
+        /// @return std::to_chars_result, std::errc::value_too_large if the buffer is too small
+        template <typename T>
+        constexpr std::to_chars_result writeInteger(char *first, char *last, const T &value) {
+            if(!constantEvaluated()) {return std::to_chars(first, last, value);}
+            using U = typename unsignedOf<T>::type;
+            U rest = magnitude(value);
+            char digits[std::numeric_limits<U>::digits10 + 1] = {};
+            int count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + static_cast<int>(rest % U(10)));
+                rest /= U(10);
+            } while(rest != U(0));
+            const bool negative = value < T(0);
+            if(last - first < count + (negative ? 1 : 0)) {return {last, std::errc::value_too_large};}
+            if(negative) {*first++ = '-';}
+            while(count > 0) {*first++ = digits[--count];}
+            return {first, std::errc()};
+        }
+    }
+
+    /// \brief write a ratio as text (also in constant expressions)
+    /// \param first, last : the buffer (maxChars<T> characters are always enough)
+    /// \param rat : the ratio
+    /// \param format : the syntax
+    /// @return std::to_chars_result : ptr one past the last character written, or last and
+    /// std::errc::value_too_large if the buffer is too small (its content is then unspecified)
+    template <typename T, typename Norm, typename Overflow>
+    constexpr std::to_chars_result to_chars(char *first, char *last, const Ratio<T,Norm,Overflow> &rat, CharsFormat format = CharsFormat::Fraction) {
+        static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+        T numerator = rat.numerator(), denominator = rat.denominator();
+        if constexpr (std::is_same_v<Norm, Deferred>) {
+            const Ratio<T,Norm,Overflow> reduced(numerator, denominator);
+            numerator = reduced.numerator();
+            denominator = reduced.denominator();
+        }
+        const std::to_chars_result tooLarge = {last, std::errc::value_too_large};
+        if(format == CharsFormat::Parenthesized) {
+            if(first == last) {return tooLarge;}
+            *first++ = '(';
+        }
+        std::to_chars_result result = kernel::writeInteger(first, last, numerator);
+        if(result.ec != std::errc()) {return result;}
+        if(format != CharsFormat::Compact || denominator != T(1)) {
+            if(result.ptr == last) {return tooLarge;}
+            *result.ptr++ = '/';
+            result = kernel::writeInteger(result.ptr, last, denominator);
+            if(result.ec != std::errc()) {return result;}
+        }
+        if(format == CharsFormat::Parenthesized) {
+            if(result.ptr == last) {return tooLarge;}
+            *result.ptr++ = ')';
+        }
+        return result;
+    }
+
+    /// \brief parse a ratio : "n", "n/d", "(n/d)" or a decimal "[-]i.f[e[+-]x]" (exact value)
+    /// \param first, last : the characters (no leading whitespace)
+    /// \param value : receives the irreducible ratio, unchanged on failure
+    /// @return std::from_chars_result : ptr on the first character not parsed; std::errc::invalid_argument
+    /// (and ptr = first) if no ratio starts at first or the denominator is null,
+    /// std::errc::result_out_of_range if the value does not fit in T
+    template <typename T, typename Norm, typename Overflow>
+    std::from_chars_result from_chars(const char *first, const char *last, Ratio<T,Norm,Overflow> &value) {
+        static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+        using U = std::make_unsigned_t<T>;
+        const std::from_chars_result invalid = {first, std::errc::invalid_argument};
+        const bool parenthesized = first != last && *first == '(';
+        const char *ptr = first + (parenthesized ? 1 : 0);
+
+        bool negative = false, outOfRange = false;
+        U numerator{}, denominator = U(1);
+        std::from_chars_result result = kernel::parseMagnitude(ptr, last, negative, numerator);
+        if(result.ec == std::errc::invalid_argument) {return invalid;}
+        outOfRange = result.ec == std::errc::result_out_of_range;
+        ptr = result.ptr;
+
+        if(ptr != last && *ptr == '/') {
+            bool negativeDenominator = false;
+            result = kernel::parseMagnitude(ptr + 1, last, negativeDenominator, denominator);
+            if(result.ec == std::errc::invalid_argument) {return invalid;}
+            outOfRange = outOfRange || result.ec == std::errc::result_out_of_range;
+            if(!outOfRange && denominator == U(0)) {return invalid;}
+            negative = negative != negativeDenominator;
+            ptr = result.ptr;
+        } else if(!parenthesized) {
+            if(ptr != last && *ptr == '.') {
+                // i.f = (i * 10^k + f) / 10^k, the trailing zeros of f are dropped
+                const char *digits = ++ptr;
+                while(ptr != last && *ptr >= '0' && *ptr <= '9') {++ptr;}
+                const char *end = ptr;
+                while(end != digits && end[-1] == '0') {--end;}
+                if(end != digits && !outOfRange) {
+                    U fraction{};
+                    result = std::from_chars(digits, end, fraction);
+                    const unsigned int count = static_cast<unsigned int>(end - digits);
+                    outOfRange = result.ec != std::errc() || !kernel::scaleByTen(numerator, count) || !kernel::scaleByTen(denominator, count)
+                                 || overflow::addOverflows(numerator, fraction, numerator);
+                }
+            }
+            if(ptr != last && (*ptr == 'e' || *ptr == 'E')) {
+                const char *digits = ptr + 1;
+                const bool negativeExponent = digits != last && *digits == '-';
+                if(digits != last && (*digits == '-' || *digits == '+')) {++digits;}
+                unsigned int exponent{};
+                result = std::from_chars(digits, last, exponent);
+                if(result.ec != std::errc::invalid_argument) {
+                    ptr = result.ptr;
+                    if(result.ec == std::errc::result_out_of_range) {
+                        outOfRange = outOfRange || numerator != U(0);
+                    } else if(numerator != U(0) && !outOfRange) {
+                        // 10^exponent cancels the 10^k of the denominator first
+                        while(!negativeExponent && exponent > 0 && denominator % U(10) == U(0)) {
+                            denominator /= U(10);
+                            --exponent;
+                        }
+                        outOfRange = !kernel::scaleByTen(negativeExponent ? denominator : numerator, exponent);
+                    }
+                }
+            }
+        }
+
+        if(parenthesized) {
+            if(ptr == last || *ptr != ')') {return invalid;}
+            ++ptr;
+        }
+        if(outOfRange || !kernel::storeRatio<T>(negative, numerator, denominator, value)) {
+            return {ptr, std::errc::result_out_of_range};
+        }
+        return {ptr, std::errc()};
+    }
+
+    /// \brief parse one column of fractions in a CSV buffer, line by line
+    /// \param first, last : the text, lines separated by '\n' (or "\r\n"), empty lines are skipped
+    /// \param column : index of the column (0 for the first field)
+    /// \param values : the ratios are appended to it
+    /// \param separator : the field separator
+    /// @return std::from_chars_result : ptr = last on success; otherwise ptr on the field that could
+    /// not be parsed (a missing column, spaces aside, or any text after the ratio is invalid_argument)
+    template <typename T>
+    std::from_chars_result from_chars_column(const char *first, const char *last, std::size_t column, RatioArray<T> &values, char separator = ',') {
+        const auto isBlank = [](char c) {return c == ' ' || c == '\t' || c == '\r';};
+        while(first != last) {
+            const char *end = static_cast<const char *>(std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+            if(end == nullptr) {end = last;}
+            const char *field = first;
+            while(field != end && isBlank(*field)) {++field;}
+            if(field != end) {
+                for(std::size_t i=0; i<column; ++i) {
+                    const char *next = static_cast<const char *>(std::memchr(field, separator, static_cast<std::size_t>(end - field)));
+                    if(next == nullptr) {return {field, std::errc::invalid_argument};}
+                    field = next + 1;
+                }
+                while(field != end && isBlank(*field)) {++field;}
+                Ratio<T> rat;
+                const std::from_chars_result result = rto::from_chars(field, end, rat);
+                if(result.ec != std::errc()) {return {field, result.ec};}
+                const char *rest = result.ptr;
+                while(rest != end && isBlank(*rest)) {++rest;}
+                if(rest != end && *rest != separator) {return {field, std::errc::invalid_argument};}
+                values.push_back(rat);
+            }
+            first = end == last ? last : end + 1;
+        }
+        return {last, std::errc()};
+    }
+}
@@ -0,0 +1,218 @@
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+#include "RatioPolicy.hpp"
+#include "RatioGcd.hpp"
+
+#pragma once
+
+
+/// \file RatioExpression.hpp
+/// \brief expression templates used by Ratio<T, Fused>.
+/// a*b + c*d - e builds a tree of nodes; converting the tree into a Ratio evaluates it on raw
+/// (numerator, denominator) pairs in the wide type of the overflow policy, summing on the least
+/// common denominator, and narrows and runs the gcd only once on the final result.
+
+namespace rto {
+
+    template <typename T, typename Norm, typename Overflow> class Ratio;
+
+    namespace expr {
+
+        template <typename Op, typename L, typename R> class Node;
+
+        /// \brief ratio type of an operand (a Ratio or a Node)
+        template <typename X> struct ratioOf {using type = void;};
+        template <typename T, typename Norm, typename Overflow> struct ratioOf<Ratio<T,Norm,Overflow>> {using type = Ratio<T,Norm,Overflow>;};
+        template <typename Op, typename L, typename R> struct ratioOf<Node<Op,L,R>> {using type = typename ratioOf<L>::type;};
+
+        /// \brief raw value of a leaf, in the wide type of the overflow policy
+        /// \param rat : the leaf
+        /// \param num : receives the numerator
+        /// \param den : receives the denominator
+        template <typename T, typename Norm, typename Overflow, typename W>
+        constexpr void evaluate(const Ratio<T,Norm,Overflow> &rat, W &num, W &den) {
+            num = W(rat.numerator());
+            den = W(rat.denominator());
+        }
+
+        /// \brief raw (not normalized) value of a node
+        /// \param node : the node
+        /// \param num : receives the numerator
+        /// \param den : receives the denominator
+        template <typename Op, typename L, typename R, typename W>
+        constexpr void evaluate(const Node<Op,L,R> &node, W &num, W &den) {
+            node.evaluate(num, den);
+        }
+
+        /// \brief sum (or difference) on the least common denominator lcm(ld, rd) = ld/g*rd,
+        /// so that a chain of additions on related denominators does not multiply them
+        template <bool Subtract, typename Overflow, typename W>
+        constexpr void addCommon(const W &ln, const W &ld, const W &rn, const W &rd, W &num, W &den) {
+            if(ld == rd) {
+                num = Subtract ? Overflow::sub(ln, rn) : Overflow::add(ln, rn);
+                den = ld;
+            } else {
+                const W g = rto::gcd(ld, rd);
+                const W left = Overflow::mul(ln, W(rd / g));
+                const W right = Overflow::mul(rn, W(ld / g));
+                num = Subtract ? Overflow::sub(left, right) : Overflow::add(left, right);
+                den = Overflow::mul(W(ld / g), rd);
+            }
+        }
+
+        /// \brief addition node
+        struct Add {
+            template <typename Overflow, typename W>
+            static constexpr void apply(const W &ln, const W &ld, const W &rn, const W &rd, W &num, W &den) {
+                addCommon<false, Overflow>(ln, ld, rn, rd, num, den);
+            }
+        };
+
+        /// \brief subtraction node
+        struct Sub {
+            template <typename Overflow, typename W>
+            static constexpr void apply(const W &ln, const W &ld, const W &rn, const W &rd, W &num, W &den) {
+                addCommon<true, Overflow>(ln, ld, rn, rd, num, den);
+            }
+        };
+
+        /// \brief multiplication node
+        struct Mul {
+            template <typename Overflow, typename W>
+            static constexpr void apply(const W &ln, const W &ld, const W &rn, const W &rd, W &num, W &den) {
+                num = Overflow::mul(ln, rn);
+                den = Overflow::mul(ld, rd);
+            }
+        };
+
+        /// \brief division node, the sign is fixed by the final normalization
+        struct Div {
+            template <typename Overflow, typename W>
+            static constexpr void apply(const W &ln, const W &ld, const W &rn, const W &rd, W &num, W &den) {
+                assert(rn != W(0) && "Division by 0");
+                num = Overflow::mul(ln, rd);
+                den = Overflow::mul(ld, rn);
+            }
+        };
+
+
+        /// \class Node
+        /// \brief lightweight node of a rational expression, holding its operands by value
+        template <typename Op, typename L, typename R>
+        class Node {
+
+        public :
+
+            using ratio_type = typename ratioOf<L>::type;
+            using value_type = typename ratio_type::value_type;
+            using overflow_policy = typename ratio_type::overflow_policy;
+            using wide_type = typename overflow_policy::template wide_type<value_type>;
+
+            /// \brief constructor from the two operands
+            /// \param left : left operand (Ratio or Node)
+            /// \param right : right operand (Ratio or Node)
+            /// @return the node
+            constexpr Node(const L &left, const R &right) : m_left(left), m_right(right) {
+                static_assert(std::is_same_v<ratio_type, typename ratioOf<R>::type>, "Invalid operands; should have the same Ratio type");
+            }
+
+        private :
+
+            L m_left;
+            R m_right;
+
+            /// \brief leaf or node from an operand, numbers become leaves
+            template <typename X>
+            static constexpr auto operand(const X &value) {
+                if constexpr (std::is_arithmetic_v<X>) {
+                    return ratio_type(value);
+                } else {
+                    return value;
+                }
+            }
+
+        public :
+
+            /// \brief raw value of the expression in the wide type of the overflow policy,
+            /// with the operations of the policy (Checked throws on overflow)
+            /// \param num : receives the numerator
+            /// \param den : receives the denominator
+            constexpr void evaluate(wide_type &num, wide_type &den) const {
+                wide_type ln{}, ld{}, rn{}, rd{};
+                expr::evaluate(m_left, ln, ld);
+                expr::evaluate(m_right, rn, rd);
+                Op::template apply<overflow_policy>(ln, ld, rn, rd, num, den);
+            }
+
+            /// \brief evaluate the expression, narrowed to value_type and normalized once
+            /// @return the ratio
+            constexpr ratio_type eval() const {
+                wide_type num{}, den{};
+                evaluate(num, den);
+                if constexpr (std::numeric_limits<value_type>::is_signed) {
+                    if(den < wide_type(0)) {
+                        num = overflow_policy::sub(wide_type(0), num);
+                        den = overflow_policy::sub(wide_type(0), den);
+                    }
+                }
+                value_type numerator{}, denominator{};
+                overflow_policy::narrow(num, den, numerator, denominator);
+                return ratio_type(numerator, denominator);
+            }
+
+            /// \brief conversion to Ratio (assignment evaluates the expression)
+            /// @return the ratio
+            constexpr operator ratio_type() const {return eval();}
+
+            /// \brief operator + (the right operand can be a Ratio, a Node or a number)
+            template <typename X>
+            constexpr friend auto operator+(const Node &left, const X &right) {
+                return Node<Add, Node, decltype(operand(right))>(left, operand(right));
+            }
+
+            /// \brief operator - (the right operand can be a Ratio, a Node or a number)
+            template <typename X>
+            constexpr friend auto operator-(const Node &left, const X &right) {
+                return Node<Sub, Node, decltype(operand(right))>(left, operand(right));
+            }
+
+            /// \brief operator * (the right operand can be a Ratio, a Node or a number)
+            template <typename X>
+            constexpr friend auto operator*(const Node &left, const X &right) {
+                return Node<Mul, Node, decltype(operand(right))>(left, operand(right));
+            }
+
+            /// \brief operator / (the right operand can be a Ratio, a Node or a number)
+            template <typename X>
+            constexpr friend auto operator/(const Node &left, const X &right) {
+                return Node<Div, Node, decltype(operand(right))>(left, operand(right));
+            }
+
+            /// \brief operator + with a Ratio on the left
+            constexpr friend auto operator+(const ratio_type &left, const Node &right) {return Node<Add, ratio_type, Node>(left, right);}
+
+            /// \brief operator - with a Ratio on the left
+            constexpr friend auto operator-(const ratio_type &left, const Node &right) {return Node<Sub, ratio_type, Node>(left, right);}
+
+            /// \brief operator * with a Ratio on the left
+            constexpr friend auto operator*(const ratio_type &left, const Node &right) {return Node<Mul, ratio_type, Node>(left, right);}
+
+            /// \brief operator / with a Ratio on the left
+            constexpr friend auto operator/(const ratio_type &left, const Node &right) {return Node<Div, ratio_type, Node>(left, right);}
+
+            /// \brief unary minus
+            constexpr friend auto operator-(const Node &node) {return Node<Sub, ratio_type, Node>(ratio_type(), node);}
+
+            /// \brief overload the operator << for Node, prints the evaluated ratio
+            /// \param stream : input stream
+            /// \param node : the expression to output
+            /// \return the output stream containing the ratio data
+            friend std::ostream& operator<<(std::ostream& stream, const Node& node) {
+                return stream << node.eval();
+            }
+        };
+    }
+}
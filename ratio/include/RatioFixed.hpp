@@ -0,0 +1,254 @@
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \class FixedRatio
+/// \brief rational with a denominator fixed at compile time (money in cents, sensor readings in 1/1024):
+/// only the numerator is stored, so there is no gcd at all.
+/// \li + and - are a single integer operation
+/// \li * and / compute in the wider integer type and rescale by Den, rounded to the nearest (ties upward);
+/// the rescale is a shift when Den is a power of two, a multiplication by a constant otherwise
+/// \li conversions to and from Ratio<T> are explicit: toRatio() and a constructor (rounded the same way)
+/// \li the batch kernels (add, sub, mul, sum on std::vector) are plain loops the compiler vectorizes
+/// As the default Ratio, results that do not fit in T wrap around.
+/// \tparam T : integer type of the numerator
+/// \tparam Den : the denominator, positive
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief true if Den is a power of two
+        template <typename T>
+        constexpr bool isPowerOfTwo(const T &value) {
+            return value > T(0) && (value & (value - T(1))) == T(0);
+        }
+
+        /// \brief round(numerator / Den), ties upward (floor((numerator + Den/2) / Den))
+        /// \param numerator : a wide value
+        /// @return the quotient, truncated to T
+        template <typename T, T Den, typename W>
+        constexpr T rescale(const W &numerator) {
+            if constexpr (isPowerOfTwo(Den)) {
+                constexpr int shift = bitWidth(static_cast<typename unsignedOf<T>::type>(Den)) - 1;
+                if constexpr (sizeof(W) > sizeof(T)) {
+                    using UW = typename unsignedOf<W>::type;
+                    // logical shift : the bits of T are the ones of the arithmetic shift (shift < bits of T)
+                    // and, unlike 64-bit arithmetic shifts, it vectorizes on AVX2
+                    return static_cast<T>(static_cast<UW>(numerator + W(Den / 2)) >> shift);
+                } else {
+                    return static_cast<T>((numerator + W(Den / 2)) >> shift);
+                }
+            } else {
+                const W shifted = numerator + W(Den / 2);
+                W quotient = shifted / W(Den);
+                if constexpr (std::is_signed_v<W>) {
+                    if(shifted % W(Den) < W(0)) {--quotient;}
+                }
+                return static_cast<T>(quotient);
+            }
+        }
+
+        /// \brief round(numerator / denominator), ties upward, for a positive runtime denominator
+        template <typename W>
+        constexpr W roundedDivide(const W &numerator, const W &denominator) {
+            W quotient = numerator / denominator, remainder = numerator % denominator;
+            if(remainder < W(0)) {
+                --quotient;
+                remainder += denominator;
+            }
+            return remainder >= denominator - remainder ? quotient + W(1) : quotient;
+        }
+    }
+
+    template <typename T, T Den>
+    class FixedRatio {
+
+        static_assert(std::is_integral_v<T>, "Invalid type; should be an integer");
+        static_assert(Den > T(0), "Invalid denominator; should be positive");
+
+        /// \brief type of the products before the rescale
+        using wide_type = std::conditional_t<overflow::hasWider<T>(), typename overflow::wider<T>::type, T>;
+
+    public :
+
+        using value_type = T;
+        static constexpr T denominator_value = Den;
+
+        /// \brief defaultConstructor equal to 0
+        constexpr FixedRatio() : m_numerator(T(0)) {}
+
+        /// \brief constructor from an integer
+        /// \param value : the integer, stored as value * Den
+        constexpr explicit FixedRatio(const T &value) : m_numerator(static_cast<T>(value * Den)) {}
+
+        /// \brief conversion from a Ratio, rounded to the nearest multiple of 1/Den (ties upward)
+        /// \param rat : the rational
+        template <typename Norm, typename Overflow>
+        constexpr explicit FixedRatio(const Ratio<T,Norm,Overflow> &rat) : m_numerator(T(0)) {
+            wide_type num = wide_type(rat.numerator()) * wide_type(Den), den = wide_type(rat.denominator());
+            assert(den != wide_type(0) && "Denominator cannot be equal to 0");
+            if constexpr (std::is_signed_v<T>) {
+                if(den < wide_type(0)) {
+                    num = -num;
+                    den = -den;
+                }
+            }
+            m_numerator = static_cast<T>(kernel::roundedDivide(num, den));
+        }
+
+        /// \brief build from the numerator over Den, without rescale
+        /// \param numerator : the numerator
+        /// @return numerator / Den
+        static constexpr FixedRatio fromNumerator(const T &numerator) {
+            FixedRatio result;
+            result.m_numerator = numerator;
+            return result;
+        }
+
+        /// \brief get numerator
+        /// @return the numerator (over Den)
+        constexpr inline const T & numerator() const {return m_numerator;};
+
+        /// \brief get denominator
+        /// @return Den
+        static constexpr T denominator() {return Den;};
+
+        /// \brief conversion to an irreducible Ratio
+        /// @return numerator / Den
+        template <typename Norm = Eager, typename Overflow = Wrap>
+        constexpr Ratio<T,Norm,Overflow> toRatio() const {
+            return Ratio<T,Norm,Overflow>(m_numerator, Den);
+        }
+
+        /// \brief conversion to a real
+        template <typename U = double>
+        constexpr U toReal() const {
+            static_assert(std::is_floating_point_v<U>, "Invalid type; should be a floating point type");
+            return static_cast<U>(m_numerator) / static_cast<U>(Den);
+        }
+
+        // arithmetic : a single integer operation for + and -, a rescale for * and /
+
+        constexpr friend FixedRatio operator+(const FixedRatio &a, const FixedRatio &b) {
+            return fromNumerator(Wrap::add(a.m_numerator, b.m_numerator));
+        }
+
+        constexpr friend FixedRatio operator-(const FixedRatio &a, const FixedRatio &b) {
+            return fromNumerator(Wrap::sub(a.m_numerator, b.m_numerator));
+        }
+
+        /// \brief product a * b / Den, rounded
+        constexpr friend FixedRatio operator*(const FixedRatio &a, const FixedRatio &b) {
+            return fromNumerator(kernel::rescale<T,Den>(wide_type(a.m_numerator) * wide_type(b.m_numerator)));
+        }
+
+        /// \brief quotient a * Den / b, rounded
+        constexpr friend FixedRatio operator/(const FixedRatio &a, const FixedRatio &b) {
+            assert(b.m_numerator != T(0) && "Division by 0");
+            wide_type num = wide_type(a.m_numerator) * wide_type(Den), den = wide_type(b.m_numerator);
+            if constexpr (std::is_signed_v<T>) {
+                if(den < wide_type(0)) {
+                    num = -num;
+                    den = -den;
+                }
+            }
+            return fromNumerator(static_cast<T>(kernel::roundedDivide(num, den)));
+        }
+
+        /// \brief product by an integer (exact)
+        constexpr friend FixedRatio operator*(const FixedRatio &a, const T &value) {
+            return fromNumerator(Wrap::mul(a.m_numerator, value));
+        }
+
+        constexpr friend FixedRatio operator*(const T &value, const FixedRatio &a) {return a * value;}
+
+        /// \brief unary minus
+        constexpr friend FixedRatio operator-(const FixedRatio &a) {return fromNumerator(Wrap::sub(T(0), a.m_numerator));}
+
+        constexpr FixedRatio & operator+=(const FixedRatio &rat) {return *this = *this + rat;}
+        constexpr FixedRatio & operator-=(const FixedRatio &rat) {return *this = *this - rat;}
+        constexpr FixedRatio & operator*=(const FixedRatio &rat) {return *this = *this * rat;}
+        constexpr FixedRatio & operator/=(const FixedRatio &rat) {return *this = *this / rat;}
+
+        // comparisons : the numerators only
+
+        constexpr friend bool operator==(const FixedRatio &a, const FixedRatio &b) {return a.m_numerator == b.m_numerator;}
+        constexpr friend bool operator!=(const FixedRatio &a, const FixedRatio &b) {return a.m_numerator != b.m_numerator;}
+        constexpr friend bool operator<(const FixedRatio &a, const FixedRatio &b) {return a.m_numerator < b.m_numerator;}
+        constexpr friend bool operator>(const FixedRatio &a, const FixedRatio &b) {return a.m_numerator > b.m_numerator;}
+        constexpr friend bool operator<=(const FixedRatio &a, const FixedRatio &b) {return a.m_numerator <= b.m_numerator;}
+        constexpr friend bool operator>=(const FixedRatio &a, const FixedRatio &b) {return a.m_numerator >= b.m_numerator;}
+
+        /// \brief overload the operator << for FixedRatio, written as the irreducible Ratio
+        friend std::ostream& operator<<(std::ostream& stream, const FixedRatio& rat) {
+            return stream << rat.toRatio();
+        }
+
+    private :
+
+        T m_numerator;
+    };
+
+    // batch kernels : result[i] = a[i] op b[i], result may be one of the operands
+
+    /// \brief batch addition
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the sums, resized to a.size()
+    template <typename T, T Den>
+    void add(const std::vector<FixedRatio<T,Den>> &a, const std::vector<FixedRatio<T,Den>> &b, std::vector<FixedRatio<T,Den>> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] + b[i];}
+    }
+
+    /// \brief batch subtraction
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the differences, resized to a.size()
+    template <typename T, T Den>
+    void sub(const std::vector<FixedRatio<T,Den>> &a, const std::vector<FixedRatio<T,Den>> &b, std::vector<FixedRatio<T,Den>> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] - b[i];}
+    }
+
+    /// \brief batch multiplication
+    /// \param a : left operands
+    /// \param b : right operands (same size as a)
+    /// \param result : the products, resized to a.size()
+    template <typename T, T Den>
+    void mul(const std::vector<FixedRatio<T,Den>> &a, const std::vector<FixedRatio<T,Den>> &b, std::vector<FixedRatio<T,Den>> &result) {
+        assert(a.size()==b.size() && "Arrays must have the same size");
+        result.resize(a.size());
+        for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] * b[i];}
+    }
+
+    /// \brief batch multiplication by a fixed ratio
+    /// \param a : left operands
+    /// \param rat : right operand
+    /// \param result : the products, resized to a.size()
+    template <typename T, T Den>
+    void mul(const std::vector<FixedRatio<T,Den>> &a, const FixedRatio<T,Den> &rat, std::vector<FixedRatio<T,Den>> &result) {
+        result.resize(a.size());
+        for(std::size_t i=0; i<a.size(); ++i) {result[i] = a[i] * rat;}
+    }
+
+    /// \brief sum of fixed ratios (exact, wraps as T)
+    /// \param values : the ratios
+    /// @return the sum
+    template <typename T, T Den>
+    FixedRatio<T,Den> sum(const std::vector<FixedRatio<T,Den>> &values) {
+        T total = T(0);
+        for(const FixedRatio<T,Den> &value : values) {total = Wrap::add(total, value.numerator());}
+        return FixedRatio<T,Den>::fromNumerator(total);
+    }
+}
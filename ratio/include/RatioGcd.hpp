@@ -0,0 +1,310 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "RatioPolicy.hpp"
+#include "RatioStats.hpp"
+
+#pragma once
+
+
+/// \file RatioGcd.hpp
+/// \brief gcd backends used by Ratio::irreducible() and the operators.
+/// The backend is chosen at compile time by defining RTO_GCD_BACKEND before including Ratio.hpp:
+/// \li RTO_GCD_EUCLID : std::gcd (modulo based Euclid, one hardware division per step)
+/// \li RTO_GCD_BINARY : binary (Stein) gcd with count-trailing-zeros, no division (default)
+/// \li RTO_GCD_LEHMER : Lehmer gcd on the leading half-words for 64/128-bit operands,
+/// finished by the binary gcd once the operands fit in half a word
+
+#define RTO_GCD_EUCLID 0
+#define RTO_GCD_BINARY 1
+#define RTO_GCD_LEHMER 2
+
+#ifndef RTO_GCD_BACKEND
+#define RTO_GCD_BACKEND RTO_GCD_BINARY
+#endif
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief unsigned type with the same bits as T (also for 128-bit integers)
+        template <typename T> struct unsignedOf {using type = std::make_unsigned_t<T>;};
+    #if defined(__SIZEOF_INT128__)
+        template <> struct unsignedOf<overflow::int128> {using type = overflow::uint128;};
+        template <> struct unsignedOf<overflow::uint128> {using type = overflow::uint128;};
+    #endif
+
+        /// \brief number of trailing zeros of a non-null unsigned value
+        /// \param x : the value (must not be 0)
+        /// @return the number of trailing zeros
+        template <typename U>
+        constexpr int countTrailingZeros(U x) {
+        #if defined(__GNUC__) || defined(__clang__)
+            if constexpr (sizeof(U) <= sizeof(unsigned int)) {
+                return __builtin_ctz(x);
+            } else if constexpr (sizeof(U) <= sizeof(unsigned long)) {
+                return __builtin_ctzl(x);
+            } else if constexpr (sizeof(U) <= sizeof(unsigned long long)) {
+                return __builtin_ctzll(x);
+            } else {
+                const unsigned long long low = static_cast<unsigned long long>(x);
+                return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<unsigned long long>(x >> 64));
+            }
+        #else
+            int count = 0;
+            while((x & U(1)) == U(0)) {
+                x >>= 1;
+                ++count;
+            }
+            return count;
+        #endif
+        }
+
+        /// \brief number of significant bits of an unsigned value
+        /// \param x : the value
+        /// @return the position of the highest set bit plus one (0 for 0)
+        template <typename U>
+        constexpr int bitWidth(U x) {
+            int width = 0;
+            if constexpr (sizeof(U) > 8) {
+                if(x >> 64) {
+                    x >>= 64;
+                    width = 64;
+                }
+            }
+        #if defined(__GNUC__) || defined(__clang__)
+            const unsigned long long word = static_cast<unsigned long long>(x);
+            return word ? width + 64 - __builtin_clzll(word) : width;
+        #else
+            while(x) {
+                x >>= 1;
+                ++width;
+            }
+            return width;
+        #endif
+        }
+
+        /// \brief absolute value as an unsigned integer
+        template <typename T>
+        constexpr typename unsignedOf<T>::type magnitude(const T &value) {
+            using U = typename unsignedOf<T>::type;
+            if constexpr (std::is_unsigned_v<T>) {
+                return value;
+            } else {
+                return value < T(0) ? U(0) - U(value) : U(value);
+            }
+        }
+
+        /// \brief integer square root (Newton's iteration, decreasing from a power of two above the root)
+        /// \param n : an unsigned value
+        /// @return floor(sqrt(n))
+        template <typename U>
+        constexpr U isqrt(const U &n) {
+            if(n < U(2)) {return n;}
+            U x = U(1) << ((bitWidth(n) + 1) / 2);
+            U y = (x + n / x) >> 1;
+            while(y < x) {
+                x = y;
+                y = (x + n / x) >> 1;
+            }
+            return x;
+        }
+
+        /// \brief binary (Stein) gcd of unsigned values, no hardware division
+        /// \param u : first integer
+        /// \param v : second integer
+        /// @return the gcd of u and v, 0 if both are null
+        template <typename U>
+        constexpr U binaryGcd(U u, U v) {
+            if(u == U(0)) {return v;}
+            if(v == U(0)) {return u;}
+
+            const int shift = countTrailingZeros<U>(u | v);
+            u >>= countTrailingZeros<U>(u);
+            do {
+                v >>= countTrailingZeros<U>(v);
+                const U low = u < v ? u : v;
+                v = (u < v ? v : u) - low;
+                u = low;
+            } while(v != U(0));
+            return u << shift;
+        }
+
+        /// \brief Lehmer gcd of unsigned values (Knuth, TAOCP 4.5.2 algorithm L): the quotients are
+        /// computed on the leading Digits bits only and applied to the full operands at once
+        /// \param u : first integer
+        /// \param v : second integer
+        /// @return the gcd of u and v, 0 if both are null
+        template <typename U>
+        constexpr U lehmerGcd(U u, U v) {
+            constexpr int bits = static_cast<int>(sizeof(U)) * 8;
+            if constexpr (bits < 64) {
+                return binaryGcd(u, v);
+            } else {
+                // cofactors stay below 2^Digits, so they fit in a signed half-word
+                constexpr int digits = bits / 2 - 4;
+                using S = std::conditional_t<bits == 64, std::int32_t, std::int64_t>;
+                if(u < v) {
+                    U temp = u;
+                    u = v;
+                    v = temp;
+                }
+                while(v >> (bits / 2)) {
+                    const int shift = bitWidth(u) - digits;
+                    S x = static_cast<S>(u >> shift);
+                    S y = static_cast<S>(v >> shift);
+                    S a = 1, b = 0, c = 0, d = 1;
+                    // x+a, x+b, y+c and y+d stay in [0, 2^Digits] : the second quotient is checked by a product
+                    while(y + c != 0 && y + d != 0) {
+                        const S q = (x + a) / (y + c);
+                        const S r = (x + b) - q * (y + d);
+                        if(r < 0 || r >= y + d) {break;}
+                        S t = a - q * c; a = c; c = t;
+                        t = b - q * d; b = d; d = t;
+                        t = x - q * y; x = y; y = t;
+                    }
+                    if(b == 0) {
+                        // the leading digits did not give a quotient : one full Euclid step
+                        const U r = u % v;
+                        u = v;
+                        v = r;
+                    } else {
+                        // exact results in [0, 2^bits), so wrapping arithmetic is enough
+                        const U nu = U(a) * u + U(b) * v;
+                        const U nv = U(c) * u + U(d) * v;
+                        u = nu;
+                        v = nv;
+                    }
+                }
+                if(v == U(0)) {return u;}
+                using H = std::conditional_t<bits == 64, std::uint32_t, std::uint64_t>;
+                return U(binaryGcd<H>(static_cast<H>(u % v), static_cast<H>(v)));
+            }
+        }
+
+    #if defined(__AVX2__)
+
+        /// \brief per lane number of trailing zeros (the exponent of the lowest set bit converted to float)
+        /// \param x : 8 unsigned 32-bit lanes
+        /// @return the count per lane, a value greater than 31 for null lanes
+        inline __m256i countTrailingZeros(__m256i x) {
+            const __m256i lowest = _mm256_and_si256(x, _mm256_sub_epi32(_mm256_setzero_si256(), x));
+            const __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(lowest));
+            const __m256i exponent = _mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xFF));
+            return _mm256_sub_epi32(exponent, _mm256_set1_epi32(127));
+        }
+
+        /// \brief per lane binary gcd of 8 pairs of 32-bit integers
+        /// \param a : first integers
+        /// \param b : second integers
+        /// @return the (positive) gcd per lane, 0 where both are null
+        inline __m256i binaryGcd(__m256i a, __m256i b) {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i u = _mm256_abs_epi32(a);
+            __m256i v = _mm256_abs_epi32(b);
+
+            // gcd(0,v)=v and gcd(u,0)=u : replace a null operand by the other one
+            u = _mm256_blendv_epi8(u, v, _mm256_cmpeq_epi32(u, zero));
+            v = _mm256_blendv_epi8(v, u, _mm256_cmpeq_epi32(v, zero));
+
+            const __m256i shift = countTrailingZeros(_mm256_or_si256(u, v));
+            u = _mm256_srlv_epi32(u, countTrailingZeros(u));
+            while(!_mm256_testz_si256(v, v)) {
+                v = _mm256_srlv_epi32(v, countTrailingZeros(v));
+                const __m256i done = _mm256_cmpeq_epi32(v, zero);
+                const __m256i low = _mm256_min_epu32(u, v);
+                const __m256i high = _mm256_max_epu32(u, v);
+                u = _mm256_blendv_epi8(low, u, done);
+                v = _mm256_andnot_si256(done, _mm256_sub_epi32(high, low));
+            }
+            return _mm256_sllv_epi32(u, shift);
+        }
+
+    #endif
+    }
+
+    // gcd backends
+
+    /// \brief std::gcd, modulo based Euclid
+    struct EuclidGcd {
+        template <typename T>
+        static constexpr T compute(const T &a, const T &b) {
+            if constexpr (sizeof(T) > 8) {
+                return overflow::gcd(a, b);
+            } else {
+                return std::gcd(a, b);
+            }
+        }
+    };
+
+    /// \brief binary (Stein) gcd, shifts and subtractions only
+    struct BinaryGcd {
+        template <typename T>
+        static constexpr T compute(const T &a, const T &b) {
+            return static_cast<T>(kernel::binaryGcd(kernel::magnitude(a), kernel::magnitude(b)));
+        }
+    };
+
+    /// \brief Lehmer gcd for 64/128-bit operands, binary gcd below
+    struct LehmerGcd {
+        template <typename T>
+        static constexpr T compute(const T &a, const T &b) {
+            return static_cast<T>(kernel::lehmerGcd(kernel::magnitude(a), kernel::magnitude(b)));
+        }
+    };
+
+#if RTO_GCD_BACKEND == RTO_GCD_EUCLID
+    using DefaultGcd = EuclidGcd;
+#elif RTO_GCD_BACKEND == RTO_GCD_LEHMER
+    using DefaultGcd = LehmerGcd;
+#else
+    using DefaultGcd = BinaryGcd;
+#endif
+
+    /// \brief gcd with the backend selected by RTO_GCD_BACKEND
+    /// \param a : first integer
+    /// \param b : second integer
+    /// @return the (positive) gcd of a and b, 0 if both are null
+    template <typename T>
+    constexpr T gcd(const T &a, const T &b) {
+        if constexpr (stats::enabled) {
+            stats::gcdCall(kernel::bitWidth(kernel::magnitude(a) | kernel::magnitude(b)));
+        }
+        return DefaultGcd::compute(a, b);
+    }
+
+    /// \brief batched gcd : result[i] = gcd(a[i], b[i]), 8 lanes at once with AVX2 for 32-bit types
+    /// \param a : first integers
+    /// \param b : second integers
+    /// \param result : the gcds (may alias a or b)
+    /// \param size : number of pairs
+    template <typename T>
+    void gcd(const T *a, const T *b, T *result, std::size_t size) {
+        std::size_t i=0;
+    #if defined(__AVX2__)
+        if constexpr (stats::enabled && std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4) {
+            for(std::size_t j=0; j+8<=size; j+=8) {
+                for(std::size_t k=j; k<j+8; ++k) {
+                    stats::gcdCall(kernel::bitWidth(kernel::magnitude(a[k]) | kernel::magnitude(b[k])));
+                }
+            }
+        }
+        if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4) {
+            for(; i+8<=size; i+=8) {
+                const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a+i));
+                const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b+i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(result+i), kernel::binaryGcd(va, vb));
+            }
+        }
+    #endif
+        for(; i<size; ++i) {
+            result[i] = gcd(a[i], b[i]);
+        }
+    }
+}
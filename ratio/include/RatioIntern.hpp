@@ -0,0 +1,207 @@
+#include <mutex>
+#include <limits>
+#include <cassert>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <shared_mutex>
+
+#include "Ratio.hpp"
+#include "RatioArray.hpp"
+
+#pragma once
+
+
+/// \class RatioInternTable
+/// \brief interning of ratios : every distinct value gets a dense 32-bit id (0, 1, 2... in order of
+/// first appearance), so that repeated ratios are stored once and compared by id.
+/// The values are kept as a RatioArray indexed by id; the index is an open-addressing flat hash table
+/// (linear probing, load factor at most 1/2) of 64-bit slots holding the id and 32 bits of the hash,
+/// so that a probe only reads the values on a hash match.
+/// Ratios are interned in canonical form (irreducible, positive denominator): 1/-2 and -1/2 share an id.
+/// Thread safety: the const members (find, operator[], size) can run on any number of threads at once,
+/// together with intern() on others (a std::shared_mutex, taken once per call by the batch versions).
+/// \tparam T : integer type of the numerator and the denominator
+
+namespace rto {
+
+    template <typename T = int>
+    class RatioInternTable {
+
+    public :
+
+        using id_type = std::uint32_t;
+
+        /// \brief id returned by find() for a ratio that is not in the table
+        static constexpr id_type invalid = std::numeric_limits<id_type>::max();
+
+        /// \brief defaultConstructor, empty table
+        RatioInternTable() : m_slots(minSlots, emptySlot), m_mask(minSlots - 1) {}
+
+        /// \brief constructor of an empty table
+        /// \param capacity : number of distinct ratios to make room for
+        explicit RatioInternTable(std::size_t capacity) : RatioInternTable() {
+            reserve(capacity);
+        }
+
+        RatioInternTable(const RatioInternTable &) = delete;
+        RatioInternTable& operator=(const RatioInternTable &) = delete;
+
+        /// \brief id of a ratio, added to the table if it is new
+        /// \param rat : the ratio
+        /// \throw std::length_error if the table already holds 2^32 - 1 ratios
+        /// @return its id
+        template <typename Norm, typename Overflow>
+        id_type intern(const Ratio<T,Norm,Overflow> &rat) {
+            T numerator{}, denominator{};
+            canonical(rat, numerator, denominator);
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            return insert(numerator, denominator);
+        }
+
+        /// \brief batch intern, under a single lock
+        /// \param values : the ratios
+        /// @return their ids
+        std::vector<id_type> intern(const RatioArray<T> &values) {
+            std::vector<id_type> ids(values.size());
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            for(std::size_t i=0; i<values.size(); ++i) {
+                T numerator{}, denominator{};
+                canonical(values[i], numerator, denominator);
+                ids[i] = insert(numerator, denominator);
+            }
+            return ids;
+        }
+
+        /// \brief batch intern, under a single lock
+        /// \param values : the ratios
+        /// @return their ids
+        template <typename Norm, typename Overflow>
+        std::vector<id_type> intern(const std::vector<Ratio<T,Norm,Overflow>> &values) {
+            std::vector<id_type> ids(values.size());
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            for(std::size_t i=0; i<values.size(); ++i) {
+                T numerator{}, denominator{};
+                canonical(values[i], numerator, denominator);
+                ids[i] = insert(numerator, denominator);
+            }
+            return ids;
+        }
+
+        /// \brief id of a ratio already interned
+        /// \param rat : the ratio
+        /// @return its id, invalid if it is not in the table
+        template <typename Norm, typename Overflow>
+        id_type find(const Ratio<T,Norm,Overflow> &rat) const {
+            T numerator{}, denominator{};
+            canonical(rat, numerator, denominator);
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            return lookup(numerator, denominator, kernel::hashRatio(numerator, denominator));
+        }
+
+        /// \brief the ratio of an id
+        /// \param id : an id returned by intern()
+        /// @return the irreducible ratio, with a positive denominator
+        Ratio<T> operator[](id_type id) const {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            assert(id < m_values.size() && "Unknown id");
+            return m_values[id];
+        }
+
+        /// \brief number of distinct ratios
+        std::size_t size() const {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            return m_values.size();
+        }
+
+        /// \brief make room for capacity distinct ratios, without rehash until then
+        void reserve(std::size_t capacity) {
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            m_values.reserve(capacity);
+            std::size_t slots = m_slots.size();
+            while(slots < 2 * capacity) {slots *= 2;}
+            if(slots != m_slots.size()) {rehash(slots);}
+        }
+
+        /// \brief memory used by the values and the index
+        /// @return the size in bytes
+        std::size_t memoryBytes() const {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            return m_values.size() * 2 * sizeof(T) + m_slots.size() * sizeof(std::uint64_t);
+        }
+
+    private :
+
+        static constexpr std::size_t minSlots = 16;
+        /// \brief a slot is (32 bits of hash << 32) | id, all ones when empty
+        static constexpr std::uint64_t emptySlot = ~std::uint64_t(0);
+
+        RatioArray<T> m_values;
+        std::vector<std::uint64_t> m_slots;
+        std::size_t m_mask;
+        mutable std::shared_mutex m_mutex;
+
+        /// \brief irreducible form with a positive denominator
+        template <typename Norm, typename Overflow>
+        static void canonical(const Ratio<T,Norm,Overflow> &rat, T &numerator, T &denominator) {
+            numerator = rat.numerator();
+            denominator = rat.denominator();
+            if constexpr (!std::is_same_v<Norm, Eager>) {
+                const Ratio<T> reduced(numerator, denominator);
+                numerator = reduced.numerator();
+                denominator = reduced.denominator();
+            }
+            if constexpr (std::is_signed_v<T>) {
+                if(denominator < T(0)) {
+                    numerator = Wrap::sub(T(0), numerator);
+                    denominator = Wrap::sub(T(0), denominator);
+                }
+            }
+        }
+
+        /// \brief probe the index (the lock is held by the caller)
+        id_type lookup(const T &numerator, const T &denominator, std::uint64_t hash) const {
+            const std::uint64_t tag = hash >> 32;
+            const T *num = m_values.numerators(), *den = m_values.denominators();
+            for(std::size_t i = static_cast<std::size_t>(hash) & m_mask;; i = (i + 1) & m_mask) {
+                const std::uint64_t slot = m_slots[i];
+                if(slot == emptySlot) {return invalid;}
+                const id_type id = static_cast<id_type>(slot);
+                if((slot >> 32) == tag && num[id] == numerator && den[id] == denominator) {return id;}
+            }
+        }
+
+        /// \brief find or add a canonical ratio (the unique lock is held by the caller)
+        id_type insert(const T &numerator, const T &denominator) {
+            const std::uint64_t hash = kernel::hashRatio(numerator, denominator);
+            const id_type found = lookup(numerator, denominator, hash);
+            if(found != invalid) {return found;}
+            if(m_values.size() >= static_cast<std::size_t>(invalid)) {throw std::length_error("rto::RatioInternTable : more than 2^32 - 1 ratios");}
+            if(2 * (m_values.size() + 1) > m_slots.size()) {
+                rehash(2 * m_slots.size());
+            }
+            const id_type id = static_cast<id_type>(m_values.size());
+            m_values.push_back(Ratio<T>(numerator, denominator));
+            place(hash, id);
+            return id;
+        }
+
+        /// \brief put an id in the first empty slot of its probe sequence
+        void place(std::uint64_t hash, id_type id) {
+            std::size_t i = static_cast<std::size_t>(hash) & m_mask;
+            while(m_slots[i] != emptySlot) {i = (i + 1) & m_mask;}
+            m_slots[i] = ((hash >> 32) << 32) | id;
+        }
+
+        /// \brief rebuild the index with a number of slots (a power of two)
+        void rehash(std::size_t slots) {
+            m_slots.assign(slots, emptySlot);
+            m_mask = slots - 1;
+            const T *num = m_values.numerators(), *den = m_values.denominators();
+            for(std::size_t id=0; id<m_values.size(); ++id) {
+                place(kernel::hashRatio(num[id], den[id]), static_cast<id_type>(id));
+            }
+        }
+    };
+}
@@ -0,0 +1,329 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \file RatioMath.hpp
+/// \brief transcendental functions of ratios with a guaranteed error bound:
+/// sin, cos, tan, exp and log (x, tolerance, maxDenominator).
+/// The argument is converted once to a 60-bit fixed-point integer, reduced with constants stored
+/// on 120 bits (pi/2, ln 2), and the truncated series run on integers with coefficients tables
+/// computed at compile time (no gcd, no floating point). The exact fraction of the fixed-point
+/// result is then expanded as a continued fraction, stopping at the first convergent within the
+/// tolerance (the error of the fixed-point evaluation, below 2^-54 relative to the result, is
+/// taken out of it first) or at the best approximation whose denominator does not exceed
+/// maxDenominator.
+/// Needs a signed integer type of at most 64 bits and the 128-bit integers of the compiler.
+/// The single argument versions (friends of Ratio) still go through double.
+
+#if defined(__SIZEOF_INT128__)
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief fixed-point numbers : the integer X stands for X / 2^fixedBits
+        using fixed = overflow::int128;
+        using ufixed = overflow::uint128;
+        constexpr int fixedBits = 60;
+        constexpr fixed fixedOne = fixed(1) << fixedBits;
+
+        /// \brief bound of the error of the fixed-point evaluations, relative to the result (or to 1 when the result is smaller)
+        constexpr double fixedError = 0x1p-54;
+
+        /// \brief constants on 120 bits : high + low / 2^fixedBits, in units of 2^-fixedBits
+        constexpr fixed halfPiHigh = 0x1921fb54442d1846, halfPiLow = 0x09898cc51701b83a;
+        constexpr fixed ln2High = 0x0b17217f7d1cf79a, ln2Low = 0x0bc9e3b39803f2f7;
+        constexpr fixed sqrt2 = 0x16a09e667f3bcc91, halfSqrt2 = 0x0b504f333f9de648;
+
+        /// \brief product of two fixed-point numbers, rounded
+        constexpr fixed fixedMul(const fixed &a, const fixed &b) {
+            return (a * b + (fixed(1) << (fixedBits - 1))) >> fixedBits;
+        }
+
+        /// \brief fixed-point table of f(n) = sign(n) / denominator(n), rounded
+        template <std::size_t N, typename Denominator>
+        constexpr std::array<fixed, N> fixedTable(const Denominator &denominator, bool alternate) {
+            std::array<fixed, N> table{};
+            for(std::size_t n=0; n<N; ++n) {
+                const fixed den = denominator(n);
+                const fixed value = (fixedOne + den / 2) / den;
+                table[n] = alternate && n % 2 ? -value : value;
+            }
+            return table;
+        }
+
+        constexpr fixed factorial(std::size_t n) {
+            fixed result = 1;
+            for(std::size_t i=2; i<=n; ++i) {result *= fixed(i);}
+            return result;
+        }
+
+        /// \brief series coefficients: (-1)^n/(2n+1)!, (-1)^n/(2n)!, 1/n! and 1/(2n+1); the terms left out
+        /// are below 2^-70 on the reduced ranges (|r| <= pi/4 + 2^-50, |r| <= ln2/2 + 2^-50, |z| <= 0.172)
+        constexpr std::array<fixed, 10> sinTable = fixedTable<10>([](std::size_t n) {return factorial(2*n + 1);}, true);
+        constexpr std::array<fixed, 10> cosTable = fixedTable<10>([](std::size_t n) {return factorial(2*n);}, true);
+        constexpr std::array<fixed, 18> expTable = fixedTable<18>([](std::size_t n) {return factorial(n);}, false);
+        constexpr std::array<fixed, 14> atanhTable = fixedTable<14>([](std::size_t n) {return fixed(2*n + 1);}, false);
+
+        /// \brief Horner scheme of sum table[n] * x^n in fixed point
+        template <std::size_t N>
+        constexpr fixed fixedHorner(const std::array<fixed, N> &table, const fixed &x) {
+            fixed sum = table[N-1];
+            for(std::size_t n=N-1; n-- > 0;) {
+                sum = table[n] + fixedMul(x, sum);
+            }
+            return sum;
+        }
+
+        /// \brief a ratio in fixed point, truncated (error below 2^-fixedBits)
+        template <typename T>
+        constexpr fixed toFixed(const T &numerator, const T &denominator) {
+            return fixed(numerator) * fixedOne / fixed(denominator);
+        }
+
+        /// \brief x - k * constant, the constant given on 120 bits
+        constexpr fixed reduce(const fixed &x, const fixed &k, const fixed &high, const fixed &low) {
+            return x - k * high - ((k * low + (fixed(1) << (fixedBits - 1))) >> fixedBits);
+        }
+
+        /// \brief x - k * constant with k the nearest integer of x / constant (|result| <= constant / 2 + 2^-fixedBits)
+        /// \param k : receives the quotient
+        constexpr fixed reduceNearest(const fixed &x, const fixed &high, const fixed &low, fixed &k) {
+            const auto quotient = [&high](const fixed &value) {return (value + (value < 0 ? -high / 2 : high / 2)) / high;};
+            // the quotient by high alone may be a few units off for large x : one correction on the remainder
+            k = quotient(x);
+            const fixed correction = quotient(reduce(x, k, high, low));
+            k += correction;
+            return reduce(x, k, high, low);
+        }
+
+        /// \brief sine and cosine in fixed point
+        /// \param x : the argument, |x| < 2^64
+        /// @return {sin x, cos x}
+        inline std::pair<fixed, fixed> fixedSinCos(const fixed &x) {
+            fixed k{};
+            const fixed r = reduceNearest(x, halfPiHigh, halfPiLow, k);
+            const fixed r2 = fixedMul(r, r);
+            const fixed s = fixedMul(r, fixedHorner(sinTable, r2));
+            const fixed c = fixedHorner(cosTable, r2);
+            switch(static_cast<int>(k & 3)) {
+                case 0 : return {s, c};
+                case 1 : return {c, -s};
+                case 2 : return {-s, -c};
+                default : return {-c, s};
+            }
+        }
+
+        /// \brief exponential in fixed point, exp(x) = mantissa * 2^exponent
+        /// \param x : the argument, |x| < 2^64
+        /// @return {mantissa in [0.7, 1.42], exponent}
+        inline std::pair<fixed, fixed> fixedExp(const fixed &x) {
+            fixed k{};
+            const fixed r = reduceNearest(x, ln2High, ln2Low, k);
+            return {fixedHorner(expTable, r), k};
+        }
+
+        /// \brief logarithm in fixed point of p/q > 0 : p/q = m * 2^k with m in [sqrt(2)/2, sqrt(2)),
+        /// log(m) = 2 atanh((m-1)/(m+1))
+        template <typename T>
+        fixed fixedLog(const T &p, const T &q) {
+            int k = bitWidth(magnitude(p)) - bitWidth(magnitude(q));
+            // m = p / (q * 2^k) on fixedBits bits (the shifted operands stay below 2^125)
+            const int shift = fixedBits - k;
+            fixed m = shift >= 0 ? (fixed(p) << shift) / fixed(q) : fixed(p) / (fixed(q) << -shift);
+            if(m >= sqrt2) {
+                m >>= 1;
+                ++k;
+            } else if(m < halfSqrt2) {
+                m <<= 1;
+                --k;
+            }
+            const fixed z = (m - fixedOne) * fixedOne / (m + fixedOne);
+            const fixed logM = 2 * fixedMul(z, fixedHorner(atanhTable, fixedMul(z, z)));
+            return logM + fixed(k) * ln2High + ((fixed(k) * ln2Low + (fixed(1) << (fixedBits - 1))) >> fixedBits);
+        }
+
+        /// \brief best approximation of a/b by continued fraction, on exact integers: the first convergent
+        /// within tolerance, or the best (semi)convergent whose denominator does not exceed maxDenominator
+        /// \param negative : sign of the result
+        /// \param a, b : the fraction (b > 0)
+        /// \param tolerance : the error allowed
+        /// \param maxDenominator : largest denominator allowed
+        /// \throw std::overflow_error if the integer part of a/b does not fit in T
+        /// @return the irreducible ratio
+        template <typename R, typename U>
+        R approximateFraction(bool negative, U a, U b, double tolerance, const typename R::value_type &maxDenominator) {
+            using T = typename R::value_type;
+            using UT = typename unsignedOf<T>::type;
+            constexpr UT maxNumerator = static_cast<UT>(std::numeric_limits<T>::max());
+            const UT maxDen = static_cast<UT>(maxDenominator);
+            if(a / b > U(maxNumerator)) {throw std::overflow_error("rto : the result does not fit in the integer type");}
+
+            // h1/k1 last convergent, h2/k2 the previous one, a/b the current complete quotient
+            UT h1 = 1, k1 = 0, h2 = 0, k2 = 1;
+            int steps = 0;
+            bool bounded = false;
+            while(true) {
+                ++steps;
+                const U wide = a / b, remainder = a % b;
+                UT digit = static_cast<UT>(wide), h{}, k{};
+                const bool fits = wide <= U(maxNumerator)
+                                  && !overflow::mulOverflows(digit, h1, h) && !overflow::addOverflows(h, h2, h) && h <= maxNumerator
+                                  && !overflow::mulOverflows(digit, k1, k) && !overflow::addOverflows(k, k2, k) && k <= maxDen;
+                if(!fits) {
+                    // largest semiconvergent in bounds, better than h1/k1 when its digit is above half the full one
+                    UT semi = k1 ? (maxDen - k2) / k1 : maxNumerator;
+                    if(h1) {semi = std::min<UT>(semi, (maxNumerator - h2) / h1);}
+                    if(semi > UT(0) && U(semi) * 2 >= wide) {
+                        const UT hs = semi * h1 + h2, ks = semi * k1 + k2;
+                        const double value = static_cast<double>(a) / static_cast<double>(b);
+                        // errors measured from the complete quotient (positive terms, no cancellation)
+                        const double semiError = (value - static_cast<double>(semi)) / (static_cast<double>(ks) * (value * static_cast<double>(k1) + static_cast<double>(k2)));
+                        const double error = 1.0 / (static_cast<double>(k1) * (value * static_cast<double>(k1) + static_cast<double>(k2)));
+                        if(U(semi) * 2 > wide || semiError < error) {
+                            h1 = hs;
+                            k1 = ks;
+                        }
+                    }
+                    bounded = true;
+                    break;
+                }
+                h2 = h1; h1 = h;
+                k2 = k1; k1 = k;
+                if(remainder == U(0)) {break;}
+                // |a/b - h1/k1| = r / (k1 * (b*k1 + r*k2))
+                const double error = static_cast<double>(remainder) / (static_cast<double>(k1) * (static_cast<double>(b) * static_cast<double>(k1) + static_cast<double>(remainder) * static_cast<double>(k2)));
+                if(error * (1 + 0x1p-40) <= tolerance) {break;}
+                a = b;
+                b = remainder;
+            }
+            stats::conversion(steps, bounded);
+            R result;
+            result.numerator() = negative ? static_cast<T>(-static_cast<T>(h1)) : static_cast<T>(h1);
+            result.denominator() = static_cast<T>(k1);
+            return result;
+        }
+
+        /// \brief approximate a fixed-point value (or a quotient of two of them)
+        template <typename R>
+        R approximateFixed(const fixed &numerator, const fixed &denominator, double tolerance, const typename R::value_type &maxDenominator) {
+            const bool negative = (numerator < 0) != (denominator < 0) && numerator != 0;
+            const ufixed a = magnitude(numerator), b = magnitude(denominator);
+            if((a >> 64) == 0 && (b >> 64) == 0) {
+                return approximateFraction<R>(negative, static_cast<std::uint64_t>(a), static_cast<std::uint64_t>(b), tolerance, maxDenominator);
+            }
+            return approximateFraction<R>(negative, a, b, tolerance, maxDenominator);
+        }
+
+        /// \brief tolerance left once the error of the fixed-point evaluation is taken out
+        inline double remainingTolerance(double tolerance, double error) {
+            return tolerance > error ? tolerance - error : 0.0;
+        }
+
+        template <typename T>
+        constexpr void checkMathType() {
+            static_assert(std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) <= 8, "Invalid type; should be a signed integer of at most 64 bits");
+        }
+    }
+
+    /// \brief sine with a bounded error
+    /// \param x : the argument
+    /// \param tolerance : largest error allowed (down to 2^-54)
+    /// \param maxDenominator : largest denominator of the result
+    /// @return the first convergent of sin(x) within tolerance, or its best approximation with a denominator up to maxDenominator
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T,Norm,Overflow> sin(const Ratio<T,Norm,Overflow> &x, double tolerance, const typename Ratio<T,Norm,Overflow>::value_type &maxDenominator = std::numeric_limits<T>::max()) {
+        kernel::checkMathType<T>();
+        const kernel::fixed s = kernel::fixedSinCos(kernel::toFixed(x.numerator(), x.denominator())).first;
+        return kernel::approximateFixed<Ratio<T,Norm,Overflow>>(s, kernel::fixedOne, kernel::remainingTolerance(tolerance, kernel::fixedError), maxDenominator);
+    }
+
+    /// \brief cosine with a bounded error
+    /// \param x : the argument
+    /// \param tolerance : largest error allowed (down to 2^-54)
+    /// \param maxDenominator : largest denominator of the result
+    /// @return the first convergent of cos(x) within tolerance, or its best approximation with a denominator up to maxDenominator
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T,Norm,Overflow> cos(const Ratio<T,Norm,Overflow> &x, double tolerance, const typename Ratio<T,Norm,Overflow>::value_type &maxDenominator = std::numeric_limits<T>::max()) {
+        kernel::checkMathType<T>();
+        const kernel::fixed c = kernel::fixedSinCos(kernel::toFixed(x.numerator(), x.denominator())).second;
+        return kernel::approximateFixed<Ratio<T,Norm,Overflow>>(c, kernel::fixedOne, kernel::remainingTolerance(tolerance, kernel::fixedError), maxDenominator);
+    }
+
+    /// \brief tangent with a bounded error, the quotient of the fixed-point sine and cosine is expanded directly
+    /// \param x : the argument
+    /// \param tolerance : largest error allowed (down to 2^-54 (1 + tan(x)^2) / |cos(x)|)
+    /// \param maxDenominator : largest denominator of the result
+    /// \throw std::overflow_error if tan(x) does not fit in T
+    /// @return the first convergent of tan(x) within tolerance, or its best approximation with a denominator up to maxDenominator
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T,Norm,Overflow> tan(const Ratio<T,Norm,Overflow> &x, double tolerance, const typename Ratio<T,Norm,Overflow>::value_type &maxDenominator = std::numeric_limits<T>::max()) {
+        kernel::checkMathType<T>();
+        const auto [s, c] = kernel::fixedSinCos(kernel::toFixed(x.numerator(), x.denominator()));
+        if(c == 0) {throw std::overflow_error("rto : the result does not fit in the integer type");}
+        // d(s/c) = ds/c - s dc/c^2
+        const double cosine = std::abs(static_cast<double>(c) * 0x1p-60), tangent = std::abs(static_cast<double>(s) / static_cast<double>(c));
+        const double error = 2 * kernel::fixedError * (1 + tangent) / cosine;
+        return kernel::approximateFixed<Ratio<T,Norm,Overflow>>(s, c, kernel::remainingTolerance(tolerance, error), maxDenominator);
+    }
+
+    /// \brief exponential with a bounded error
+    /// \param x : the argument
+    /// \param tolerance : largest error allowed (down to 2^-54 exp(x))
+    /// \param maxDenominator : largest denominator of the result
+    /// \throw std::overflow_error if exp(x) does not fit in T
+    /// @return the first convergent of exp(x) within tolerance, or its best approximation with a denominator up to maxDenominator
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T,Norm,Overflow> exp(const Ratio<T,Norm,Overflow> &x, double tolerance, const typename Ratio<T,Norm,Overflow>::value_type &maxDenominator = std::numeric_limits<T>::max()) {
+        using R = Ratio<T,Norm,Overflow>;
+        kernel::checkMathType<T>();
+        const auto [mantissa, exponent] = kernel::fixedExp(kernel::toFixed(x.numerator(), x.denominator()));
+        if(exponent > std::numeric_limits<T>::digits) {throw std::overflow_error("rto : the result does not fit in the integer type");}
+        if(exponent < -2 * kernel::fixedBits - 64) {
+            // below 2^-180 : zero
+            return kernel::approximateFixed<R>(0, 1, 0.0, maxDenominator);
+        }
+        const double error = kernel::fixedError * std::ldexp(1.0, static_cast<int>(exponent) + 1);
+        // value = mantissa * 2^(exponent - fixedBits)
+        const int shift = kernel::fixedBits - static_cast<int>(exponent);
+        if(shift <= 0) {
+            return kernel::approximateFixed<R>(mantissa << -shift, 1, kernel::remainingTolerance(tolerance, error), maxDenominator);
+        }
+        if(shift > 126) {
+            // below 2^-65 : the mantissa keeps its leading bits over 2^126
+            return kernel::approximateFixed<R>(mantissa >> (shift - 126), kernel::fixed(1) << 126, kernel::remainingTolerance(tolerance, error), maxDenominator);
+        }
+        return kernel::approximateFixed<R>(mantissa, kernel::fixed(1) << shift, kernel::remainingTolerance(tolerance, error), maxDenominator);
+    }
+
+    /// \brief natural logarithm with a bounded error
+    /// \param x : the argument, positive
+    /// \param tolerance : largest error allowed (down to 2^-54)
+    /// \param maxDenominator : largest denominator of the result
+    /// \throw std::domain_error if x is not positive
+    /// @return the first convergent of log(x) within tolerance, or its best approximation with a denominator up to maxDenominator
+    template <typename T, typename Norm, typename Overflow>
+    Ratio<T,Norm,Overflow> log(const Ratio<T,Norm,Overflow> &x, double tolerance, const typename Ratio<T,Norm,Overflow>::value_type &maxDenominator = std::numeric_limits<T>::max()) {
+        kernel::checkMathType<T>();
+        T p = x.numerator(), q = x.denominator();
+        if(q < T(0)) {
+            p = -p;
+            q = -q;
+        }
+        if(p <= T(0)) {throw std::domain_error("rto : log of a ratio that is not positive");}
+        const double error = kernel::fixedError * 4;
+        return kernel::approximateFixed<Ratio<T,Norm,Overflow>>(kernel::fixedLog(p, q), kernel::fixedOne, kernel::remainingTolerance(tolerance, error), maxDenominator);
+    }
+}
+
+#endif
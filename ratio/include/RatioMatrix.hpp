@@ -0,0 +1,459 @@
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "Ratio.hpp"
+#include "RatioReduce.hpp"
+#include "RatioScale.hpp"
+
+#pragma once
+
+
+/// \class Matrix
+/// \brief dense matrix of ratios, row-major in a single contiguous buffer.
+/// The heavy operations do not work on the ratios themselves: each row (or column) is brought to
+/// a common denominator, the integer numerators are processed without any gcd, and the results
+/// are normalized once at the end.
+/// \li operator* : cache-blocked integer dot products (in the wider integer type when there is one)
+/// \li determinant, solve, inverse : fraction-free Bareiss elimination, every intermediate is a minor
+/// of the integer matrix, so its size stays bounded (use Ratio<BigInt> for large systems)
+/// The eliminations throw std::overflow_error when a minor does not fit in the integer type.
+/// \tparam R : the ratio type (Ratio<T,Norm,Overflow>)
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief run body(i) for every i in [begin, end), split in contiguous slices over several threads
+        /// (serial when work, the cost of the whole loop, is too small to pay for the threads)
+        /// \param threads : number of threads (0 for std::thread::hardware_concurrency())
+        template <typename Body>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t work, unsigned int threads, const Body &body) {
+            std::size_t workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+            workers = std::min(workers, end - begin);
+            if(workers <= 1 || work < (std::size_t(1) << 15)) {
+                for(std::size_t i=begin; i<end; ++i) {body(i);}
+                return;
+            }
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            const std::size_t slice = (end - begin + workers - 1) / workers;
+            const auto run = [&](std::size_t first) {
+                try {
+                    for(std::size_t i=first; i<std::min(end, first + slice); ++i) {body(i);}
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if(!error) {error = std::current_exception();}
+                }
+            };
+            std::vector<std::thread> pool;
+            pool.reserve(workers - 1);
+            for(std::size_t w=1; w<workers; ++w) {
+                pool.emplace_back(run, begin + w * slice);
+            }
+            run(begin);
+            for(std::thread &thread : pool) {
+                thread.join();
+            }
+            if(error) {std::rethrow_exception(error);}
+        }
+
+        /// \brief one Bareiss step on an entry : (a*p - c*d) / previous, the division is exact
+        /// @return false if the result does not fit in T
+        template <typename T>
+        bool bareissUpdate(const T &a, const T &p, const T &c, const T &d, const T &previous, T &result) {
+            using W = typename productOf<T>::type;
+            W ap{}, cd{}, difference{};
+            if(overflow::mulOverflows(W(a), W(p), ap) || overflow::mulOverflows(W(c), W(d), cd) || overflow::subOverflows(ap, cd, difference)) {
+                return false;
+            }
+            return narrowTo(W(difference / W(previous)), result);
+        }
+
+        /// \brief fraction-free Gauss elimination (Bareiss) of the first size columns of an integer matrix,
+        /// the rows below the pivots are updated in parallel
+        /// \param m : the matrix, row-major (size rows, cols columns), upper triangular on return
+        /// \param size : number of rows (and of eliminated columns)
+        /// \param cols : number of columns (cols >= size, the extra ones are right-hand sides)
+        /// \param threads : number of threads
+        /// @return the sign of the row permutation (the determinant is sign * m[size-1][size-1]), 0 if singular
+        template <typename T>
+        int bareiss(std::vector<T> &m, std::size_t size, std::size_t cols, unsigned int threads) {
+            T previous = T(1);
+            int sign = 1;
+            for(std::size_t k=0; k<size; ++k) {
+                if(m[k*cols+k] == T(0)) {
+                    std::size_t pivot = k+1;
+                    while(pivot < size && m[pivot*cols+k] == T(0)) {++pivot;}
+                    if(pivot == size) {return 0;}
+                    std::swap_ranges(m.begin() + k*cols, m.begin() + (k+1)*cols, m.begin() + pivot*cols);
+                    sign = -sign;
+                }
+                const T *row = &m[k*cols];
+                std::atomic<bool> overflows{false};
+                parallelFor(k+1, size, (size-k) * (cols-k), threads, [&](std::size_t i) {
+                    T *target = &m[i*cols];
+                    for(std::size_t j=k+1; j<cols; ++j) {
+                        if(!bareissUpdate(target[j], row[k], target[k], row[j], previous, target[j])) {
+                            overflows = true;
+                            return;
+                        }
+                    }
+                    target[k] = T(0);
+                });
+                if(overflows) {throw std::overflow_error("rto::Matrix : a minor does not fit in the integer type");}
+                previous = row[k];
+            }
+            return sign;
+        }
+    }
+
+
+    template <typename R>
+    class Matrix {
+
+    public :
+
+        using value_type = R;
+        using integer_type = typename R::value_type;
+
+        /// \brief defaultConstructor, empty matrix
+        /// @return a 0x0 matrix
+        Matrix() : m_rows(0), m_cols(0) {}
+
+        /// \brief constructor of a null matrix
+        /// \param rows : number of rows
+        /// \param cols : number of columns
+        /// @return a rows x cols matrix of (0/1)
+        Matrix(std::size_t rows, std::size_t cols) : m_rows(rows), m_cols(cols), m_data(rows * cols) {}
+
+        /// \brief constructor from a list of rows
+        /// \param rows : the rows, all of the same size
+        /// @return the matrix
+        Matrix(std::initializer_list<std::initializer_list<R>> rows) : m_rows(rows.size()), m_cols(rows.size() ? rows.begin()->size() : 0) {
+            m_data.reserve(m_rows * m_cols);
+            for(const std::initializer_list<R> &row : rows) {
+                assert(row.size() == m_cols && "rows should have the same size");
+                m_data.insert(m_data.end(), row.begin(), row.end());
+            }
+        }
+
+        /// \brief identity matrix
+        /// \param size : number of rows and columns
+        /// @return the matrix
+        static Matrix identity(std::size_t size) {
+            Matrix result(size, size);
+            for(std::size_t i=0; i<size; ++i) {
+                result(i, i) = R(integer_type(1), integer_type(1));
+            }
+            return result;
+        }
+
+        /// \brief get the number of rows
+        /// @return the number of rows
+        inline std::size_t rows() const {return m_rows;};
+
+        /// \brief get the number of columns
+        /// @return the number of columns
+        inline std::size_t cols() const {return m_cols;};
+
+        /// \brief get an element
+        /// \param i : the row
+        /// \param j : the column
+        /// @return the ratio
+        inline R& operator()(std::size_t i, std::size_t j) {return m_data[i * m_cols + j];};
+
+        /// \brief get an element
+        /// \param i : the row
+        /// \param j : the column
+        /// @return the ratio
+        inline const R& operator()(std::size_t i, std::size_t j) const {return m_data[i * m_cols + j];};
+
+        /// \brief get the buffer
+        /// @return pointer to the contiguous elements (row-major)
+        inline const R* data() const {return m_data.data();};
+
+        /// \brief operator +
+        /// \param mat : a matrix of the same size
+        /// @return the sum
+        Matrix operator+(const Matrix &mat) const {
+            assert(m_rows == mat.m_rows && m_cols == mat.m_cols && "matrices should have the same size");
+            Matrix result(m_rows, m_cols);
+            for(std::size_t i=0; i<m_data.size(); ++i) {
+                result.m_data[i] = m_data[i] + mat.m_data[i];
+            }
+            return result;
+        }
+
+        /// \brief operator -
+        /// \param mat : a matrix of the same size
+        /// @return the difference
+        Matrix operator-(const Matrix &mat) const {
+            assert(m_rows == mat.m_rows && m_cols == mat.m_cols && "matrices should have the same size");
+            Matrix result(m_rows, m_cols);
+            for(std::size_t i=0; i<m_data.size(); ++i) {
+                result.m_data[i] = m_data[i] - mat.m_data[i];
+            }
+            return result;
+        }
+
+        /// \brief operator * (multiply on every core)
+        /// \param mat : a matrix with as many rows as this one has columns
+        /// @return the product
+        Matrix operator*(const Matrix &mat) const {
+            return multiply(mat);
+        }
+
+        /// \brief product : the rows of this matrix and the columns of mat are brought to integers over
+        /// their common denominator, the integer dot products are computed by cache blocks and each
+        /// result is normalized once. Falls back to ratio arithmetic when the integers do not fit.
+        /// \param mat : a matrix with as many rows as this one has columns
+        /// \param threads : number of threads (0 for std::thread::hardware_concurrency())
+        /// @return the product
+        Matrix multiply(const Matrix &mat, unsigned int threads = 0) const {
+            assert(m_cols == mat.m_rows && "invalid matrix sizes for a product");
+            Matrix result(m_rows, mat.m_cols);
+            if(!multiplyIntegers(mat, result, threads)) {
+                multiplyRatios(mat, result, threads);
+            }
+            return result;
+        }
+
+        /// \brief operator ==
+        /// \param mat : a matrix
+        /// @return true if both matrices have the same size and the same values
+        bool operator==(const Matrix &mat) const {
+            return m_rows == mat.m_rows && m_cols == mat.m_cols && m_data == mat.m_data;
+        }
+
+        /// \brief operator !=
+        /// \param mat : a matrix
+        /// @return true if the matrices differ
+        bool operator!=(const Matrix &mat) const {return !(*this == mat);}
+
+        /// \brief transposed matrix
+        /// @return the transpose
+        Matrix transpose() const {
+            Matrix result(m_cols, m_rows);
+            for(std::size_t i=0; i<m_rows; ++i) {
+                for(std::size_t j=0; j<m_cols; ++j) {
+                    result(j, i) = (*this)(i, j);
+                }
+            }
+            return result;
+        }
+
+        /// \brief determinant, by Bareiss elimination of the rows brought to integers
+        /// \param threads : number of threads (0 for std::thread::hardware_concurrency())
+        /// \throw std::overflow_error if a minor does not fit in the integer type
+        /// @return the determinant
+        R determinant(unsigned int threads = 0) const {
+            assert(m_rows == m_cols && "the determinant needs a square matrix");
+            std::vector<integer_type> m(m_rows * m_rows), scales(m_rows);
+            toIntegers(m, m_rows, scales);
+            if(m_rows == 0) {return R(integer_type(1), integer_type(1));}
+            const int sign = kernel::bareiss(m, m_rows, m_rows, threads);
+            if(sign == 0) {return R();}
+            const integer_type last = m[m_rows * m_rows - 1];
+            R det(sign < 0 ? integer_type(-last) : last, integer_type(1));
+            for(const integer_type &scale : scales) {
+                det = det / R(scale, integer_type(1));
+            }
+            return det;
+        }
+
+        /// \brief solution X of this * X = rhs, by Bareiss elimination of [this | rhs] and a fraction-free
+        /// back substitution (the numerators of X over the determinant are integers, Cramer's rule)
+        /// \param rhs : the right-hand sides, one per column
+        /// \param threads : number of threads (0 for std::thread::hardware_concurrency())
+        /// \throw std::domain_error if the matrix is singular, std::overflow_error if a minor does not fit
+        /// @return the solution
+        Matrix solve(const Matrix &rhs, unsigned int threads = 0) const {
+            assert(m_rows == m_cols && rhs.m_rows == m_rows && "solve needs a square matrix and as many right-hand sides rows");
+            using T = integer_type;
+            using W = typename kernel::productOf<T>::type;
+            const std::size_t n = m_rows, cols = m_rows + rhs.m_cols;
+            std::vector<T> m(n * cols), scales(n), columnScales(rhs.m_cols), column(n);
+            toIntegers(m, cols, scales);
+            // each right-hand side, multiplied by the row scales, is brought to integers over its own
+            // common denominator (scaling the rows by it would multiply the determinant)
+            std::vector<R> scaled(n);
+            for(std::size_t c=0; c<rhs.m_cols; ++c) {
+                for(std::size_t i=0; i<n; ++i) {
+                    scaled[i] = rhs(i, c) * R(scales[i], T(1));
+                }
+                T scale(1);
+                if(!kernel::commonDenominator(scaled.data(), n, scale) || !kernel::scaleNumerators(scaled.data(), n, scale, column.data())) {
+                    throw std::overflow_error("rto::Matrix : the common denominator of a column does not fit in the integer type");
+                }
+                for(std::size_t i=0; i<n; ++i) {
+                    m[i * cols + n + c] = column[i];
+                }
+                columnScales[c] = scale;
+            }
+            if(n != 0 && kernel::bareiss(m, n, cols, threads) == 0) {
+                throw std::domain_error("rto::Matrix : singular matrix");
+            }
+
+            Matrix result(n, rhs.m_cols);
+            if(n == 0) {return result;}
+            const T det = m[(n - 1) * cols + n - 1];
+            std::atomic<bool> overflows{false};
+            kernel::parallelFor(0, rhs.m_cols, n * n * rhs.m_cols, threads, [&](std::size_t c) {
+                std::vector<T> y(n);
+                for(std::size_t i=n; i-->0;) {
+                    W sum{}, product{};
+                    bool failed = overflow::mulOverflows(W(det), W(m[i*cols + n + c]), sum);
+                    for(std::size_t j=i+1; j<n && !failed; ++j) {
+                        failed = overflow::mulOverflows(W(m[i*cols + j]), W(y[j]), product) || overflow::subOverflows(sum, product, sum);
+                    }
+                    if(failed || !kernel::narrowTo(W(sum / W(m[i*cols + i])), y[i])) {
+                        overflows = true;
+                        return;
+                    }
+                }
+                for(std::size_t i=0; i<n; ++i) {
+                    result(i, c) = R(y[i], det) * R(T(1), columnScales[c]);
+                }
+            });
+            if(overflows) {throw std::overflow_error("rto::Matrix : a minor does not fit in the integer type");}
+            return result;
+        }
+
+        /// \brief inverse matrix (solve with the identity)
+        /// \param threads : number of threads (0 for std::thread::hardware_concurrency())
+        /// \throw std::domain_error if the matrix is singular, std::overflow_error if a minor does not fit
+        /// @return the inverse
+        Matrix inverse(unsigned int threads = 0) const {
+            return solve(identity(m_rows), threads);
+        }
+
+        /// \brief overload the operator << for Matrix, one row per line
+        /// \param stream : input stream
+        /// \param mat : the matrix to output
+        /// \return the output stream containing the matrix
+        friend std::ostream& operator<<(std::ostream &stream, const Matrix &mat) {
+            for(std::size_t i=0; i<mat.m_rows; ++i) {
+                for(std::size_t j=0; j<mat.m_cols; ++j) {
+                    stream << (j ? " " : "") << mat(i, j);
+                }
+                stream << "\n";
+            }
+            return stream;
+        }
+
+    private :
+
+        std::size_t m_rows;
+        std::size_t m_cols;
+        std::vector<R> m_data;
+
+        /// \brief size of the square tiles of the product, and of the slices of the dot products
+        static constexpr std::size_t tileSize = 32;
+        static constexpr std::size_t sliceSize = 256;
+
+        /// \brief rows brought to integers over their common denominator
+        /// \param m : receives the integer rows (the first m_cols columns of each row)
+        /// \param stride : number of columns of m
+        /// \param scales : receives the common denominator of each row
+        void toIntegers(std::vector<integer_type> &m, std::size_t stride, std::vector<integer_type> &scales) const {
+            for(std::size_t i=0; i<m_rows; ++i) {
+                integer_type scale(1);
+                if(!kernel::commonDenominator(&m_data[i * m_cols], m_cols, scale) || !kernel::scaleNumerators(&m_data[i * m_cols], m_cols, scale, &m[i * stride])) {
+                    throw std::overflow_error("rto::Matrix : the common denominator of a row does not fit in the integer type");
+                }
+                scales[i] = scale;
+            }
+        }
+
+        /// \brief integer product, by tiles of tileSize x tileSize results and slices of sliceSize terms
+        /// @return false if an integer does not fit (result is then left unspecified)
+        bool multiplyIntegers(const Matrix &mat, Matrix &result, unsigned int threads) const {
+            using T = integer_type;
+            using W = typename kernel::productOf<T>::type;
+            const std::size_t inner = m_cols;
+            std::vector<T> left(m_rows * inner), leftScales(m_rows), right(mat.m_cols * inner), rightScales(mat.m_cols);
+            const Matrix transposed = mat.transpose();
+            for(std::size_t i=0; i<m_rows; ++i) {
+                T scale(1);
+                if(!kernel::commonDenominator(&m_data[i * inner], inner, scale) || !kernel::scaleNumerators(&m_data[i * inner], inner, scale, &left[i * inner])) {return false;}
+                leftScales[i] = scale;
+            }
+            for(std::size_t j=0; j<mat.m_cols; ++j) {
+                T scale(1);
+                if(!kernel::commonDenominator(&transposed.m_data[j * inner], inner, scale) || !kernel::scaleNumerators(&transposed.m_data[j * inner], inner, scale, &right[j * inner])) {return false;}
+                rightScales[j] = scale;
+            }
+
+            std::atomic<bool> overflows{false};
+            const std::size_t tileRows = (m_rows + tileSize - 1) / tileSize;
+            kernel::parallelFor(0, tileRows, m_rows * mat.m_cols * inner, threads, [&](std::size_t tile) {
+                const std::size_t iEnd = std::min(m_rows, (tile + 1) * tileSize);
+                std::vector<W> sums(tileSize * tileSize);
+                for(std::size_t jj=0; jj<mat.m_cols && !overflows; jj+=tileSize) {
+                    const std::size_t jEnd = std::min(mat.m_cols, jj + tileSize);
+                    std::fill(sums.begin(), sums.end(), W(0));
+                    for(std::size_t kk=0; kk<inner; kk+=sliceSize) {
+                        const std::size_t kEnd = std::min(inner, kk + sliceSize);
+                        for(std::size_t i=tile*tileSize; i<iEnd; ++i) {
+                            const T *a = &left[i * inner];
+                            for(std::size_t j=jj; j<jEnd; ++j) {
+                                const T *b = &right[j * inner];
+                                W sum = sums[(i - tile*tileSize) * tileSize + (j - jj)];
+                                bool failed = false;
+                                for(std::size_t k=kk; k<kEnd; ++k) {
+                                    W product{};
+                                    failed |= overflow::mulOverflows(W(a[k]), W(b[k]), product);
+                                    failed |= overflow::addOverflows(sum, product, sum);
+                                }
+                                if(failed) {
+                                    overflows = true;
+                                    return;
+                                }
+                                sums[(i - tile*tileSize) * tileSize + (j - jj)] = sum;
+                            }
+                        }
+                    }
+                    for(std::size_t i=tile*tileSize; i<iEnd; ++i) {
+                        for(std::size_t j=jj; j<jEnd; ++j) {
+                            T sum{};
+                            if(!kernel::narrowTo(sums[(i - tile*tileSize) * tileSize + (j - jj)], sum)) {
+                                overflows = true;
+                                return;
+                            }
+                            result(i, j) = R(sum, leftScales[i]) * R(T(1), rightScales[j]);
+                        }
+                    }
+                }
+            });
+            return !overflows;
+        }
+
+        /// \brief product with ratio arithmetic, each result accumulated on a running common denominator
+        void multiplyRatios(const Matrix &mat, Matrix &result, unsigned int threads) const {
+            kernel::parallelFor(0, m_rows, m_rows * mat.m_cols * m_cols, threads, [&](std::size_t i) {
+                std::vector<kernel::SumAccumulator<R>> sums(mat.m_cols);
+                for(std::size_t k=0; k<m_cols; ++k) {
+                    const R &a = (*this)(i, k);
+                    if(a.numerator() == integer_type(0)) {continue;}
+                    for(std::size_t j=0; j<mat.m_cols; ++j) {
+                        const R product = a * mat(k, j);
+                        sums[j].add(product.numerator(), product.denominator());
+                    }
+                }
+                for(std::size_t j=0; j<mat.m_cols; ++j) {
+                    result(i, j) = sums[j].result();
+                }
+            });
+        }
+    };
+}
@@ -0,0 +1,305 @@
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "Ratio.hpp"
+#include "RatioArray.hpp"
+
+#pragma once
+
+
+/// \class PackedRatioVector
+/// \brief compact storage of ratios for large in-memory datasets : every element takes
+/// numeratorBits() + denominatorBits() bits of a single bit stream, the smallest widths that fit every
+/// value stored so far (a dataset of fractions with numerators below 2^19 and denominators up to 4096
+/// takes 20 + 12 = 32 bits per ratio instead of 64 for Ratio<int>, 128 for Ratio<long long>).
+/// \li the numerator is stored zigzag encoded (0, -1, 1, -2... as 0, 1, 2, 3...), the denominator minus one
+/// \li a value wider than the current widths repacks the whole vector (at most 2 x digits of T times)
+/// \li elements are read by value : operator[], the iterators and unpack() rebuild a Ratio<T> without gcd
+/// Ratios are stored in canonical form (irreducible, positive denominator).
+/// \tparam T : integer type of the numerator and the denominator
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief read width bits (1 to 64) at a bit position of a stream (followed by one padding word)
+        inline std::uint64_t readBits(const std::uint64_t *words, std::size_t position, int width) {
+            const std::size_t word = position >> 6;
+            const int shift = static_cast<int>(position & 63);
+            // the second shift is split in two so that it stays below 64 when shift is 0
+            const std::uint64_t value = (words[word] >> shift) | ((words[word + 1] << 1) << (63 - shift));
+            return width == 64 ? value : value & ((std::uint64_t(1) << width) - 1);
+        }
+
+        /// \brief write the width low bits of value (1 to 64, the other bits null) at a bit position
+        inline void writeBits(std::uint64_t *words, std::size_t position, int width, std::uint64_t value) {
+            const std::size_t word = position >> 6;
+            const int shift = static_cast<int>(position & 63);
+            const std::uint64_t mask = width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+            words[word] = (words[word] & ~(mask << shift)) | (value << shift);
+            if(shift + width > 64) {
+                words[word + 1] = (words[word + 1] & ~(mask >> (64 - shift))) | (value >> (64 - shift));
+            }
+        }
+    }
+
+    template <typename T = int>
+    class PackedRatioVector {
+
+        static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(std::uint64_t), "Invalid type; should be an integer of at most 64 bits");
+
+        using U = std::make_unsigned_t<T>;
+
+    public :
+
+        using value_type = Ratio<T>;
+        using size_type = std::size_t;
+
+        /// \class const_iterator
+        /// \brief random access iterator unpacking the ratios (dereferences to a value, not a reference)
+        class const_iterator {
+        public :
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Ratio<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Ratio<T>;
+
+            const_iterator() = default;
+            const_iterator(const PackedRatioVector *vector, std::size_t index)
+                : m_words(vector->m_words.data()), m_index(index), m_numeratorBits(vector->m_numeratorBits), m_denominatorBits(vector->m_denominatorBits),
+                  m_position(index * static_cast<std::size_t>(m_numeratorBits + m_denominatorBits)) {}
+
+            Ratio<T> operator*() const {return load(m_words, m_position, m_numeratorBits, m_denominatorBits);}
+            Ratio<T> operator[](difference_type n) const {return *(*this + n);}
+
+            const_iterator & operator++() {return *this += 1;}
+            const_iterator & operator--() {return *this -= 1;}
+            const_iterator operator++(int) {const_iterator it = *this; *this += 1; return it;}
+            const_iterator operator--(int) {const_iterator it = *this; *this -= 1; return it;}
+            const_iterator & operator+=(difference_type n) {
+                m_index += n;
+                m_position += n * static_cast<difference_type>(m_numeratorBits + m_denominatorBits);
+                return *this;
+            }
+            const_iterator & operator-=(difference_type n) {return *this += -n;}
+
+            friend const_iterator operator+(const_iterator it, difference_type n) {return it += n;}
+            friend const_iterator operator+(difference_type n, const_iterator it) {return it += n;}
+            friend const_iterator operator-(const_iterator it, difference_type n) {return it -= n;}
+            friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+                return static_cast<difference_type>(a.m_index) - static_cast<difference_type>(b.m_index);
+            }
+
+            friend bool operator==(const const_iterator &a, const const_iterator &b) {return a.m_index == b.m_index;}
+            friend bool operator!=(const const_iterator &a, const const_iterator &b) {return a.m_index != b.m_index;}
+            friend bool operator<(const const_iterator &a, const const_iterator &b) {return a.m_index < b.m_index;}
+            friend bool operator>(const const_iterator &a, const const_iterator &b) {return a.m_index > b.m_index;}
+            friend bool operator<=(const const_iterator &a, const const_iterator &b) {return a.m_index <= b.m_index;}
+            friend bool operator>=(const const_iterator &a, const const_iterator &b) {return a.m_index >= b.m_index;}
+
+        private :
+            // the stream and the widths are copied, so that the loops keep them in registers
+            const std::uint64_t *m_words = nullptr;
+            std::size_t m_index = 0;
+            int m_numeratorBits = 1;
+            int m_denominatorBits = 1;
+            std::size_t m_position = 0;
+        };
+
+        /// \brief defaultConstructor, empty vector
+        PackedRatioVector() : m_words(1, 0) {}
+
+        /// \brief constructor from ratios : the widths are computed by a first pass, so that nothing is repacked
+        /// \param first, last : forward iterators on Ratio<T,Norm,Overflow>
+        template <typename Iterator>
+        PackedRatioVector(Iterator first, Iterator last) : PackedRatioVector() {
+            std::uint64_t numerators = 0, denominators = 0;
+            std::size_t size = 0;
+            for(Iterator it = first; it != last; ++it, ++size) {
+                std::uint64_t numerator = 0, denominator = 0;
+                encode(*it, numerator, denominator);
+                numerators |= numerator;
+                denominators |= denominator;
+            }
+            m_numeratorBits = std::max(1, kernel::bitWidth(numerators));
+            m_denominatorBits = std::max(1, kernel::bitWidth(denominators));
+            m_size = size;
+            m_words.assign(wordsFor(m_size), 0);
+            for(std::size_t i=0; first != last; ++first, ++i) {
+                std::uint64_t numerator = 0, denominator = 0;
+                encode(*first, numerator, denominator);
+                store(i, numerator, denominator);
+            }
+        }
+
+        /// \brief constructor from an array of structures
+        template <typename Norm, typename Overflow>
+        explicit PackedRatioVector(const std::vector<Ratio<T,Norm,Overflow>> &ratios) : PackedRatioVector(ratios.begin(), ratios.end()) {}
+
+        /// \brief constructor from a RatioArray
+        explicit PackedRatioVector(const RatioArray<T> &ratios) : PackedRatioVector() {
+            std::vector<Ratio<T>> values(ratios.size());
+            for(std::size_t i=0; i<ratios.size(); ++i) {values[i] = ratios[i];}
+            *this = PackedRatioVector(values.begin(), values.end());
+        }
+
+        /// \brief add a ratio at the end (repacks the vector if it needs wider fields)
+        /// \param rat : the ratio
+        template <typename Norm, typename Overflow>
+        void push_back(const Ratio<T,Norm,Overflow> &rat) {
+            std::uint64_t numerator = 0, denominator = 0;
+            encode(rat, numerator, denominator);
+            widen(kernel::bitWidth(numerator), kernel::bitWidth(denominator));
+            m_words.resize(wordsFor(m_size + 1), 0);
+            store(m_size, numerator, denominator);
+            ++m_size;
+        }
+
+        /// \brief replace a ratio (repacks the vector if it needs wider fields)
+        /// \param index : position, below size()
+        /// \param rat : the ratio
+        template <typename Norm, typename Overflow>
+        void set(std::size_t index, const Ratio<T,Norm,Overflow> &rat) {
+            assert(index < m_size && "Index out of range");
+            std::uint64_t numerator = 0, denominator = 0;
+            encode(rat, numerator, denominator);
+            widen(kernel::bitWidth(numerator), kernel::bitWidth(denominator));
+            store(index, numerator, denominator);
+        }
+
+        /// \brief the ratio at a position
+        /// \param index : position, below size()
+        /// @return the irreducible ratio, with a positive denominator
+        Ratio<T> operator[](std::size_t index) const {
+            assert(index < m_size && "Index out of range");
+            return load(m_words.data(), index * static_cast<std::size_t>(m_numeratorBits + m_denominatorBits), m_numeratorBits, m_denominatorBits);
+        }
+
+        /// \brief unpack every ratio
+        /// \param result : size() ratios
+        void unpack(Ratio<T> *result) const {
+            const std::uint64_t *words = m_words.data();
+            const int numeratorBits = m_numeratorBits, denominatorBits = m_denominatorBits;
+            const std::size_t bits = static_cast<std::size_t>(numeratorBits + denominatorBits);
+            std::size_t position = 0;
+            for(std::size_t i=0; i<m_size; ++i, position += bits) {result[i] = load(words, position, numeratorBits, denominatorBits);}
+        }
+
+        /// \brief unpack every ratio
+        /// @return the ratios, as an array of structures
+        std::vector<Ratio<T>> unpack() const {
+            std::vector<Ratio<T>> result(m_size);
+            unpack(result.data());
+            return result;
+        }
+
+        const_iterator begin() const {return const_iterator(this, 0);}
+        const_iterator end() const {return const_iterator(this, m_size);}
+
+        /// \brief number of ratios
+        std::size_t size() const {return m_size;}
+        bool empty() const {return m_size == 0;}
+
+        /// \brief make room for capacity ratios at the current widths
+        void reserve(std::size_t capacity) {m_words.reserve(wordsFor(capacity));}
+
+        /// \brief remove every ratio, the widths go back to 1 bit
+        void clear() {
+            m_words.assign(1, 0);
+            m_size = 0;
+            m_numeratorBits = 1;
+            m_denominatorBits = 1;
+        }
+
+        /// \brief bits of the zigzag encoded numerators
+        int numeratorBits() const {return m_numeratorBits;}
+
+        /// \brief bits of the denominators minus one
+        int denominatorBits() const {return m_denominatorBits;}
+
+        /// \brief memory used by the bit stream
+        /// @return the size in bytes
+        std::size_t memoryBytes() const {return m_words.size() * sizeof(std::uint64_t);}
+
+    private :
+
+        std::vector<std::uint64_t> m_words;
+        std::size_t m_size = 0;
+        int m_numeratorBits = 1;
+        int m_denominatorBits = 1;
+
+        /// \brief number of words of size ratios, plus one padding word read by kernel::readBits
+        std::size_t wordsFor(std::size_t size) const {
+            return (size * static_cast<std::size_t>(m_numeratorBits + m_denominatorBits) + 63) / 64 + 1;
+        }
+
+        /// \brief canonical form, then zigzag numerator and denominator minus one
+        template <typename Norm, typename Overflow>
+        static void encode(const Ratio<T,Norm,Overflow> &rat, std::uint64_t &numerator, std::uint64_t &denominator) {
+            T num = rat.numerator(), den = rat.denominator();
+            if constexpr (!std::is_same_v<Norm, Eager>) {
+                const Ratio<T> reduced(num, den);
+                num = reduced.numerator();
+                den = reduced.denominator();
+            }
+            if constexpr (std::is_signed_v<T>) {
+                if(den < T(0)) {
+                    num = Wrap::sub(T(0), num);
+                    den = Wrap::sub(T(0), den);
+                }
+                numerator = static_cast<U>((static_cast<U>(num) << 1) ^ static_cast<U>(num < T(0) ? ~U(0) : U(0)));
+            } else {
+                numerator = num;
+            }
+            denominator = static_cast<U>(static_cast<U>(den) - U(1));
+        }
+
+        /// \brief ratio of a zigzag numerator and a denominator minus one (canonical : no gcd)
+        static Ratio<T> decode(std::uint64_t numerator, std::uint64_t denominator) {
+            Ratio<T> rat;
+            if constexpr (std::is_signed_v<T>) {
+                const U zigzag = static_cast<U>(numerator);
+                rat.numerator() = static_cast<T>(static_cast<U>(zigzag >> 1) ^ static_cast<U>(U(0) - (zigzag & U(1))));
+            } else {
+                rat.numerator() = static_cast<T>(numerator);
+            }
+            rat.denominator() = static_cast<T>(static_cast<U>(denominator) + U(1));
+            return rat;
+        }
+
+        /// \brief read the element at a bit position
+        static Ratio<T> load(const std::uint64_t *words, std::size_t position, int numeratorBits, int denominatorBits) {
+            return decode(kernel::readBits(words, position, numeratorBits), kernel::readBits(words, position + numeratorBits, denominatorBits));
+        }
+
+        /// \brief write an element at the current widths
+        void store(std::size_t index, std::uint64_t numerator, std::uint64_t denominator) {
+            const std::size_t position = index * static_cast<std::size_t>(m_numeratorBits + m_denominatorBits);
+            kernel::writeBits(m_words.data(), position, m_numeratorBits, numerator);
+            kernel::writeBits(m_words.data(), position + m_numeratorBits, m_denominatorBits, denominator);
+        }
+
+        /// \brief repack every element if a field needs more bits
+        void widen(int numeratorWidth, int denominatorWidth) {
+            if(numeratorWidth <= m_numeratorBits && denominatorWidth <= m_denominatorBits) {return;}
+            PackedRatioVector packed;
+            packed.m_numeratorBits = std::max(m_numeratorBits, numeratorWidth);
+            packed.m_denominatorBits = std::max(m_denominatorBits, denominatorWidth);
+            packed.m_size = m_size;
+            packed.m_words.assign(packed.wordsFor(m_size), 0);
+            const int bits = m_numeratorBits + m_denominatorBits;
+            std::size_t position = 0;
+            for(std::size_t i=0; i<m_size; ++i, position += bits) {
+                packed.store(i, kernel::readBits(m_words.data(), position, m_numeratorBits),
+                                kernel::readBits(m_words.data(), position + m_numeratorBits, m_denominatorBits));
+            }
+            *this = std::move(packed);
+        }
+    };
+}
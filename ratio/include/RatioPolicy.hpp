@@ -0,0 +1,407 @@
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#pragma once
+
+
+/// \file RatioPolicy.hpp
+/// \brief policies selecting how a Ratio behaves, given as template parameters of Ratio.
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief true while the compiler evaluates a constant expression, so that a constexpr function
+        /// can call a faster run-time only version otherwise. Without a way to tell, always true:
+        /// the callers then keep to their constexpr code
+        constexpr bool constantEvaluated() {
+        #if defined(__cpp_lib_is_constant_evaluated)
+            return std::is_constant_evaluated();
+        #elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+            return __builtin_is_constant_evaluated();
+        #else
+            return true;
+        #endif
+        }
+    }
+
+    // normalization policies : when irreducible() runs after an operation
+
+    /// \brief normalize after every operation (default); every ratio is kept irreducible,
+    /// which lets the operators cross-cancel their operands instead of reducing the result
+    struct Eager {};
+
+    /// \brief skip the normalization in the operators as long as the result stays small;
+    /// the ratio is only reduced once its numerator or denominator reaches half of the bits of T
+    /// (so that the next operation can not overflow). Meant for long accumulation loops,
+    /// call irreducible() at the end.
+    struct Deferred {
+        /// \brief check if a raw result should be reduced
+        /// \param num : the numerator
+        /// \param den : the denominator
+        /// @return true if num or den is too large to be used again in a product
+        template <typename T>
+        static constexpr bool needsNormalization(const T &num, const T &den) {
+            if constexpr (!std::numeric_limits<T>::is_bounded) {
+                // unbounded integers (BigInt) never overflow, but their cost grows with their size
+                return true;
+            } else {
+                constexpr T limit = T(1) << (std::numeric_limits<T>::digits / 2 - 1);
+                if constexpr (std::is_signed_v<T>) {
+                    return num >= limit || num <= -limit || den >= limit || den <= -limit;
+                } else {
+                    return num >= limit || den >= limit;
+                }
+            }
+        }
+    };
+
+    /// \brief operators build expression nodes (see RatioExpression.hpp): the whole expression
+    /// is computed on a common denominator and normalized once, when assigned to a Ratio
+    struct Fused {};
+
+    namespace overflow {
+
+    #if defined(__SIZEOF_INT128__)
+        __extension__ typedef __int128 int128;
+        __extension__ typedef unsigned __int128 uint128;
+    #endif
+
+        /// \brief integer type with twice the bits of T
+        template <typename T, std::size_t Size = sizeof(T)> struct wider {};
+        template <typename T> struct wider<T,1> {using type = std::conditional_t<std::is_signed_v<T>, std::int16_t, std::uint16_t>;};
+        template <typename T> struct wider<T,2> {using type = std::conditional_t<std::is_signed_v<T>, std::int32_t, std::uint32_t>;};
+        template <typename T> struct wider<T,4> {using type = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;};
+    #if defined(__SIZEOF_INT128__)
+        template <typename T> struct wider<T,8> {using type = std::conditional_t<std::is_signed_v<T>, int128, uint128>;};
+    #endif
+
+        /// \brief true if wider<T> is defined: products of two T then never overflow
+        template <typename T>
+        constexpr bool hasWider() {
+        #if defined(__SIZEOF_INT128__)
+            return std::is_integral_v<T> && sizeof(T) <= 8;
+        #else
+            return std::is_integral_v<T> && sizeof(T) <= 4;
+        #endif
+        }
+
+        /// \brief check if a wide value can be stored in T
+        /// \param value : the wide value
+        /// @return true if T can hold value
+        template <typename T, typename W>
+        constexpr bool fits(const W &value) {
+            return value >= static_cast<W>(std::numeric_limits<T>::min()) && value <= static_cast<W>(std::numeric_limits<T>::max());
+        }
+
+        /// \brief Euclid gcd working on any integer type (including 128-bit ones)
+        /// \param a : first integer
+        /// \param b : second integer
+        /// @return the (positive) gcd
+        template <typename W>
+        constexpr W gcd(W a, W b) {
+            if(a < W(0)) {a = -a;}
+            if(b < W(0)) {b = -b;}
+            while(b != W(0)) {
+                W r = a % b;
+                a = b;
+                b = r;
+            }
+            return a;
+        }
+
+        /// \brief unsigned type in which the operations on T wrap around : at least unsigned int,
+        /// since unsigned short or unsigned char operands would be promoted to (signed) int
+        template <typename T>
+        using wrapping = std::common_type_t<std::make_unsigned_t<T>, unsigned int>;
+
+        /// \brief check if a*b overflows T (portable version of __builtin_mul_overflow)
+        template <typename T>
+        constexpr bool mulOverflows(const T &a, const T &b, T &result) {
+            if constexpr (!std::numeric_limits<T>::is_bounded) {
+                result = a * b;
+                return false;
+            } else {
+            #if defined(__GNUC__) || defined(__clang__)
+                // copies : gcc 12 misreports signed overflows when result aliases an operand
+                const T x = a, y = b;
+                return __builtin_mul_overflow(x, y, &result);
+            #else
+                constexpr T max = std::numeric_limits<T>::max();
+                constexpr T min = std::numeric_limits<T>::min();
+                bool overflow = false;
+                if(a > T(0)) {
+                    overflow = b > T(0) ? a > max / b : b < min / a;
+                } else if(a < T(0)) {
+                    overflow = b > T(0) ? a < min / b : (b != T(0) && b < max / a);
+                }
+                if(!overflow) {result = a * b;}
+                return overflow;
+            #endif
+            }
+        }
+
+        /// \brief check if a+b overflows T (portable version of __builtin_add_overflow)
+        template <typename T>
+        constexpr bool addOverflows(const T &a, const T &b, T &result) {
+            if constexpr (!std::numeric_limits<T>::is_bounded) {
+                result = a + b;
+                return false;
+            } else {
+            #if defined(__GNUC__) || defined(__clang__)
+                const T x = a, y = b;
+                return __builtin_add_overflow(x, y, &result);
+            #else
+                const bool overflow = b > T(0) ? a > std::numeric_limits<T>::max() - b : a < std::numeric_limits<T>::min() - b;
+                if(!overflow) {result = a + b;}
+                return overflow;
+            #endif
+            }
+        }
+
+        /// \brief check if a-b overflows T (portable version of __builtin_sub_overflow)
+        template <typename T>
+        constexpr bool subOverflows(const T &a, const T &b, T &result) {
+            if constexpr (!std::numeric_limits<T>::is_bounded) {
+                result = a - b;
+                return false;
+            } else {
+            #if defined(__GNUC__) || defined(__clang__)
+                const T x = a, y = b;
+                return __builtin_sub_overflow(x, y, &result);
+            #else
+                const bool overflow = b < T(0) ? a > std::numeric_limits<T>::max() + b : a < std::numeric_limits<T>::min() + b;
+                if(!overflow) {result = a - b;}
+                return overflow;
+            #endif
+            }
+        }
+
+        /// \brief check if base^exponent overflows T (square-and-multiply, O(log exponent) products)
+        /// \param base : the integer
+        /// \param exponent : a non-negative exponent
+        /// \param result : receives the power, modulo 2^bits if it overflows
+        /// @return true if the power does not fit in T
+        template <typename T, typename E>
+        constexpr bool powOverflows(const T &base, E exponent, T &result) {
+            if constexpr (!std::numeric_limits<T>::is_bounded) {
+                T power = T(1), square = base;
+                for(; exponent != E(0); exponent >>= 1) {
+                    if(exponent & E(1)) {power *= square;}
+                    if(exponent > E(1)) {square *= square;}
+                }
+                result = power;
+                return false;
+            } else {
+                // wrapped power in unsigned arithmetic
+                using U = wrapping<T>;
+                U power = U(1), square = static_cast<U>(base);
+                T exact = T(1), exactSquare = base;
+                bool overflow = false;
+                for(; exponent != E(0); exponent >>= 1) {
+                    if(exponent & E(1)) {
+                        power *= square;
+                        overflow = mulOverflows(exact, exactSquare, exact) || overflow;
+                    }
+                    // a square is only computed when it is used afterwards: its overflow is the power's
+                    if(exponent > E(1)) {
+                        square *= square;
+                        overflow = mulOverflows(exactSquare, exactSquare, exactSquare) || overflow;
+                    }
+                }
+                result = static_cast<T>(power);
+                return overflow;
+            }
+        }
+    }
+
+    // overflow policies : what the operators do when a result does not fit in T
+    // (they apply to the Eager and Deferred operators and to the nodes of the Fused expressions)
+
+    /// \brief silently wrap around (modulo 2^bits, previous behaviour and fastest)
+    struct Wrap {
+        template <typename T> using wide_type = T;
+
+        template <typename T>
+        static constexpr T mul(const T &a, const T &b) {
+            if constexpr (std::numeric_limits<T>::is_bounded) {
+                using U = overflow::wrapping<T>;
+                return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+            } else {
+                return a * b;
+            }
+        }
+
+        template <typename T>
+        static constexpr T add(const T &a, const T &b) {
+            if constexpr (std::numeric_limits<T>::is_bounded) {
+                using U = overflow::wrapping<T>;
+                return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+            } else {
+                return a + b;
+            }
+        }
+
+        template <typename T>
+        static constexpr T sub(const T &a, const T &b) {
+            if constexpr (std::numeric_limits<T>::is_bounded) {
+                using U = overflow::wrapping<T>;
+                return static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+            } else {
+                return a - b;
+            }
+        }
+
+        template <typename T>
+        static constexpr void narrow(const T &num, const T &den, T &numerator, T &denominator) {
+            numerator = num;
+            denominator = den;
+        }
+    };
+
+    /// \brief throw std::overflow_error as soon as an intermediate overflows
+    /// (checked with __builtin_*_overflow, a single flag test on the fast path)
+    struct Checked {
+        template <typename T> using wide_type = T;
+
+        template <typename T>
+        static constexpr T mul(const T &a, const T &b) {
+            T result{};
+            if(overflow::mulOverflows(a, b, result)) {throw std::overflow_error("rto::Ratio : overflow in a product");}
+            return result;
+        }
+
+        template <typename T>
+        static constexpr T add(const T &a, const T &b) {
+            T result{};
+            if(overflow::addOverflows(a, b, result)) {throw std::overflow_error("rto::Ratio : overflow in a sum");}
+            return result;
+        }
+
+        template <typename T>
+        static constexpr T sub(const T &a, const T &b) {
+            T result{};
+            if(overflow::subOverflows(a, b, result)) {throw std::overflow_error("rto::Ratio : overflow in a difference");}
+            return result;
+        }
+
+        template <typename T>
+        static constexpr void narrow(const T &num, const T &den, T &numerator, T &denominator) {
+            numerator = num;
+            denominator = den;
+        }
+    };
+
+    /// \brief compute the intermediates in the wider integer type (int64 for int32, __int128 for int64)
+    /// and reduce back to T; throw std::overflow_error if the irreducible result does not fit in T
+    struct Widen {
+        template <typename T> using wide_type = typename overflow::wider<T>::type;
+
+        // the wide type can overflow too, in sums of products and in the nodes of a Fused expression
+        template <typename W>
+        static constexpr W mul(const W &a, const W &b) {
+            W result{};
+            if(overflow::mulOverflows(a, b, result)) {throw std::overflow_error("rto::Ratio : overflow in a product");}
+            return result;
+        }
+
+        template <typename W>
+        static constexpr W add(const W &a, const W &b) {
+            W result{};
+            if(overflow::addOverflows(a, b, result)) {throw std::overflow_error("rto::Ratio : overflow in a sum");}
+            return result;
+        }
+
+        template <typename W>
+        static constexpr W sub(const W &a, const W &b) {
+            W result{};
+            if(overflow::subOverflows(a, b, result)) {throw std::overflow_error("rto::Ratio : overflow in a difference");}
+            return result;
+        }
+
+        template <typename T, typename W>
+        static constexpr void narrow(W num, W den, T &numerator, T &denominator) {
+            if(!overflow::fits<T>(num) || !overflow::fits<T>(den)) {
+                const W pgcd = overflow::gcd(num, den);
+                if(pgcd > W(1)) {
+                    num /= pgcd;
+                    den /= pgcd;
+                }
+                if(!overflow::fits<T>(num) || !overflow::fits<T>(den)) {
+                    throw std::overflow_error("rto::Ratio : result does not fit in the integer type");
+                }
+            }
+            numerator = static_cast<T>(num);
+            denominator = static_cast<T>(den);
+        }
+    };
+
+    /// \brief compute the intermediates in the wider integer type and, when the irreducible result does
+    /// not fit in T, round it: numerator and denominator are shifted right together (the value is kept
+    /// to about the precision of T), and values too large are clamped to +-max/1
+    struct Saturate {
+        template <typename T> using wide_type = typename overflow::wider<T>::type;
+
+        /// \brief +-max of the wide type, when an intermediate overflows it (narrow then clamps to +-max/1)
+        template <typename W>
+        static constexpr W clamp(bool negative) {
+            return negative ? -std::numeric_limits<W>::max() : std::numeric_limits<W>::max();
+        }
+
+        template <typename W>
+        static constexpr W mul(const W &a, const W &b) {
+            W result{};
+            if(overflow::mulOverflows(a, b, result)) {return clamp<W>((a < W(0)) != (b < W(0)));}
+            return result;
+        }
+
+        template <typename W>
+        static constexpr W add(const W &a, const W &b) {
+            W result{};
+            if(overflow::addOverflows(a, b, result)) {return clamp<W>(a < W(0));}
+            return result;
+        }
+
+        template <typename W>
+        static constexpr W sub(const W &a, const W &b) {
+            W result{};
+            if(overflow::subOverflows(a, b, result)) {return clamp<W>(a < W(0));}
+            return result;
+        }
+
+        template <typename T, typename W>
+        static constexpr void narrow(W num, W den, T &numerator, T &denominator) {
+            if(!overflow::fits<T>(num) || !overflow::fits<T>(den)) {
+                const W pgcd = overflow::gcd(num, den);
+                if(pgcd > W(1)) {
+                    num /= pgcd;
+                    den /= pgcd;
+                }
+            }
+            if(!overflow::fits<T>(num) || !overflow::fits<T>(den)) {
+                const bool negative = (num < W(0)) != (den < W(0));
+                W absNum = num < W(0) ? -num : num;
+                W absDen = den < W(0) ? -den : den;
+                while(!overflow::fits<T>(absNum) || !overflow::fits<T>(absDen)) {
+                    absNum >>= 1;
+                    absDen >>= 1;
+                }
+                if(absDen == W(0)) {
+                    absNum = static_cast<W>(std::numeric_limits<T>::max());
+                    absDen = W(1);
+                }
+                const W pgcd = overflow::gcd(absNum, absDen);
+                if(pgcd > W(1)) {
+                    absNum /= pgcd;
+                    absDen /= pgcd;
+                }
+                num = negative ? -absNum : absNum;
+                den = absDen;
+            }
+            numerator = static_cast<T>(num);
+            denominator = static_cast<T>(den);
+        }
+    };
+}
@@ -0,0 +1,369 @@
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "Ratio.hpp"
+#include "RatioArray.hpp"
+#include "RatioScale.hpp"
+
+#pragma once
+
+
+/// \file RatioPolynomial.hpp
+/// \brief polynomials and rational functions with rational coefficients, evaluated by batches of points.
+/// The coefficients are stored as integers over their common denominator D. At a point x = p/q, the
+/// homogeneous Horner scheme s = s*p + c[k]*q^(n-k) gives P(x) = s / (D*q^n) with integer products
+/// only; the points of a batch are processed as a structure of arrays (one coefficient for every
+/// point, a loop the compiler can vectorize) and each output is normalized once.
+/// The integers are kept in the wider type when there is one. A point whose intermediates could
+/// overflow it (bound computed from the bit widths of p, q and the coefficients) is evaluated with
+/// the operators of Ratio instead.
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief number of points of a batch evaluated together (their intermediates stay in L1)
+        constexpr std::size_t hornerBlockSize = 256;
+
+        /// \brief homogeneous Horner scheme on a batch of points p[i]/q[i], in wrapping unsigned arithmetic
+        /// \param coefficients : the integer coefficients, constant term first
+        /// \param length : number of coefficients (n+1)
+        /// \param p : the numerators of the points
+        /// \param q : the denominators of the points
+        /// \param size : number of points
+        /// \param s : receives sum of coefficients[k] * p^k * q^(n-k), modulo 2^digits(U)
+        /// \param qn : receives q^n, modulo 2^digits(U)
+        template <typename W, typename T, typename U>
+        void hornerHomogeneous(const T *coefficients, std::size_t length, const T *p, const T *q, std::size_t size, U *s, U *qn) {
+            const U top = static_cast<U>(W(coefficients[length-1]));
+            for(std::size_t i=0; i<size; ++i) {
+                s[i] = top;
+                qn[i] = U(1);
+            }
+            for(std::size_t k=length-1; k-- > 0;) {
+                const U c = static_cast<U>(W(coefficients[k]));
+                for(std::size_t i=0; i<size; ++i) {
+                    qn[i] *= static_cast<U>(W(q[i]));
+                    s[i] = s[i] * static_cast<U>(W(p[i])) + c * qn[i];
+                }
+            }
+        }
+
+        /// \brief true if the homogeneous Horner scheme of a point cannot overflow W
+        /// \param coefficientBits : bit width of the sum of the magnitudes of the coefficients (an upper bound)
+        /// \param scaleBits : bit width of the common denominator of the coefficients
+        /// \param degree : the degree n
+        /// \param p : the numerator of the point
+        /// \param q : the denominator of the point
+        template <typename W, typename T>
+        bool hornerFits(int coefficientBits, int scaleBits, std::size_t degree, const T &p, const T &q) {
+            const int pBits = bitWidth(magnitude(p)), qBits = bitWidth(magnitude(q));
+            const std::size_t digits = static_cast<std::size_t>(std::numeric_limits<W>::digits);
+            // |s| <= sum|c| * max(|p|,|q|)^n and |D*q^n| < 2^(scaleBits + n*qBits)
+            return static_cast<std::size_t>(coefficientBits) + degree * static_cast<std::size_t>(std::max(pBits, qBits)) <= digits
+                && static_cast<std::size_t>(scaleBits) + degree * static_cast<std::size_t>(qBits) <= digits;
+        }
+
+        /// \brief irreducible numerator / denominator, with a positive denominator, stored in T
+        /// @return false if it does not fit
+        template <typename T, typename W>
+        bool normalizeTo(W numerator, W denominator, T &resultNumerator, T &resultDenominator) {
+            if constexpr (!std::is_same_v<T, W>) {
+                // gcd on the narrow type when it is enough (a 128-bit gcd costs several 64-bit ones)
+                if(overflow::fits<T>(numerator) && overflow::fits<T>(denominator)) {
+                    return normalizeTo(static_cast<T>(numerator), static_cast<T>(denominator), resultNumerator, resultDenominator);
+                }
+            }
+            const W g = rto::gcd(numerator, denominator);
+            if(g > W(1)) {
+                numerator /= g;
+                denominator /= g;
+            }
+            if constexpr (std::numeric_limits<W>::is_signed) {
+                if(denominator < W(0)) {
+                    numerator = -numerator;
+                    denominator = -denominator;
+                }
+            }
+            return narrowTo(numerator, resultNumerator) && narrowTo(denominator, resultDenominator);
+        }
+
+        /// \brief upper bound of the bit width of the sum of the magnitudes of integers
+        template <typename T>
+        int sumBits(const std::vector<T> &values) {
+            int bits = 0;
+            for(const T &value : values) {
+                bits = std::max(bits, bitWidth(magnitude(value)));
+            }
+            return bits + bitWidth(values.size());
+        }
+    }
+
+
+    /// \class Polynomial
+    /// \brief polynomial with rational coefficients
+    /// \tparam T : the integer type of the Ratio<T> coefficients and points
+    template <typename T = int>
+    class Polynomial {
+
+    public :
+
+        using value_type = Ratio<T>;
+
+        /// \brief defaultConstructor, null polynomial
+        /// @return the polynomial 0
+        Polynomial() : Polynomial(std::vector<Ratio<T>>()) {}
+
+        /// \brief constructor from the coefficients
+        /// \param coefficients : the coefficients, constant term first
+        /// @return the polynomial
+        Polynomial(std::initializer_list<Ratio<T>> coefficients) : Polynomial(std::vector<Ratio<T>>(coefficients)) {}
+
+        /// \brief constructor from the coefficients
+        /// \param coefficients : the coefficients, constant term first
+        /// @return the polynomial
+        explicit Polynomial(const std::vector<Ratio<T>> &coefficients) : m_coefficients(coefficients) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+            while(m_coefficients.size() > 1 && m_coefficients.back().numerator() == T(0)) {
+                m_coefficients.pop_back();
+            }
+            if(m_coefficients.empty()) {m_coefficients.push_back(Ratio<T>());}
+
+            // integer coefficients over their common denominator (the ratio operators are used if it does not fit)
+            m_numerators.resize(m_coefficients.size());
+            m_scaled = kernel::commonDenominator(m_coefficients.data(), m_coefficients.size(), m_denominator)
+                       && kernel::scaleNumerators(m_coefficients.data(), m_coefficients.size(), m_denominator, m_numerators.data());
+            if(!m_scaled) {
+                m_numerators.clear();
+                m_denominator = T(1);
+            }
+            m_coefficientBits = kernel::sumBits(m_numerators);
+        }
+
+        /// \brief get the degree (0 for a constant, also for the null polynomial)
+        /// @return the degree
+        inline std::size_t degree() const {return m_coefficients.size() - 1;};
+
+        /// \brief get a coefficient
+        /// \param k : the power of x
+        /// @return the coefficient of x^k (0 above the degree)
+        inline Ratio<T> operator[](std::size_t k) const {return k < m_coefficients.size() ? m_coefficients[k] : Ratio<T>();};
+
+        /// \brief get the integer coefficients, P(x) = sum of integerCoefficients()[k] * x^k / denominator()
+        /// @return the numerators of the coefficients over their common denominator (empty if it does not fit in T)
+        inline const std::vector<T>& integerCoefficients() const {return m_numerators;};
+
+        /// \brief get the common denominator of the coefficients
+        /// @return the least common denominator (1 if it does not fit in T)
+        inline const T& denominator() const {return m_denominator;};
+
+        /// \brief value at a point
+        /// \param x : the point
+        /// @return P(x)
+        Ratio<T> operator()(const Ratio<T> &x) const {
+            Ratio<T> result;
+            evaluate(&x.numerator(), &x.denominator(), &result.numerator(), &result.denominator(), 1);
+            return result;
+        }
+
+        /// \brief multipoint evaluation
+        /// \param points : the points
+        /// \param result : the values, resized to points.size() (may be points)
+        void evaluate(const RatioArray<T> &points, RatioArray<T> &result) const {
+            result.resize(points.size());
+            evaluate(points.numerators(), points.denominators(), result.numerators(), result.denominators(), points.size());
+        }
+
+        /// \brief multipoint evaluation
+        /// \param points : the points
+        /// @return the values
+        std::vector<Ratio<T>> evaluate(const std::vector<Ratio<T>> &points) const {
+            RatioArray<T> values(points);
+            evaluate(values, values);
+            return values.toVector();
+        }
+
+        /// \brief Horner scheme with the operators of Ratio (every step normalized)
+        /// \param x : the point
+        /// @return P(x)
+        Ratio<T> horner(const Ratio<T> &x) const {
+            Ratio<T> result = m_coefficients.back();
+            for(std::size_t k=m_coefficients.size()-1; k-- > 0;) {
+                result = result * x + m_coefficients[k];
+            }
+            return result;
+        }
+
+        /// \brief operator ==
+        /// \param poly : a polynomial
+        /// @return true if the coefficients are equal
+        bool operator==(const Polynomial &poly) const {return m_coefficients == poly.m_coefficients;}
+
+        /// \brief operator !=
+        /// \param poly : a polynomial
+        /// @return true if the coefficients differ
+        bool operator!=(const Polynomial &poly) const {return !(*this == poly);}
+
+        /// \brief overload the operator << for Polynomial
+        /// \param stream : input stream
+        /// \param poly : the polynomial to output
+        /// \return the output stream containing the coefficients, constant term first
+        friend std::ostream& operator<<(std::ostream& stream, const Polynomial& poly) {
+            for(std::size_t k=0; k<poly.m_coefficients.size(); ++k) {
+                stream << (k ? " + " : "") << poly.m_coefficients[k];
+                if(k > 0) {stream << " x";}
+                if(k > 1) {stream << "^" << k;}
+            }
+            return stream;
+        }
+
+    private :
+
+        using W = typename kernel::productOf<T>::type;
+        using U = typename kernel::unsignedOf<W>::type;
+
+        std::vector<Ratio<T>> m_coefficients;
+        std::vector<T> m_numerators;
+        T m_denominator = T(1);
+        int m_coefficientBits = 0;
+        bool m_scaled = false;
+
+        /// \brief batch evaluation on separate numerator / denominator buffers (results may alias the points)
+        void evaluate(const T *pn, const T *pd, T *rn, T *rd, std::size_t size) const {
+            std::array<U, kernel::hornerBlockSize> s, qn;
+            const int scaleBits = kernel::bitWidth(kernel::magnitude(m_denominator));
+            for(std::size_t begin=0; begin<size; begin+=kernel::hornerBlockSize) {
+                const std::size_t count = std::min(kernel::hornerBlockSize, size - begin);
+                if(m_scaled) {
+                    kernel::hornerHomogeneous<W>(m_numerators.data(), m_numerators.size(), pn + begin, pd + begin, count, s.data(), qn.data());
+                }
+                for(std::size_t i=0; i<count; ++i) {
+                    const T p = pn[begin+i], q = pd[begin+i];
+                    if(!m_scaled || !kernel::hornerFits<W>(m_coefficientBits, scaleBits, degree(), p, q)
+                       || !kernel::normalizeTo(static_cast<W>(s[i]), W(W(m_denominator) * static_cast<W>(qn[i])), rn[begin+i], rd[begin+i])) {
+                        Ratio<T> x;
+                        x.numerator() = p;
+                        x.denominator() = q;
+                        const Ratio<T> value = horner(x);
+                        rn[begin+i] = value.numerator();
+                        rd[begin+i] = value.denominator();
+                    }
+                }
+            }
+        }
+
+        template <typename> friend class RationalFunction;
+    };
+
+
+    /// \class RationalFunction
+    /// \brief quotient P/Q of two polynomials with rational coefficients. Both are brought to the same
+    /// integer coefficients denominators and evaluated on the same powers of q, so that
+    /// P(x)/Q(x) = sP / sQ with a single normalization per point.
+    /// \tparam T : the integer type of the Ratio<T> coefficients and points
+    template <typename T = int>
+    class RationalFunction {
+
+    public :
+
+        using value_type = Ratio<T>;
+
+        /// \brief constructor
+        /// \param numerator : the polynomial P
+        /// \param denominator : the polynomial Q (not null)
+        /// @return the rational function P/Q
+        RationalFunction(const Polynomial<T> &numerator, const Polynomial<T> &denominator = Polynomial<T>({Ratio<T>(T(1), T(1))}))
+            : m_numerator(numerator), m_denominator(denominator) {
+            assert((m_denominator.degree() > 0 || m_denominator[0].numerator() != T(0)) && "Can't divide by the null polynomial");
+
+            // P/Q = (DQ * sum a[k] x^k) / (DP * sum b[k] x^k), both padded to the largest degree
+            const std::size_t length = std::max(numerator.m_coefficients.size(), denominator.m_coefficients.size());
+            m_a.assign(length, T(0));
+            m_b.assign(length, T(0));
+            T scale{};
+            m_scaled = numerator.m_scaled && denominator.m_scaled
+                       && !overflow::mulOverflows(numerator.m_denominator, denominator.m_denominator, scale)
+                       && kernel::scaleNumerators(numerator.m_coefficients.data(), numerator.m_coefficients.size(), scale, m_a.data())
+                       && kernel::scaleNumerators(denominator.m_coefficients.data(), denominator.m_coefficients.size(), scale, m_b.data());
+            m_coefficientBits = std::max(kernel::sumBits(m_a), kernel::sumBits(m_b));
+        }
+
+        /// \brief get the numerator
+        /// @return the polynomial P
+        inline const Polynomial<T>& numerator() const {return m_numerator;};
+
+        /// \brief get the denominator
+        /// @return the polynomial Q
+        inline const Polynomial<T>& denominator() const {return m_denominator;};
+
+        /// \brief value at a point
+        /// \param x : the point (Q(x) must not be 0)
+        /// @return P(x) / Q(x)
+        Ratio<T> operator()(const Ratio<T> &x) const {
+            Ratio<T> result;
+            evaluate(&x.numerator(), &x.denominator(), &result.numerator(), &result.denominator(), 1);
+            return result;
+        }
+
+        /// \brief multipoint evaluation
+        /// \param points : the points (Q must not vanish on them)
+        /// \param result : the values, resized to points.size() (may be points)
+        void evaluate(const RatioArray<T> &points, RatioArray<T> &result) const {
+            result.resize(points.size());
+            evaluate(points.numerators(), points.denominators(), result.numerators(), result.denominators(), points.size());
+        }
+
+        /// \brief multipoint evaluation
+        /// \param points : the points (Q must not vanish on them)
+        /// @return the values
+        std::vector<Ratio<T>> evaluate(const std::vector<Ratio<T>> &points) const {
+            RatioArray<T> values(points);
+            evaluate(values, values);
+            return values.toVector();
+        }
+
+    private :
+
+        using W = typename kernel::productOf<T>::type;
+        using U = typename kernel::unsignedOf<W>::type;
+
+        Polynomial<T> m_numerator;
+        Polynomial<T> m_denominator;
+        std::vector<T> m_a;
+        std::vector<T> m_b;
+        int m_coefficientBits = 0;
+        bool m_scaled = false;
+
+        /// \brief batch evaluation on separate numerator / denominator buffers (results may alias the points)
+        void evaluate(const T *pn, const T *pd, T *rn, T *rd, std::size_t size) const {
+            std::array<U, kernel::hornerBlockSize> sa, sb, qn;
+            const std::size_t degree = m_a.size() - 1;
+            for(std::size_t begin=0; begin<size; begin+=kernel::hornerBlockSize) {
+                const std::size_t count = std::min(kernel::hornerBlockSize, size - begin);
+                if(m_scaled) {
+                    kernel::hornerHomogeneous<W>(m_a.data(), m_a.size(), pn + begin, pd + begin, count, sa.data(), qn.data());
+                    kernel::hornerHomogeneous<W>(m_b.data(), m_b.size(), pn + begin, pd + begin, count, sb.data(), qn.data());
+                }
+                for(std::size_t i=0; i<count; ++i) {
+                    const T p = pn[begin+i], q = pd[begin+i];
+                    const bool fits = m_scaled && kernel::hornerFits<W>(m_coefficientBits, 0, degree, p, q);
+                    assert((!fits || sb[i] != U(0)) && "Can't divide by 0");
+                    if(!fits || !kernel::normalizeTo(static_cast<W>(sa[i]), static_cast<W>(sb[i]), rn[begin+i], rd[begin+i])) {
+                        Ratio<T> x;
+                        x.numerator() = p;
+                        x.denominator() = q;
+                        const Ratio<T> value = m_numerator.horner(x) / m_denominator.horner(x);
+                        rn[begin+i] = value.numerator();
+                        rd[begin+i] = value.denominator();
+                    }
+                }
+            }
+        }
+    };
+}
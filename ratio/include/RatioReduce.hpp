@@ -0,0 +1,195 @@
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <cstddef>
+#include <iterator>
+#include <exception>
+#include <algorithm>
+#include <type_traits>
+
+#include "Ratio.hpp"
+
+#pragma once
+
+
+/// \file RatioReduce.hpp
+/// \brief parallel exact reductions of ranges of ratios : reduceSum, reduceProduct and dot.
+/// The range is cut in blocks of kernel::reduceBlockSize ratios; the threads take the blocks one
+/// after the other, reduce each of them serially, and the partial results are merged two by two
+/// (a balanced tree, so the intermediates stay small). The blocks and the tree only depend on the
+/// size of the range: every thread count, including 1, gives exactly the same bits, even when an
+/// intermediate wraps around.
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief number of ratios reduced serially by a thread before the partial results are merged
+        constexpr std::size_t reduceBlockSize = std::size_t(1) << 14;
+
+        /// \class SumAccumulator
+        /// \brief sum kept on a running common denominator D (the lcm of the denominators seen so far):
+        /// a/b is added as N = N*(b/g) + a*(D/g), D = (D/g)*b with g = gcd(D,b). At most one gcd per term
+        /// instead of two for Ratio::operator+ (none once b divides D), and the sum is reduced once at the end.
+        /// When the common denominator would overflow T, the sum is reduced and the term is added
+        /// with the operator + of R (so the overflow policy of R applies).
+        template <typename R>
+        class SumAccumulator {
+
+        public :
+
+            using T = typename R::value_type;
+
+            /// \brief add a ratio
+            /// \param a : its numerator
+            /// \param b : its denominator
+            void add(const T &a, const T &b) {
+                T num{}, den{}, left{}, right{};
+                if(m_denominator % b == T(0)) {
+                    // b divides the common denominator (g = b) : one division, no gcd
+                    if(!overflow::mulOverflows(a, T(m_denominator / b), right) && !overflow::addOverflows(m_numerator, right, num)) {
+                        m_numerator = num;
+                        return;
+                    }
+                }
+                const T g = rto::gcd(m_denominator, b);
+                const T dg = m_denominator / g;
+                if(!overflow::mulOverflows(dg, b, den) && !overflow::mulOverflows(m_numerator, T(b / g), left)
+                   && !overflow::mulOverflows(a, dg, right) && !overflow::addOverflows(left, right, num)) {
+                    m_numerator = num;
+                    m_denominator = den;
+                    return;
+                }
+                const R sum = result() + R(a, b);
+                m_numerator = sum.numerator();
+                m_denominator = sum.denominator();
+            }
+
+            /// \brief the irreducible sum, with a positive denominator
+            R result() const {
+                if constexpr (std::numeric_limits<T>::is_signed) {
+                    if(m_denominator < T(0)) {return R(-m_numerator, -m_denominator);}
+                }
+                return R(m_numerator, m_denominator);
+            }
+
+        private :
+
+            T m_numerator = T(0);
+            T m_denominator = T(1);
+        };
+
+        /// \brief reduce size elements by blocks on several threads, then merge the partial results as a balanced tree
+        /// \param size : number of elements
+        /// \param threads : number of threads (0 for std::thread::hardware_concurrency())
+        /// \param identity : result of an empty range
+        /// \param block : block(begin, end) reduces the elements [begin, end)
+        /// \param merge : merge(left, right) combines two partial results
+        /// @return the reduction, the first exception thrown by a block is rethrown
+        template <typename R, typename Block, typename Merge>
+        R reduceBlocks(std::size_t size, unsigned int threads, const R &identity, const Block &block, const Merge &merge) {
+            const std::size_t blocks = (size + reduceBlockSize - 1) / reduceBlockSize;
+            if(blocks == 0) {return identity;}
+
+            std::vector<R> partials(blocks);
+            std::atomic<std::size_t> next{0};
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            const auto work = [&]() {
+                try {
+                    for(std::size_t i = next++; i < blocks; i = next++) {
+                        partials[i] = block(i * reduceBlockSize, std::min(size, (i + 1) * reduceBlockSize));
+                    }
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if(!error) {error = std::current_exception();}
+                    next = blocks;
+                }
+            };
+
+            std::size_t workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+            workers = std::min(workers, blocks);
+            std::vector<std::thread> pool;
+            pool.reserve(workers - 1);
+            for(std::size_t i=1; i<workers; ++i) {
+                pool.emplace_back(work);
+            }
+            work();
+            for(std::thread &thread : pool) {
+                thread.join();
+            }
+            if(error) {std::rethrow_exception(error);}
+
+            for(std::size_t step=1; step<blocks; step*=2) {
+                for(std::size_t i=0; i+step<blocks; i+=2*step) {
+                    partials[i] = merge(partials[i], partials[i+step]);
+                }
+            }
+            return partials[0];
+        }
+    }
+
+    /// \brief exact sum of a range of ratios, on several threads
+    /// \param first, last : random access range of Ratio
+    /// \param threads : number of threads (0 for std::thread::hardware_concurrency(), 1 for a serial sum)
+    /// @return the irreducible sum (identical bits for every thread count)
+    template <typename Iterator>
+    auto reduceSum(Iterator first, Iterator last, unsigned int threads = 0) {
+        using R = typename std::iterator_traits<Iterator>::value_type;
+        static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>, "Invalid iterator; should be random access");
+        const auto block = [first](std::size_t begin, std::size_t end) {
+            kernel::SumAccumulator<R> sum;
+            for(std::size_t i=begin; i<end; ++i) {
+                const R &rat = first[i];
+                sum.add(rat.numerator(), rat.denominator());
+            }
+            return sum.result();
+        };
+        const auto merge = [](const R &left, const R &right) {return R(left + right);};
+        return kernel::reduceBlocks<R>(static_cast<std::size_t>(last - first), threads, R(), block, merge);
+    }
+
+    /// \brief exact product of a range of ratios, on several threads
+    /// \param first, last : random access range of Ratio
+    /// \param threads : number of threads (0 for std::thread::hardware_concurrency(), 1 for a serial product)
+    /// @return the irreducible product (identical bits for every thread count)
+    template <typename Iterator>
+    auto reduceProduct(Iterator first, Iterator last, unsigned int threads = 0) {
+        using R = typename std::iterator_traits<Iterator>::value_type;
+        using T = typename R::value_type;
+        static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>, "Invalid iterator; should be random access");
+        const auto block = [first](std::size_t begin, std::size_t end) {
+            R product(T(1), T(1));
+            for(std::size_t i=begin; i<end; ++i) {
+                product = product * first[i];
+            }
+            return product;
+        };
+        const auto merge = [](const R &left, const R &right) {return R(left * right);};
+        return kernel::reduceBlocks<R>(static_cast<std::size_t>(last - first), threads, R(T(1), T(1)), block, merge);
+    }
+
+    /// \brief exact dot product of two ranges of ratios, sum of a[i]*b[i], on several threads
+    /// \param first1, last1 : random access range of Ratio
+    /// \param first2 : start of the second range (at least last1-first1 ratios)
+    /// \param threads : number of threads (0 for std::thread::hardware_concurrency(), 1 for a serial sum)
+    /// @return the irreducible dot product (identical bits for every thread count)
+    template <typename Iterator1, typename Iterator2>
+    auto dot(Iterator1 first1, Iterator1 last1, Iterator2 first2, unsigned int threads = 0) {
+        using R = typename std::iterator_traits<Iterator1>::value_type;
+        static_assert(std::is_same_v<R, typename std::iterator_traits<Iterator2>::value_type>, "Invalid ranges; should hold the same Ratio type");
+        static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator1>::iterator_category>
+                      && std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator2>::iterator_category>, "Invalid iterator; should be random access");
+        const auto block = [first1, first2](std::size_t begin, std::size_t end) {
+            kernel::SumAccumulator<R> sum;
+            for(std::size_t i=begin; i<end; ++i) {
+                const R product = first1[i] * first2[i];
+                sum.add(product.numerator(), product.denominator());
+            }
+            return sum.result();
+        };
+        const auto merge = [](const R &left, const R &right) {return R(left + right);};
+        return kernel::reduceBlocks<R>(static_cast<std::size_t>(last1 - first1), threads, R(), block, merge);
+    }
+}
@@ -0,0 +1,64 @@
+#include <cstddef>
+#include <type_traits>
+
+#include "RatioPolicy.hpp"
+#include "RatioGcd.hpp"
+
+#pragma once
+
+
+/// \file RatioScale.hpp
+/// \brief integer kernels shared by Matrix and Polynomial : a product type wide enough for two T,
+/// and the scaling of rows of ratios to integer numerators over a common denominator.
+
+namespace rto {
+
+    namespace kernel {
+
+        /// \brief integer type of the products of two T : wider<T> when there is one, T itself otherwise
+        template <typename T, bool = overflow::hasWider<T>()> struct productOf {using type = T;};
+        template <typename T> struct productOf<T, true> {using type = typename overflow::wider<T>::type;};
+
+        /// \brief store a product-type value in T
+        /// @return false if it does not fit
+        template <typename T, typename W>
+        constexpr bool narrowTo(const W &value, T &result) {
+            if constexpr (!std::is_same_v<T, W>) {
+                if(!overflow::fits<T>(value)) {return false;}
+            }
+            result = static_cast<T>(value);
+            return true;
+        }
+
+        /// \brief least common denominator of ratios
+        /// \param values : the ratios
+        /// \param size : number of ratios
+        /// \param scale : the common denominator (it may already hold the one of a previous part of the row)
+        /// @return false if the common denominator does not fit in T
+        template <typename R, typename T>
+        bool commonDenominator(const R *values, std::size_t size, T &scale) {
+            for(std::size_t i=0; i<size; ++i) {
+                T den = values[i].denominator();
+                if(den < T(0)) {den = -den;}
+                if(overflow::mulOverflows(T(scale / rto::gcd(scale, den)), den, scale)) {return false;}
+            }
+            return true;
+        }
+
+        /// \brief numerators of ratios over a common denominator: values[i] = out[i] / scale
+        /// \param values : the ratios
+        /// \param size : number of ratios
+        /// \param scale : a multiple of every denominator
+        /// \param out : the integer numerators
+        /// @return false if a numerator does not fit in T
+        template <typename R, typename T>
+        bool scaleNumerators(const R *values, std::size_t size, const T &scale, T *out) {
+            for(std::size_t i=0; i<size; ++i) {
+                const T num = values[i].denominator() < T(0) ? T(-values[i].numerator()) : values[i].numerator();
+                const T den = values[i].denominator() < T(0) ? T(-values[i].denominator()) : values[i].denominator();
+                if(overflow::mulOverflows(num, T(scale / den), out[i])) {return false;}
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,524 @@
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define RTO_HAS_MMAP 1
+#else
+#define RTO_HAS_MMAP 0
+#endif
+
+#include "Ratio.hpp"
+#include "RatioArray.hpp"
+
+#pragma once
+
+
+/// \file RatioSerialize.hpp
+/// \brief versioned binary format for arrays of ratios.
+/// A file is a 32-byte header followed by the payload, every integer is little-endian:
+/// \li header : magic "RTOA", version (uint16), encoding (uint8), sizeof(T) (uint8), signedness (uint8),
+/// 3 reserved bytes, number of ratios (uint64), payload size in bytes (uint64), 4 reserved bytes
+/// \li Fixed encoding : the numerators then the denominators, each array starting on a multiple of
+/// io::alignment bytes, so a mapped file is directly a structure of arrays (MappedRatioArray)
+/// \li Varint encoding : for each ratio the numerator then the denominator, zigzag encoded for signed
+/// types, as LEB128 varints (1 byte for |x| < 64, small ratios take 2 bytes instead of 2*sizeof(T))
+/// The readers throw std::runtime_error on a malformed or truncated input, or when the file does not
+/// hold ratios of the requested integer type.
+
+namespace rto {
+
+    namespace io {
+
+        /// \brief format version written in the header
+        constexpr std::uint16_t version = 1;
+
+        /// \brief size of the header, and alignment of the fixed-width arrays in the file
+        constexpr std::size_t alignment = 32;
+
+        /// \brief payload encoding
+        enum class Encoding : std::uint8_t {
+            Fixed = 0,  ///< fixed-width integers, mmap-able
+            Varint = 1  ///< zigzag varints, compact for streaming
+        };
+
+        /// \brief decoded header of a file
+        struct Header {
+            std::uint16_t version = io::version;
+            Encoding encoding = Encoding::Fixed;
+            std::uint8_t integerBytes = 0;
+            bool isSigned = false;
+            std::uint64_t size = 0;
+            std::uint64_t payloadBytes = 0;
+
+            /// \brief check that the file holds ratios of T
+            template <typename T>
+            void expect() const {
+                if(integerBytes != sizeof(T) || isSigned != std::numeric_limits<T>::is_signed) {
+                    throw std::runtime_error("rto::io : the file holds another integer type");
+                }
+            }
+        };
+    }
+
+    namespace kernel {
+
+        /// \brief true when the integers are stored little-endian in memory
+        constexpr bool littleEndian() {
+        #if defined(__BYTE_ORDER__)
+            return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+        #else
+            return true;
+        #endif
+        }
+
+        /// \brief store an unsigned value as little-endian bytes
+        template <typename U>
+        void storeLittle(U value, unsigned char *bytes) {
+            for(std::size_t i=0; i<sizeof(U); ++i) {
+                bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+            }
+        }
+
+        /// \brief load an unsigned value from little-endian bytes
+        template <typename U>
+        U loadLittle(const unsigned char *bytes) {
+            U value = 0;
+            for(std::size_t i=0; i<sizeof(U); ++i) {
+                value |= static_cast<U>(static_cast<U>(bytes[i]) << (8 * i));
+            }
+            return value;
+        }
+
+        /// \brief size of the fixed-width numerators array, padded to the alignment
+        template <typename T>
+        constexpr std::uint64_t paddedBytes(std::uint64_t size) {
+            return (size * sizeof(T) + io::alignment - 1) / io::alignment * io::alignment;
+        }
+
+        /// \brief zigzag encoding : 0, -1, 1, -2... become 0, 1, 2, 3... (identity for unsigned types)
+        template <typename T>
+        constexpr typename unsignedOf<T>::type zigzag(const T &value) {
+            using U = typename unsignedOf<T>::type;
+            if constexpr (std::numeric_limits<T>::is_signed) {
+                return static_cast<U>(static_cast<U>(value) << 1) ^ static_cast<U>(value < T(0) ? ~U(0) : U(0));
+            } else {
+                return value;
+            }
+        }
+
+        /// \brief inverse of zigzag
+        template <typename T>
+        constexpr T unzigzag(const typename unsignedOf<T>::type &value) {
+            using U = typename unsignedOf<T>::type;
+            if constexpr (std::numeric_limits<T>::is_signed) {
+                return static_cast<T>(static_cast<U>(value >> 1) ^ static_cast<U>(U(0) - (value & U(1))));
+            } else {
+                return value;
+            }
+        }
+
+        /// \brief append a LEB128 varint (7 bits per byte, high bit set on every byte but the last)
+        /// \param value : the value
+        /// \param out : where to write, at least (digits+6)/7 bytes
+        /// @return one past the last byte written
+        template <typename U>
+        unsigned char * putVarint(U value, unsigned char *out) {
+            while(value >= U(0x80)) {
+                *out++ = static_cast<unsigned char>(value | U(0x80));
+                value >>= 7;
+            }
+            *out++ = static_cast<unsigned char>(value);
+            return out;
+        }
+
+        /// \brief read a LEB128 varint
+        /// \param in : first byte
+        /// \param end : end of the buffer
+        /// \param value : the value read
+        /// @return one past the last byte read, nullptr if the varint is truncated or too long for U
+        template <typename U>
+        const unsigned char * getVarint(const unsigned char *in, const unsigned char *end, U &value) {
+            value = 0;
+            for(int shift=0; shift<std::numeric_limits<U>::digits; shift+=7) {
+                if(in == end) {return nullptr;}
+                const unsigned char byte = *in++;
+                const U bits = static_cast<U>(U(byte & 0x7f) << shift);
+                if(static_cast<U>(bits >> shift) != U(byte & 0x7f)) {return nullptr;}
+                value |= bits;
+                if(!(byte & 0x80)) {return in;}
+            }
+            return nullptr;
+        }
+
+        /// \brief maximal number of bytes of a varint of U
+        template <typename U>
+        constexpr std::size_t varintBytes() {
+            return (std::numeric_limits<U>::digits + 6) / 7;
+        }
+
+        /// \brief write the integers of a fixed-width array, little-endian
+        template <typename T>
+        void writeFixed(std::ostream &stream, const T *values, std::size_t size) {
+            if constexpr (littleEndian()) {
+                stream.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(size * sizeof(T)));
+            } else {
+                using U = typename unsignedOf<T>::type;
+                std::vector<unsigned char> buffer(sizeof(T) * 4096);
+                for(std::size_t begin=0; begin<size; begin+=4096) {
+                    const std::size_t count = std::min<std::size_t>(4096, size - begin);
+                    for(std::size_t i=0; i<count; ++i) {
+                        storeLittle(static_cast<U>(values[begin+i]), &buffer[i * sizeof(T)]);
+                    }
+                    stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(count * sizeof(T)));
+                }
+            }
+        }
+
+        /// \brief read the integers of a fixed-width array, little-endian
+        template <typename T>
+        void readFixed(std::istream &stream, T *values, std::size_t size) {
+            stream.read(reinterpret_cast<char *>(values), static_cast<std::streamsize>(size * sizeof(T)));
+            if constexpr (!littleEndian()) {
+                using U = typename unsignedOf<T>::type;
+                for(std::size_t i=0; i<size; ++i) {
+                    values[i] = static_cast<T>(loadLittle<U>(reinterpret_cast<const unsigned char *>(values + i)));
+                }
+            }
+        }
+
+        /// \brief skip padding bytes
+        inline void writePadding(std::ostream &stream, std::size_t bytes) {
+            static const char zeros[io::alignment] = {};
+            stream.write(zeros, static_cast<std::streamsize>(bytes));
+        }
+
+        /// \brief throw if the stream failed
+        inline void check(const std::ios &stream, const char *message) {
+            if(!stream) {throw std::runtime_error(message);}
+        }
+    }
+
+    namespace io {
+
+        /// \brief write a header
+        /// \param stream : the output stream
+        /// \param header : the header
+        inline void writeHeader(std::ostream &stream, const Header &header) {
+            unsigned char bytes[alignment] = {'R', 'T', 'O', 'A'};
+            kernel::storeLittle(header.version, bytes + 4);
+            bytes[6] = static_cast<unsigned char>(header.encoding);
+            bytes[7] = header.integerBytes;
+            bytes[8] = header.isSigned ? 1 : 0;
+            kernel::storeLittle(header.size, bytes + 12);
+            kernel::storeLittle(header.payloadBytes, bytes + 20);
+            stream.write(reinterpret_cast<const char *>(bytes), alignment);
+        }
+
+        /// \brief decode a header
+        /// \param bytes : the first io::alignment bytes of a file
+        /// \throw std::runtime_error if they are not a header of a supported version
+        /// @return the header
+        inline Header parseHeader(const unsigned char *bytes) {
+            if(std::memcmp(bytes, "RTOA", 4) != 0) {throw std::runtime_error("rto::io : not a ratio file");}
+            Header header;
+            header.version = kernel::loadLittle<std::uint16_t>(bytes + 4);
+            if(header.version == 0 || header.version > version) {throw std::runtime_error("rto::io : unsupported format version");}
+            if(bytes[6] > static_cast<unsigned char>(Encoding::Varint)) {throw std::runtime_error("rto::io : unknown encoding");}
+            header.encoding = static_cast<Encoding>(bytes[6]);
+            header.integerBytes = bytes[7];
+            header.isSigned = bytes[8] != 0;
+            header.size = kernel::loadLittle<std::uint64_t>(bytes + 12);
+            header.payloadBytes = kernel::loadLittle<std::uint64_t>(bytes + 20);
+            return header;
+        }
+
+        /// \brief read a header
+        /// \param stream : the input stream
+        /// \throw std::runtime_error if the stream does not start with a header of a supported version
+        /// @return the header
+        inline Header readHeader(std::istream &stream) {
+            unsigned char bytes[alignment];
+            stream.read(reinterpret_cast<char *>(bytes), alignment);
+            kernel::check(stream, "rto::io : truncated header");
+            return parseHeader(bytes);
+        }
+
+        /// \brief write ratios given as separate numerators and denominators buffers
+        /// \param stream : the output stream (binary mode)
+        /// \param numerators : the numerators
+        /// \param denominators : the denominators
+        /// \param size : number of ratios
+        /// \param encoding : the payload encoding
+        template <typename T>
+        void write(std::ostream &stream, const T *numerators, const T *denominators, std::size_t size, Encoding encoding = Encoding::Fixed) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+            Header header;
+            header.encoding = encoding;
+            header.integerBytes = sizeof(T);
+            header.isSigned = std::numeric_limits<T>::is_signed;
+            header.size = size;
+
+            if(encoding == Encoding::Fixed) {
+                header.payloadBytes = kernel::paddedBytes<T>(size) + size * sizeof(T);
+                writeHeader(stream, header);
+                kernel::writeFixed(stream, numerators, size);
+                kernel::writePadding(stream, static_cast<std::size_t>(kernel::paddedBytes<T>(size) - size * sizeof(T)));
+                kernel::writeFixed(stream, denominators, size);
+            } else {
+                using U = typename kernel::unsignedOf<T>::type;
+                std::vector<unsigned char> payload(size * 2 * kernel::varintBytes<U>());
+                unsigned char *out = payload.data();
+                for(std::size_t i=0; i<size; ++i) {
+                    out = kernel::putVarint(kernel::zigzag(numerators[i]), out);
+                    out = kernel::putVarint(kernel::zigzag(denominators[i]), out);
+                }
+                header.payloadBytes = static_cast<std::uint64_t>(out - payload.data());
+                writeHeader(stream, header);
+                stream.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(header.payloadBytes));
+            }
+            kernel::check(stream, "rto::io : write failed");
+        }
+
+        /// \brief write an array of ratios
+        /// \param stream : the output stream (binary mode)
+        /// \param array : the ratios
+        /// \param encoding : the payload encoding
+        template <typename T>
+        void write(std::ostream &stream, const RatioArray<T> &array, Encoding encoding = Encoding::Fixed) {
+            write(stream, array.numerators(), array.denominators(), array.size(), encoding);
+        }
+
+        /// \brief write ratios
+        /// \param stream : the output stream (binary mode)
+        /// \param ratios : the ratios
+        /// \param encoding : the payload encoding
+        template <typename T>
+        void write(std::ostream &stream, const std::vector<Ratio<T>> &ratios, Encoding encoding = Encoding::Fixed) {
+            write(stream, RatioArray<T>(ratios), encoding);
+        }
+
+        /// \brief read ratios written by write, as a structure of arrays
+        /// \param stream : the input stream (binary mode), positioned on a header
+        /// \throw std::runtime_error if the input is malformed, truncated or holds another integer type
+        /// @return the ratios, as stored (not normalized again)
+        template <typename T>
+        RatioArray<T> read(std::istream &stream) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+            const Header header = readHeader(stream);
+            header.expect<T>();
+            RatioArray<T> array;
+
+            if(header.encoding == Encoding::Fixed) {
+                // the size is bounded by the payload first, so that a crafted size can not wrap the products around
+                if(header.size > header.payloadBytes / (2 * sizeof(T))
+                   || header.payloadBytes != kernel::paddedBytes<T>(header.size) + header.size * sizeof(T)) {
+                    throw std::runtime_error("rto::io : invalid payload size");
+                }
+                // grow by chunks : a corrupted size fails on the truncated stream instead of allocating it
+                const std::size_t chunk = std::size_t(1) << 16;
+                std::size_t done = 0;
+                while(done < header.size) {
+                    const std::size_t count = std::min<std::size_t>(chunk, static_cast<std::size_t>(header.size - done));
+                    array.resize(done + count);
+                    kernel::readFixed(stream, array.numerators() + done, count);
+                    kernel::check(stream, "rto::io : truncated payload");
+                    done += count;
+                }
+                stream.ignore(static_cast<std::streamsize>(kernel::paddedBytes<T>(header.size) - header.size * sizeof(T)));
+                kernel::readFixed(stream, array.denominators(), static_cast<std::size_t>(header.size));
+                kernel::check(stream, "rto::io : truncated payload");
+            } else {
+                using U = typename kernel::unsignedOf<T>::type;
+                constexpr std::uint64_t maxBytes = kernel::varintBytes<U>();
+                if(header.size > header.payloadBytes / 2
+                   || (2 * header.size <= std::numeric_limits<std::uint64_t>::max() / maxBytes && header.payloadBytes > 2 * header.size * maxBytes)) {
+                    throw std::runtime_error("rto::io : invalid payload size");
+                }
+                std::vector<unsigned char> payload;
+                const std::size_t chunk = std::size_t(1) << 20;
+                while(payload.size() < header.payloadBytes) {
+                    const std::size_t done = payload.size();
+                    const std::size_t count = std::min<std::size_t>(chunk, static_cast<std::size_t>(header.payloadBytes - done));
+                    payload.resize(done + count);
+                    stream.read(reinterpret_cast<char *>(payload.data() + done), static_cast<std::streamsize>(count));
+                    kernel::check(stream, "rto::io : truncated payload");
+                }
+                array.resize(static_cast<std::size_t>(header.size));
+                T *num = array.numerators();
+                T *den = array.denominators();
+                const unsigned char *in = payload.data(), *end = payload.data() + payload.size();
+                for(std::size_t i=0; i<array.size(); ++i) {
+                    U a{}, b{};
+                    if((in = kernel::getVarint(in, end, a)) == nullptr || (in = kernel::getVarint(in, end, b)) == nullptr) {
+                        throw std::runtime_error("rto::io : invalid varint");
+                    }
+                    num[i] = kernel::unzigzag<T>(a);
+                    den[i] = kernel::unzigzag<T>(b);
+                }
+                if(in != end) {throw std::runtime_error("rto::io : invalid payload size");}
+            }
+            return array;
+        }
+    }
+
+
+#if RTO_HAS_MMAP
+
+    /// \class MappedRatioArray
+    /// \brief read-only view of a Fixed encoded file mapped in memory: the numerators and denominators
+    /// are used in place, nothing is parsed or copied (the pages are loaded on first access).
+    /// Needs a little-endian machine.
+    /// \tparam T : the integer type of the ratios
+    template <typename T = int>
+    class MappedRatioArray {
+
+    public :
+
+        /// \brief defaultConstructor, empty view
+        /// @return a view of no ratio
+        MappedRatioArray() = default;
+
+        /// \brief map a file
+        /// \param path : the file, written by io::write with the Fixed encoding
+        /// \throw std::system_error if the file cannot be opened or mapped, std::runtime_error if it is not
+        /// a Fixed encoded file of ratios of T
+        /// @return the view
+        explicit MappedRatioArray(const std::string &path) {
+            static_assert(std::is_integral_v<T>, "Invalid type; should be a number");
+            if constexpr (!kernel::littleEndian()) {
+                throw std::runtime_error("rto::MappedRatioArray : needs a little-endian machine");
+            }
+            const int file = ::open(path.c_str(), O_RDONLY);
+            if(file < 0) {throw std::system_error(errno, std::generic_category(), "rto::MappedRatioArray : " + path);}
+            struct stat status;
+            if(::fstat(file, &status) != 0) {
+                const int error = errno;
+                ::close(file);
+                throw std::system_error(error, std::generic_category(), "rto::MappedRatioArray : " + path);
+            }
+            m_bytes = static_cast<std::size_t>(status.st_size);
+            if(m_bytes < io::alignment) {
+                ::close(file);
+                throw std::runtime_error("rto::io : truncated header");
+            }
+            void *address = ::mmap(nullptr, m_bytes, PROT_READ, MAP_SHARED, file, 0);
+            const int error = errno;
+            ::close(file);
+            if(address == MAP_FAILED) {throw std::system_error(error, std::generic_category(), "rto::MappedRatioArray : " + path);}
+            m_address = static_cast<const unsigned char *>(address);
+
+            try {
+                const io::Header header = io::parseHeader(m_address);
+                header.expect<T>();
+                if(header.encoding != io::Encoding::Fixed) {throw std::runtime_error("rto::MappedRatioArray : only the Fixed encoding can be mapped");}
+                if(header.size > (m_bytes - io::alignment) / (2 * sizeof(T))
+                   || header.payloadBytes != kernel::paddedBytes<T>(header.size) + header.size * sizeof(T)
+                   || io::alignment + header.payloadBytes > m_bytes) {
+                    throw std::runtime_error("rto::io : truncated payload");
+                }
+                m_size = static_cast<std::size_t>(header.size);
+                m_numerators = reinterpret_cast<const T *>(m_address + io::alignment);
+                m_denominators = reinterpret_cast<const T *>(m_address + io::alignment + kernel::paddedBytes<T>(header.size));
+            } catch(...) {
+                unmap();
+                throw;
+            }
+        }
+
+        MappedRatioArray(const MappedRatioArray &) = delete;
+        MappedRatioArray& operator=(const MappedRatioArray &) = delete;
+
+        /// \brief move constructor, the view is transferred
+        MappedRatioArray(MappedRatioArray &&view) noexcept {
+            *this = std::move(view);
+        }
+
+        /// \brief move assignment, the view is transferred
+        MappedRatioArray& operator=(MappedRatioArray &&view) noexcept {
+            if(this != &view) {
+                unmap();
+                std::swap(m_address, view.m_address);
+                std::swap(m_bytes, view.m_bytes);
+                std::swap(m_size, view.m_size);
+                std::swap(m_numerators, view.m_numerators);
+                std::swap(m_denominators, view.m_denominators);
+            }
+            return *this;
+        }
+
+        /// \brief destructor, unmap the file
+        ~MappedRatioArray() {unmap();}
+
+        /// \brief get the number of ratios
+        /// @return the size
+        inline std::size_t size() const {return m_size;};
+
+        /// \brief check if the view is empty
+        /// @return true if empty
+        inline bool empty() const {return m_size == 0;};
+
+        /// \brief get the numerators buffer
+        /// @return pointer to the contiguous numerators, in the mapping
+        inline const T * numerators() const {return m_numerators;};
+
+        /// \brief get the denominators buffer
+        /// @return pointer to the contiguous denominators, in the mapping
+        inline const T * denominators() const {return m_denominators;};
+
+        /// \brief get a ratio
+        /// \param i : index of the ratio
+        /// @return a copy of the ratio (not normalized again)
+        inline Ratio<T> operator[](std::size_t i) const {
+            Ratio<T> rat;
+            rat.numerator() = m_numerators[i];
+            rat.denominator() = m_denominators[i];
+            return rat;
+        }
+
+        /// \brief copy the ratios to memory
+        /// @return an array holding the ratios
+        RatioArray<T> toArray() const {
+            RatioArray<T> array(m_size);
+            std::copy(m_numerators, m_numerators + m_size, array.numerators());
+            std::copy(m_denominators, m_denominators + m_size, array.denominators());
+            return array;
+        }
+
+    private :
+
+        const unsigned char *m_address = nullptr;
+        std::size_t m_bytes = 0;
+        std::size_t m_size = 0;
+        const T *m_numerators = nullptr;
+        const T *m_denominators = nullptr;
+
+        void unmap() {
+            if(m_address != nullptr) {
+                ::munmap(const_cast<unsigned char *>(m_address), m_bytes);
+                m_address = nullptr;
+                m_bytes = 0;
+                m_size = 0;
+                m_numerators = nullptr;
+                m_denominators = nullptr;
+            }
+        }
+    };
+
+#endif
+}
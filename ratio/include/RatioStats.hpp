@@ -0,0 +1,395 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "RatioPolicy.hpp"
+
+#pragma once
+
+
+/// \file RatioStats.hpp
+/// \brief instrumentation of the hot paths: gcd calls and the bit width of their operands,
+/// normalizations performed and skipped, continued fraction steps of the real conversions and
+/// overflow near-misses per operator.
+/// The counters are compiled in by defining RTO_INSTRUMENTATION to 1 before including Ratio.hpp
+/// (the same value in every translation unit); with the default 0 the hooks are empty and the
+/// callers do not even compute their arguments.
+/// Each thread counts in its own counters (no lock, no atomic read-modify-write); snapshot()
+/// sums the counters of every thread, including the threads that have already exited.
+
+#ifndef RTO_INSTRUMENTATION
+#define RTO_INSTRUMENTATION 0
+#endif
+
+/// an intermediate is a near-miss when it is less than RTO_NEAR_MISS_BITS bits away from overflowing T
+#ifndef RTO_NEAR_MISS_BITS
+#define RTO_NEAR_MISS_BITS 2
+#endif
+
+namespace rto {
+
+    namespace stats {
+
+        /// \brief true if the counters are compiled in
+        constexpr bool enabled = RTO_INSTRUMENTATION != 0;
+
+        /// \brief operators with their own overflow counters (a division counts as a division,
+        /// not as the product it is computed with)
+        enum class Operation : std::size_t {Add, Subtract, Multiply, Divide};
+
+        constexpr std::size_t operationCount = 4;
+
+        /// \brief histogram buckets : bit widths (gcd operands) and step counts (conversions)
+        /// from 0 to 128, larger values go to the last bucket
+        constexpr std::size_t bucketCount = 129;
+
+        using Histogram = std::array<std::uint64_t, bucketCount>;
+
+        /// \brief counters of one operator
+        struct OperationStats {
+            std::uint64_t operations = 0;   // results built by the operator
+            std::uint64_t nearMisses = 0;   // an intermediate within RTO_NEAR_MISS_BITS bits of the limit of T
+            std::uint64_t overflows = 0;    // an intermediate out of the range of T (seen by Widen and Saturate)
+        };
+
+        /// \class Snapshot
+        /// \brief values of the counters at a given time (plain integers, can be kept and compared)
+        struct Snapshot {
+            std::uint64_t gcdCalls = 0;
+            Histogram gcdBitWidths{};               // bit width of the largest operand
+            std::uint64_t normalizations = 0;       // irreducible() calls
+            std::uint64_t normalizationsSkipped = 0;// Deferred results left unreduced
+            std::uint64_t conversions = 0;          // reals converted by a continued fraction
+            std::uint64_t conversionsBounded = 0;   // stopped by the denominator bound, not by the precision
+            Histogram conversionSteps{};            // continued fraction steps per conversion
+            std::array<OperationStats, operationCount> operations{};
+
+            /// \brief add the counters of another snapshot
+            Snapshot& operator+=(const Snapshot &other) {
+                gcdCalls += other.gcdCalls;
+                normalizations += other.normalizations;
+                normalizationsSkipped += other.normalizationsSkipped;
+                conversions += other.conversions;
+                conversionsBounded += other.conversionsBounded;
+                for(std::size_t i=0; i<bucketCount; ++i) {
+                    gcdBitWidths[i] += other.gcdBitWidths[i];
+                    conversionSteps[i] += other.conversionSteps[i];
+                }
+                for(std::size_t i=0; i<operationCount; ++i) {
+                    operations[i].operations += other.operations[i].operations;
+                    operations[i].nearMisses += other.operations[i].nearMisses;
+                    operations[i].overflows += other.operations[i].overflows;
+                }
+                return *this;
+            }
+
+            /// \brief counters of an operator
+            inline const OperationStats& operator[](Operation operation) const {return operations[static_cast<std::size_t>(operation)];};
+
+            /// \brief human readable dump, one counter per line (empty histogram buckets are omitted)
+            /// @return the text
+            std::string toText() const {
+                std::ostringstream stream;
+                stream << "gcd calls: " << gcdCalls << "\n";
+                writeText(stream, "gcd operand bits", gcdBitWidths);
+                stream << "normalizations: " << normalizations << "\n";
+                stream << "normalizations skipped: " << normalizationsSkipped << "\n";
+                stream << "conversions: " << conversions << " (" << conversionsBounded << " bounded)\n";
+                writeText(stream, "conversion steps", conversionSteps);
+                for(std::size_t i=0; i<operationCount; ++i) {
+                    stream << "operator " << operationName(i) << ": " << operations[i].operations << " operations, "
+                           << operations[i].nearMisses << " near-misses, " << operations[i].overflows << " overflows\n";
+                }
+                return stream.str();
+            }
+
+            /// \brief JSON dump : histograms are objects {"bucket": count} without the empty buckets
+            /// @return the JSON document
+            std::string toJson() const {
+                std::ostringstream stream;
+                stream << "{\"gcd\":{\"calls\":" << gcdCalls << ",\"bitWidths\":";
+                writeJson(stream, gcdBitWidths);
+                stream << "},\"normalization\":{\"performed\":" << normalizations << ",\"skipped\":" << normalizationsSkipped << "}";
+                stream << ",\"conversion\":{\"calls\":" << conversions << ",\"bounded\":" << conversionsBounded << ",\"steps\":";
+                writeJson(stream, conversionSteps);
+                stream << "},\"operators\":{";
+                for(std::size_t i=0; i<operationCount; ++i) {
+                    stream << (i ? "," : "") << "\"" << operationName(i) << "\":{\"operations\":" << operations[i].operations
+                           << ",\"nearMisses\":" << operations[i].nearMisses << ",\"overflows\":" << operations[i].overflows << "}";
+                }
+                stream << "}}";
+                return stream.str();
+            }
+
+            /// \brief overload the operator << for Snapshot (text dump)
+            friend std::ostream& operator<<(std::ostream &stream, const Snapshot &snapshot) {
+                return stream << snapshot.toText();
+            }
+
+        private :
+
+            static const char* operationName(std::size_t i) {
+                static const char *names[operationCount] = {"add", "subtract", "multiply", "divide"};
+                return names[i];
+            }
+
+            static void writeText(std::ostream &stream, const char *name, const Histogram &histogram) {
+                for(std::size_t i=0; i<bucketCount; ++i) {
+                    if(histogram[i]) {stream << "  " << name << (i+1 == bucketCount ? " >= " : " = ") << i << ": " << histogram[i] << "\n";}
+                }
+            }
+
+            static void writeJson(std::ostream &stream, const Histogram &histogram) {
+                stream << "{";
+                bool first = true;
+                for(std::size_t i=0; i<bucketCount; ++i) {
+                    if(histogram[i]) {
+                        stream << (first ? "" : ",") << "\"" << i << "\":" << histogram[i];
+                        first = false;
+                    }
+                }
+                stream << "}";
+            }
+        };
+
+        namespace detail {
+
+            /// \brief counter written by a single thread and read by any: relaxed load and store,
+            /// so that an increment is two plain instructions and reading it is not a data race
+            class Counter {
+            public :
+                inline void add(std::uint64_t n = 1) {m_value.store(m_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);};
+                inline std::uint64_t value() const {return m_value.load(std::memory_order_relaxed);};
+                inline void clear() {m_value.store(0, std::memory_order_relaxed);};
+            private :
+                std::atomic<std::uint64_t> m_value{0};
+            };
+
+            /// \class ThreadRegistry
+            /// \brief per-thread counters : each thread writes its own Counters, registered on first use;
+            /// the Snapshot of a thread (Counters::load()) is added to the sum of the exited threads when it exits
+            template <typename Counters, typename Snapshot>
+            class ThreadRegistry {
+            public :
+
+                /// \brief counters of the calling thread
+                static Counters& local() {
+                    static thread_local Slot slot;
+                    return slot.counters;
+                }
+
+                /// \brief sum of the counters of every thread, running or exited
+                static Snapshot total() {
+                    ThreadRegistry &registry = instance();
+                    std::lock_guard<std::mutex> lock(registry.m_mutex);
+                    Snapshot sum = registry.m_exited;
+                    for(const Counters *counters : registry.m_threads) {sum += counters->load();}
+                    return sum;
+                }
+
+                /// \brief set the counters of every thread to 0
+                static void clear() {
+                    ThreadRegistry &registry = instance();
+                    std::lock_guard<std::mutex> lock(registry.m_mutex);
+                    registry.m_exited = Snapshot();
+                    for(Counters *counters : registry.m_threads) {counters->clear();}
+                }
+
+            private :
+
+                std::mutex m_mutex;
+                std::vector<Counters*> m_threads;
+                Snapshot m_exited;
+
+                /// \brief never destroyed : a thread_local Slot can be destroyed after the function-local
+                /// statics at exit (when the registry was created on another thread)
+                static ThreadRegistry& instance() {
+                    static ThreadRegistry *registry = new ThreadRegistry;
+                    return *registry;
+                }
+
+                struct Slot {
+                    Slot() {
+                        ThreadRegistry &registry = instance();
+                        std::lock_guard<std::mutex> lock(registry.m_mutex);
+                        registry.m_threads.push_back(&counters);
+                    }
+
+                    ~Slot() {
+                        ThreadRegistry &registry = instance();
+                        std::lock_guard<std::mutex> lock(registry.m_mutex);
+                        registry.m_exited += counters.load();
+                        for(std::size_t i=0; i<registry.m_threads.size(); ++i) {
+                            if(registry.m_threads[i] == &counters) {
+                                registry.m_threads[i] = registry.m_threads.back();
+                                registry.m_threads.pop_back();
+                                break;
+                            }
+                        }
+                    }
+
+                    Slot(const Slot &) = delete;
+                    Slot& operator=(const Slot &) = delete;
+
+                    Counters counters;
+                };
+            };
+
+            /// \brief counters of one thread
+            struct ThreadCounters {
+                Counter gcdCalls;
+                std::array<Counter, bucketCount> gcdBitWidths;
+                Counter normalizations;
+                Counter normalizationsSkipped;
+                Counter conversions;
+                Counter conversionsBounded;
+                std::array<Counter, bucketCount> conversionSteps;
+                std::array<std::array<Counter, 3>, operationCount> operations;
+
+                Snapshot load() const {
+                    Snapshot snapshot;
+                    snapshot.gcdCalls = gcdCalls.value();
+                    snapshot.normalizations = normalizations.value();
+                    snapshot.normalizationsSkipped = normalizationsSkipped.value();
+                    snapshot.conversions = conversions.value();
+                    snapshot.conversionsBounded = conversionsBounded.value();
+                    for(std::size_t i=0; i<bucketCount; ++i) {
+                        snapshot.gcdBitWidths[i] = gcdBitWidths[i].value();
+                        snapshot.conversionSteps[i] = conversionSteps[i].value();
+                    }
+                    for(std::size_t i=0; i<operationCount; ++i) {
+                        snapshot.operations[i].operations = operations[i][0].value();
+                        snapshot.operations[i].nearMisses = operations[i][1].value();
+                        snapshot.operations[i].overflows = operations[i][2].value();
+                    }
+                    return snapshot;
+                }
+
+                void clear() {
+                    gcdCalls.clear();
+                    normalizations.clear();
+                    normalizationsSkipped.clear();
+                    conversions.clear();
+                    conversionsBounded.clear();
+                    for(std::size_t i=0; i<bucketCount; ++i) {
+                        gcdBitWidths[i].clear();
+                        conversionSteps[i].clear();
+                    }
+                    for(std::array<Counter, 3> &operation : operations) {
+                        for(Counter &counter : operation) {counter.clear();}
+                    }
+                }
+            };
+
+            using Registry = ThreadRegistry<ThreadCounters, Snapshot>;
+
+            inline ThreadCounters& local() {
+                return Registry::local();
+            }
+
+            inline constexpr std::size_t bucket(int value) {
+                return value < 0 ? 0 : (static_cast<std::size_t>(value) < bucketCount ? static_cast<std::size_t>(value) : bucketCount - 1);
+            }
+        }
+
+        // hooks called by the library, empty unless RTO_INSTRUMENTATION is 1
+        // (and while the compiler evaluates a constant expression, see kernel::constantEvaluated)
+
+        /// \brief a gcd is computed
+        /// \param bitWidth : number of bits of the largest operand
+        inline constexpr void gcdCall(int bitWidth) {
+        #if RTO_INSTRUMENTATION
+            if(kernel::constantEvaluated()) {return;}
+            detail::ThreadCounters &counters = detail::local();
+            counters.gcdCalls.add();
+            counters.gcdBitWidths[detail::bucket(bitWidth)].add();
+        #else
+            (void)bitWidth;
+        #endif
+        }
+
+        /// \brief a ratio is reduced (performed) or an operator result is left as it is (skipped)
+        inline constexpr void normalization(bool performed) {
+        #if RTO_INSTRUMENTATION
+            if(kernel::constantEvaluated()) {return;}
+            if(performed) {
+                detail::local().normalizations.add();
+            } else {
+                detail::local().normalizationsSkipped.add();
+            }
+        #else
+            (void)performed;
+        #endif
+        }
+
+        /// \brief a real is converted by a continued fraction
+        /// \param steps : number of partial quotients computed
+        /// \param bounded : the expansion was stopped by the bound on the denominator
+        inline constexpr void conversion(int steps, bool bounded) {
+        #if RTO_INSTRUMENTATION
+            if(kernel::constantEvaluated()) {return;}
+            detail::ThreadCounters &counters = detail::local();
+            counters.conversions.add();
+            if(bounded) {counters.conversionsBounded.add();}
+            counters.conversionSteps[detail::bucket(steps)].add();
+        #else
+            (void)steps;
+            (void)bounded;
+        #endif
+        }
+
+        /// \brief an operator builds a result
+        /// \param operation : the operator
+        /// \param bitWidth : number of bits of the largest intermediate (numerator or denominator)
+        /// \param digits : number of value bits of the integer type of the ratio
+        inline constexpr void operation(Operation operation, int bitWidth, int digits) {
+        #if RTO_INSTRUMENTATION
+            if(kernel::constantEvaluated()) {return;}
+            std::array<detail::Counter, 3> &counters = detail::local().operations[static_cast<std::size_t>(operation)];
+            counters[0].add();
+            if(bitWidth > digits) {
+                counters[2].add();
+            } else if(bitWidth > digits - RTO_NEAR_MISS_BITS) {
+                counters[1].add();
+            }
+        #else
+            (void)operation;
+            (void)bitWidth;
+            (void)digits;
+        #endif
+        }
+
+        // snapshot API
+
+        /// \brief counters of the calling thread
+        /// @return the snapshot (all 0 when RTO_INSTRUMENTATION is 0)
+        inline Snapshot threadSnapshot() {
+            if constexpr (enabled) {return detail::local().load();}
+            return Snapshot();
+        }
+
+        /// \brief sum of the counters of every thread (the ones still running and the ones that have exited)
+        /// @return the snapshot (all 0 when RTO_INSTRUMENTATION is 0)
+        inline Snapshot snapshot() {
+            Snapshot total;
+            if constexpr (enabled) {
+                total = detail::Registry::total();
+            }
+            return total;
+        }
+
+        /// \brief set every counter of every thread to 0 (an increment running at the same time on
+        /// another thread may be lost or kept)
+        inline void reset() {
+            if constexpr (enabled) {
+                detail::Registry::clear();
+            }
+        }
+    }
+}